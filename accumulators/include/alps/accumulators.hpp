@@ -8,3 +8,4 @@
 
 #include <alps/accumulators/accumulator.hpp>
 #include <alps/accumulators/namedaccumulators.hpp>
+#include <alps/accumulators/static_accumulator_set.hpp>
@@ -68,6 +68,17 @@ namespace alps {
                 if (!ptr) throw std::runtime_error("Uninitialized accumulator accessed");
             }
 
+            /// Check if the data is valid (not a 0-sized vector): Generic.
+            template <typename T>
+            inline void check_nonempty_vector(const T&) {}
+
+            /// Check if the data is valid (not a 0-sized vector): vector specialization.
+            /** @note Throws on a failed check */
+            template <typename T>
+            inline void check_nonempty_vector(const std::vector<T>& vec) {
+                if (vec.empty()) throw std::runtime_error("Zero-sized vector observables are not allowed");
+            }
+
         } // detail::
 
         // TODO: merge with accumulator_wrapper, at least make common base ...
@@ -390,19 +401,6 @@ namespace alps {
         result_wrapper cbrt (result_wrapper const & arg);
 
         class accumulator_wrapper {
-            private:
-
-                /// Check if the data is valid (not a 0-sized vector): Generic.
-                template <typename T>
-                static void check_nonempty_vector(const T&) {}
-
-                /// Check if the data is valid (not a 0-sized vector): vector specialization.
-                /** @note Throws on a failed check */
-                template <typename T>
-                static void check_nonempty_vector(const std::vector<T>& vec) {
-                    if (vec.empty()) throw std::runtime_error("Zero-sized vector observables are not allowed");
-                }
-
             public:
             /// default constructor
             accumulator_wrapper();
@@ -443,7 +441,7 @@ namespace alps {
                 };
             public:
                 template<typename T> void operator()(T const & value) {
-                    check_nonempty_vector(value);
+                    detail::check_nonempty_vector(value);
                     boost::apply_visitor(call_1_visitor<T>(value), m_variant);
                 }
                 template<typename T> accumulator_wrapper & operator<<(T const & value) {
@@ -451,6 +449,36 @@ namespace alps {
                     return (*this);
                 }
 
+            // operator(T const *, std::size_t)
+            private:
+                template<typename T> struct call_n_visitor: public boost::static_visitor<> {
+                    call_n_visitor(T const * f, std::size_t s) : first(f), n(s) {}
+                    template<typename X> void apply(typename std::enable_if<
+                        std::is_same<T, typename value_type<X>::type>::value, X &
+                    >::type arg) const {
+                        arg(first, n);
+                    }
+                    template<typename X> void apply(typename std::enable_if<!
+                        std::is_same<T, typename value_type<X>::type>::value, X &
+                    >::type /*arg*/) const {
+                        throw std::logic_error(std::string("cannot add values of type: ") + typeid(T).name() + " to " + typeid(typename value_type<X>::type).name() + ALPS_STACKTRACE);
+                    }
+                    template<typename X> void operator()(X & arg) const {
+                        check_ptr(arg);
+                        apply<typename X::element_type>(*arg);
+                    }
+                    T const * first;
+                    std::size_t n;
+                };
+            public:
+                /// Adds `n` values starting at `first`, with the same result as adding them one by one
+                /** The value type `T` must be exactly the value type of the accumulator. */
+                template<typename T> void operator()(T const * first, std::size_t n) {
+                    for (std::size_t i = 0; i < n; ++i)
+                        detail::check_nonempty_vector(first[i]);
+                    boost::apply_visitor(call_n_visitor<T>(first, n), m_variant);
+                }
+
                 /// Merge another accumulator into this one. @param rhs_acc  accumulator to merge.
                 void merge(const accumulator_wrapper& rhs_acc);
 
@@ -466,6 +494,16 @@ namespace alps {
                 // count
                 boost::uint64_t count() const;
 
+                /// Largest relative error |error/mean| of the components of the accumulated value
+                /** A component with zero error counts as exact, one with zero mean and nonzero error
+                    as infinitely uncertain. Throws if the accumulator has no errors. */
+                double relative_error() const;
+
+                /// Whether the binning analysis of the error has converged for all components
+                /** See `converged_errors()` of the binning accumulators; `MAYBE_CONVERGED` counts as not
+                    converged. Accumulators without binning analysis have no such check and count as converged. */
+                bool error_converged() const;
+
             private:
                 // Visitors that need access to m_variant
                 struct merge_visitor;
@@ -500,6 +538,11 @@ namespace alps {
                     return *boost::apply_visitor(visitor, m_variant);
                 }
 
+                /// Returns a typed handle to the wrapped accumulator, or throws.
+                /** @tparam A named accumulator type (e.g., `FullBinningAccumulator<double>`)
+                    @see accumulator_handle */
+                template <typename A> accumulator_handle<A> handle();
+
             // mean, error
             #define ALPS_ACCUMULATOR_PROPERTY_PROXY(PROPERTY, TYPE)                                                 \
                 private:                                                                                            \
@@ -546,6 +589,9 @@ namespace alps {
 
 #ifdef ALPS_HAVE_MPI
             void collective_merge(alps::mpi::communicator const & comm, int root);
+
+            /// Adds the state to the buffer of a collective merge of many accumulators
+            void collective_merge(alps::alps_mpi::collective_merge_buffer & buffer);
 #endif
 
             private:
@@ -567,6 +613,83 @@ namespace alps {
 
         void reset(accumulator_wrapper & arg);
 
+        /// Typed handle to an accumulator, bypassing the name lookup and type dispatch of `accumulator_set`.
+        /** The handle points directly to the raw accumulator of the named accumulator type `A`,
+            so that adding a value is a plain (inlinable) call.
+
+            The handle shares the ownership of the accumulator: it remains safe to use if the
+            accumulator is removed from its set, but does not follow it if the set entry is
+            replaced (e.g., by `accumulator_set::load()`); obtain a new handle in that case.
+
+            Example:
+            @code
+                accumulator_set measurements;
+                measurements << FullBinningAccumulator<double>("Energy");
+                accumulator_handle< FullBinningAccumulator<double> > energy
+                    = measurements.handle< FullBinningAccumulator<double> >("Energy");
+                // ...
+                energy << x;
+            @endcode
+        */
+        template<typename A> class accumulator_handle {
+            public:
+                typedef typename A::accumulator_type accumulator_type;
+                typedef typename alps::accumulators::value_type<accumulator_type>::type value_type;
+                typedef typename detail::add_base_wrapper_pointer<value_type>::type pointer_type;
+
+                /// Constructs an invalid handle
+                accumulator_handle(): m_wrapper(), m_acc(0) {}
+
+                /// Constructs a handle to the accumulator wrapped in `wrapper`, or throws if it is not of type `A`
+                explicit accumulator_handle(pointer_type const & wrapper)
+                    : m_wrapper(wrapper), m_acc(0)
+                {
+                    detail::check_ptr(m_wrapper);
+                    try {
+                        m_acc = &m_wrapper->template extract<accumulator_type>();
+                    } catch (std::bad_cast const &) {
+                        throw std::runtime_error(std::string("Cannot cast observable to accumulator type: ")
+                                                 + typeid(accumulator_type).name() + ALPS_STACKTRACE);
+                    }
+                }
+
+                /// Adds the value directly to the accumulator
+                void operator()(value_type const & value) {
+                    detail::check_nonempty_vector(value);
+                    (*m_acc)(value);
+                }
+
+                /// Adds the value directly to the accumulator
+                accumulator_handle & operator<<(value_type const & value) {
+                    (*this)(value);
+                    return *this;
+                }
+
+                /// Adds `n` values starting at `first` directly to the accumulator
+                void operator()(value_type const * first, std::size_t n) {
+                    for (std::size_t i = 0; i < n; ++i)
+                        detail::check_nonempty_vector(first[i]);
+                    m_acc->operator()(first, n);
+                }
+
+                /// Returns true if the handle refers to an accumulator
+                bool valid() const { return m_acc != 0; }
+
+                /// Returns the raw accumulator this handle refers to
+                accumulator_type & accumulator() const { return *m_acc; }
+
+            private:
+                pointer_type m_wrapper;
+                accumulator_type * m_acc;
+        };
+
+        template <typename A> accumulator_handle<A> accumulator_wrapper::handle() {
+            typedef typename accumulator_handle<A>::value_type value_type;
+            get_visitor<value_type> visitor;
+            boost::apply_visitor(visitor, m_variant);
+            return accumulator_handle<A>(visitor.value);
+        }
+
         typedef impl::wrapper_set<accumulator_wrapper> accumulator_set;
         typedef impl::wrapper_set<result_wrapper> result_set;
 
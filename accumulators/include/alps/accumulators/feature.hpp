@@ -98,6 +98,10 @@ namespace alps {
                 ) const {
                     throw std::logic_error("A result cannot be merged " + ALPS_STACKTRACE);
                 }
+
+                inline void collective_merge(alps::alps_mpi::collective_merge_buffer & /*buffer*/) const {
+                    throw std::logic_error("A result cannot be merged " + ALPS_STACKTRACE);
+                }
 #endif
 
                 template<typename U> void operator+=(U const &) {}
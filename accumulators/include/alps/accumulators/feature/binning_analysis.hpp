@@ -76,6 +76,20 @@ namespace alps {
                 throw std::runtime_error(std::string(typeid(A).name()) + " has no autocorrelation-method" + ALPS_STACKTRACE);
                 return *static_cast<typename autocorrelation_type<A>::type *>(NULL);
             }
+
+            template<typename A> typename std::enable_if<
+                  has_feature<A, binning_analysis_tag>::value
+                , typename convergence_type<A>::type
+            >::type converged_errors_impl(A const & acc) {
+                return acc.converged_errors();
+            }
+
+            template<typename A> typename std::enable_if<
+                  !has_feature<A, binning_analysis_tag>::value
+                , typename convergence_type<A>::type
+            >::type converged_errors_impl(A const & /*acc*/) {
+                throw std::runtime_error(std::string(typeid(A).name()) + " has no converged_errors-method" + ALPS_STACKTRACE);
+            }
         }
 
         namespace impl {
@@ -96,8 +110,11 @@ namespace alps {
                         , m_ac_count()
                     {}
 
-                    // This method is broken and does not compile
-                    //typename alps::accumulators::convergence_type<B>::type converged_errors() const;
+                    /// Convergence of the error of each component, as `alps::error_convergence`
+                    /** The error is `CONVERGED` if the errors of the binning levels just below the top one have
+                        reached the error of the top level, i.e., the bins are longer than the autocorrelation
+                        time; `MAYBE_CONVERGED` with fewer than 4 reliable levels. */
+                    typename alps::accumulators::convergence_type<B>::type converged_errors() const;
 
                     typename alps::accumulators::error_type<B>::type const error(std::size_t bin_level = std::numeric_limits<std::size_t>::max()) const;
 
@@ -109,6 +126,8 @@ namespace alps {
 
                     using B::operator();
                     void operator()(T const & val);
+                    /// Adds `n` values starting at `first`, with the same result as adding them one by one
+                    void operator()(T const * first, std::size_t n);
 
                     template<typename S> void print(S & os, bool terse=false) const {
                         if (terse) {
@@ -165,6 +184,7 @@ namespace alps {
                           alps::mpi::communicator const & comm
                         , int root
                     ) const;
+                    void collective_merge(alps::alps_mpi::collective_merge_buffer & buffer);
 #endif
 
                 private:
@@ -200,6 +220,9 @@ namespace alps {
 
                     error_type const error(std::size_t bin_level = std::numeric_limits<std::size_t>::max()) const;
 
+                    /// Convergence of the error of each component, see `Accumulator::converged_errors()`
+                    typename alps::accumulators::convergence_type<B>::type converged_errors() const;
+
                     autocorrelation_type const autocorrelation() const {
                         return m_ac_autocorrelation;
                     }
@@ -333,6 +356,7 @@ namespace alps {
                 public:
                     virtual bool has_autocorrelation() const = 0;
                     virtual typename autocorrelation_type<B>::type autocorrelation() const = 0;
+                    virtual typename convergence_type<B>::type converged_errors() const = 0;
             };
 
             template<typename T, typename B> class DerivedWrapper<T, binning_analysis_tag, B> : public B {
@@ -343,6 +367,8 @@ namespace alps {
                     bool has_autocorrelation() const { return has_feature<T, binning_analysis_tag>::type::value; }
 
                     typename autocorrelation_type<B>::type autocorrelation() const { return detail::autocorrelation_impl(this->m_data); }
+
+                    typename convergence_type<B>::type converged_errors() const { return detail::converged_errors_impl(this->m_data); }
             };
 
         }
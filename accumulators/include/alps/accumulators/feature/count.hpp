@@ -78,6 +78,7 @@ namespace alps {
                     }
 
                     void operator()(T const &);
+                    void operator()(T const *, std::size_t);
 
                     template<typename W> void operator()(T const &, W) {
                         throw std::runtime_error("No values can be added to a result" + ALPS_STACKTRACE);
@@ -175,6 +176,10 @@ namespace alps {
                     void operator()(T const &) {
                         ++m_count;
                     }
+                    /// Adds `n` values at once
+                    void operator()(T const *, std::size_t n) {
+                        m_count += n;
+                    }
                     template<typename W> void operator()(T const &, W) {
                         throw std::runtime_error("Observable has no binary call operator" + ALPS_STACKTRACE);
                     }
@@ -209,6 +214,7 @@ namespace alps {
                           alps::mpi::communicator const & comm
                         , int root
                     ) const;
+                    void collective_merge(alps::alps_mpi::collective_merge_buffer & buffer);
 #endif
 
                 private:
@@ -87,6 +87,8 @@ namespace alps {
 
                     using B::operator();
                     void operator()(T const & val);
+                    /// Adds `n` values starting at `first`, with the same result as adding them one by one
+                    void operator()(T const * first, std::size_t n);
 
                     template<typename S> void print(S & os, bool terse=false) const {
                         B::print(os, terse);
@@ -124,6 +126,7 @@ namespace alps {
                           alps::mpi::communicator const & comm
                         , int root
                     ) const;
+                    void collective_merge(alps::alps_mpi::collective_merge_buffer & buffer);
 #endif
 
                 private:
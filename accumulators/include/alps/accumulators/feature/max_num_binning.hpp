@@ -28,6 +28,7 @@
 #include <boost/utility.hpp>
 #include <boost/function.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 #include <type_traits>
 
@@ -174,6 +175,8 @@ namespace alps {
 
                 using B::operator();
                 void operator()(T const & val);
+                /// Adds `n` values starting at `first`, with the same result as adding them one by one
+                void operator()(T const * first, std::size_t n);
 
                 template<typename S> void print(S & os, bool terse=false) const {
                     if (terse) {
@@ -203,15 +206,36 @@ namespace alps {
                 void reset();
 
                 /// Merge the bins of the given accumulator of type A into this accumulator @param rhs Accumulator to merge
-                    /** @warning: FIXME: Incomplete, therefore always throws. */
+                /** The bins of both accumulators are rebinned to the same size and then combined into at
+                    most `max_number()` bins, as in `collective_merge()`. The partial bin of `rhs` is dropped
+                    from the timeseries (it still enters the mean and the binning analysis). */
                 template <typename A>
                 void merge(const A& rhs)
                 {
-                        throw std::logic_error("Merging of FullBinningAccumulators is not yet implemented.\n"
-                                               "Please contact ALPSCore developers and provide the code\n"
-                                               "where you are using the merge() method.");
                     B::merge(rhs);
-                    // FIXME!!! Needs a test to proceed with the coding!
+                    if (rhs.m_mn_bins.empty())
+                        return;
+                    if (m_mn_bins.empty()) {
+                        m_mn_elements_in_bin = rhs.m_mn_elements_in_bin;
+                        m_mn_bins = rhs.m_mn_bins;
+                        return;
+                    }
+
+                    typename B::count_type elements_in_bin = std::max(m_mn_elements_in_bin, rhs.m_mn_elements_in_bin);
+                    std::vector<typename mean_type<B>::type> lhs_bins(m_mn_bins), rhs_bins(rhs.m_mn_bins), merged_bins;
+                    rebin_local(lhs_bins, elements_in_bin);
+                    rhs.rebin_local(rhs_bins, elements_in_bin);
+
+                    std::vector<std::size_t> index(2);
+                    index[0] = lhs_bins.size();
+                    index[1] = rhs_bins.size();
+                    spread_bins(lhs_bins, index, 0, merged_bins);
+                    spread_bins(rhs_bins, index, 1, merged_bins);
+
+                    std::size_t total_bins = index[0] + index[1];
+                    std::size_t perbin = total_bins < m_mn_max_number ? 1 : total_bins / m_mn_max_number;
+                    m_mn_bins.swap(merged_bins);
+                    m_mn_elements_in_bin = elements_in_bin * perbin;
                 }
 
 #ifdef ALPS_HAVE_MPI
@@ -221,6 +245,8 @@ namespace alps {
                 void collective_merge(alps::mpi::communicator const & comm,
                                       int root) const;
 
+                void collective_merge(alps::alps_mpi::collective_merge_buffer & buffer);
+
               private:
                 void partition_bins(alps::mpi::communicator const & comm,
                                     std::vector<typename mean_type<B>::type> & local_bins,
@@ -229,11 +255,25 @@ namespace alps {
 #endif
 
               private:
+                /// Rebins the local bins to (at least) `elements_in_bin` elements per bin
+                void rebin_local(std::vector<typename mean_type<B>::type> & local_bins,
+                                 typename B::count_type elements_in_bin) const;
+
+                /// Distributes the local bins of `rank` into the merged bins; `index` holds the number of bins of each rank
+                void spread_bins(std::vector<typename mean_type<B>::type> const & local_bins,
+                                 std::vector<std::size_t> const & index,
+                                 int rank,
+                                 std::vector<typename mean_type<B>::type> & merged_bins) const;
+
+                /// Adds the value to the timeseries bins, rebinning if needed
+                void add_to_bins(T const & val);
 
                 std::size_t m_mn_max_number;
                 typename B::count_type m_mn_elements_in_bin, m_mn_elements_in_partial;
                 T m_mn_partial;
                 std::vector<typename mean_type<B>::type> m_mn_bins;
+                /// Storage of bins dropped by rebinning, reused for new bins; not part of the state
+                std::vector<typename mean_type<B>::type> m_mn_spare_bins;
             };
 
 
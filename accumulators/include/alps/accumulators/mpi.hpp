@@ -12,12 +12,124 @@
 
     #include <alps/utilities/boost_mpi.hpp>
 
+    #include <boost/cstdint.hpp>
+
+    #include <string>
+    #include <tuple>
+    #include <vector>
+    #include <type_traits>
+
     namespace alps {
         namespace alps_mpi {
 
             template<typename T, typename Op> void reduce(const alps::mpi::communicator & comm, T const & in_values, Op op, int root);
             template<typename T, typename Op> void reduce(const alps::mpi::communicator & comm, T const & in_values, T & out_values, Op op, int root);
 
+            namespace detail {
+                /// Position of the buffer for scalar type S in `collective_merge_buffer`
+                template<typename S> struct merge_buffer_index;
+                template<> struct merge_buffer_index<boost::uint64_t> : public std::integral_constant<std::size_t, 0> {};
+                template<> struct merge_buffer_index<float> : public std::integral_constant<std::size_t, 1> {};
+                template<> struct merge_buffer_index<double> : public std::integral_constant<std::size_t, 2> {};
+                template<> struct merge_buffer_index<long double> : public std::integral_constant<std::size_t, 3> {};
+            }
+
+            /// Buffers to merge the state of many accumulators with a fixed number of collective operations.
+            /** Instead of each accumulator reducing each piece of its state on its own, the state of all
+                accumulators is packed into one buffer per scalar type, which is reduced in a single call.
+
+                The accumulators are walked once per phase. On every walk, each accumulator must make
+                the same calls, in the same order:
+                 - `shape`: the sizes the packed state depends on are announced with `maximum()` and `same()`;
+                 - `gather`: values needed from every rank are announced with `all()`;
+                 - `pack`: the summable state is appended with `sum()`;
+                 - `unpack` (root only): the same `sum()` calls read the sums back.
+
+                `next_phase()` exchanges the values announced in the finished phase, with one collective
+                operation per non-empty buffer; from then on, the calls return the exchanged values.
+                The calls of the `shape` phase must not depend on the state of the accumulators;
+                later calls may depend on the values returned by `maximum()` and `same()`.
+
+                Example:
+                @code
+                    collective_merge_buffer buffer;
+                    do {
+                        for (...) acc.collective_merge(buffer);
+                    } while (buffer.next_phase(comm, root));
+                @endcode
+            */
+            class collective_merge_buffer {
+                public:
+                    enum phase_type { shape, gather, pack, unpack, done };
+
+                    collective_merge_buffer();
+
+                    /// Current phase
+                    phase_type phase() const { return m_phase; }
+
+                    /// Rank of this process (valid from the `gather` phase on)
+                    int rank() const { return m_rank; }
+
+                    /// Maximum of `value` over all ranks; the local value during the `shape` phase
+                    boost::uint64_t maximum(boost::uint64_t value);
+
+                    /// Returns `value`; from the `gather` phase on, throws on all ranks if it differs between ranks
+                    boost::uint64_t same(boost::uint64_t value, std::string const & what);
+
+                    /// Values of `value` on all ranks, in rank order; empty before the `pack` phase
+                    std::vector<boost::uint64_t> all(boost::uint64_t value);
+
+                    /// Appends `value` to the buffer (`pack`), or replaces it by the sum over all ranks (`unpack`)
+                    template<typename S>
+                    typename std::enable_if<std::is_scalar<S>::value>::type sum(S & value) {
+                        sum_buffer<S> & buffer = std::get<detail::merge_buffer_index<S>::value>(m_sums);
+                        if (m_phase == pack)
+                            buffer.data.push_back(value);
+                        else if (m_phase == unpack)
+                            value = buffer.data[buffer.position++];
+                    }
+
+                    /// Appends all elements of `values` to the buffer (`pack`), or replaces them by their sums (`unpack`)
+                    template<typename X> void sum(std::vector<X> & values) {
+                        for (typename std::vector<X>::iterator it = values.begin(); it != values.end(); ++it)
+                            sum(*it);
+                    }
+
+                    /// Number of scalars in `value`
+                    template<typename S>
+                    static typename std::enable_if<std::is_scalar<S>::value, std::size_t>::type size(S const &) {
+                        return 1;
+                    }
+
+                    /// Number of scalars in `values`
+                    template<typename X> static std::size_t size(std::vector<X> const & values) {
+                        std::size_t n = 0;
+                        for (typename std::vector<X>::const_iterator it = values.begin(); it != values.end(); ++it)
+                            n += size(*it);
+                        return n;
+                    }
+
+                    /// Exchanges the values of the finished phase and starts the next one; returns false when done
+                    bool next_phase(alps::mpi::communicator const & comm, int root);
+
+                private:
+                    template<typename S> struct sum_buffer {
+                        sum_buffer(): position(0) {}
+                        std::vector<S> data;
+                        std::size_t position;
+                    };
+
+                    template<typename S> void reduce(alps::mpi::communicator const & comm, int root, sum_buffer<S> & buffer);
+
+                    phase_type m_phase;
+                    int m_rank, m_size;
+                    std::vector<boost::uint64_t> m_maximum;
+                    std::size_t m_maximum_position;
+                    std::vector<boost::uint64_t> m_all;
+                    std::size_t m_all_count, m_all_position;
+                    std::tuple<sum_buffer<boost::uint64_t>, sum_buffer<float>, sum_buffer<double>, sum_buffer<long double> > m_sums;
+            };
+
         } // alps_mpi::
     } // alps::
 
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#pragma once
+
+#include <alps/config.hpp>
+#include <alps/accumulators/accumulator.hpp>
+#include <alps/accumulators/namedaccumulators.hpp>
+#include <alps/accumulators/mpi.hpp>
+#include <alps/hdf5/archive.hpp>
+#include <alps/utilities/stacktrace.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+#include <array>
+#include <string>
+#include <tuple>
+#include <stdexcept>
+#include <type_traits>
+
+namespace alps {
+    namespace accumulators {
+
+        /// Set of accumulators whose types are fixed at compile time.
+        /** The set holds the raw accumulators of the named accumulator types `As...` in a
+            `std::tuple`. Accumulators are addressed by their position, so that adding values,
+            merging, saving and collective merging go without the name lookup, the
+            `boost::variant` dispatch and the virtual calls of `accumulator_set`.
+
+            The set is saved in the same layout as an `accumulator_set`, and can be exported
+            to a `result_set` for the analysis.
+
+            Example:
+            @code
+                static_accumulator_set< FullBinningAccumulator<double>, MeanAccumulator< std::vector<double> > >
+                    measurements(FullBinningAccumulator<double>("Energy"),
+                                 MeanAccumulator< std::vector<double> >("Greens"));
+                // ...
+                measurements.push<0>(energy);
+                measurements.push<1>(greens);
+                // ...
+                result_set results = measurements.results();
+            @endcode
+        */
+        template<typename... As> class static_accumulator_set {
+            public:
+                typedef std::tuple<typename As::accumulator_type...> storage_type;
+
+                /// Raw accumulator type at position `I`
+                template<std::size_t I> struct accumulator_type {
+                    typedef typename std::tuple_element<I, storage_type>::type type;
+                };
+
+                /// Value type of the accumulator at position `I`
+                template<std::size_t I> struct value_type {
+                    typedef typename alps::accumulators::value_type<typename accumulator_type<I>::type>::type type;
+                };
+
+                /// Constructs the set from named accumulators, copying their name and (empty) state
+                explicit static_accumulator_set(As const &... accs)
+                    : m_names{{accs.name...}}
+                    , m_accumulators(accs.wrapper->template extract<typename As::accumulator_type>()...)
+                {
+                    for (std::size_t i = 0; i < m_names.size(); ++i)
+                        for (std::size_t j = 0; j < i; ++j)
+                            if (m_names[i] == m_names[j])
+                                throw std::out_of_range("There already exists an accumulator with the name: " + m_names[i] + ALPS_STACKTRACE);
+                }
+
+                /// Number of accumulators in the set
+                static std::size_t size() { return sizeof...(As); }
+
+                /// Name of the accumulator at position `i`
+                std::string const & name(std::size_t i) const { return m_names[i]; }
+
+                /// Returns the raw accumulator at position `I`
+                template<std::size_t I> typename accumulator_type<I>::type & get() {
+                    return std::get<I>(m_accumulators);
+                }
+
+                /// Returns the raw accumulator at position `I`
+                template<std::size_t I> typename accumulator_type<I>::type const & get() const {
+                    return std::get<I>(m_accumulators);
+                }
+
+                /// Adds the value to the accumulator at position `I`
+                template<std::size_t I> void push(typename value_type<I>::type const & value) {
+                    detail::check_nonempty_vector(value);
+                    std::get<I>(m_accumulators)(value);
+                }
+
+                /// Adds `n` values starting at `first` to the accumulator at position `I`
+                template<std::size_t I> void push(typename value_type<I>::type const * first, std::size_t n) {
+                    for (std::size_t i = 0; i < n; ++i)
+                        detail::check_nonempty_vector(first[i]);
+                    std::get<I>(m_accumulators)(first, n);
+                }
+
+                /// Merges the accumulators of `rhs` into the accumulators of this set
+                void merge(static_accumulator_set const & rhs) {
+                    merge_impl(rhs, index<0>());
+                }
+
+                /// Resets all accumulators
+                void reset() {
+                    reset_impl(index<0>());
+                }
+
+                /// Saves the non-empty accumulators, in the same layout as `accumulator_set::save()`
+                void save(hdf5::archive & ar) const {
+                    ar.create_group("");
+                    save_impl(ar, index<0>());
+                }
+
+                /// Loads the accumulators present in the archive; the others are reset
+                void load(hdf5::archive & ar) {
+                    load_impl(ar, index<0>());
+                }
+
+                /// Returns the results of all accumulators as a `result_set`
+                result_set results() const {
+                    result_set res;
+                    results_impl(res, index<0>());
+                    return res;
+                }
+
+#ifdef ALPS_HAVE_MPI
+                /// Collective MPI merge of all accumulators into those of the `root` process, with a fixed number of collective operations
+                /** As with `accumulator_set::collective_merge()`, the accumulators of the other processes are reset. */
+                void collective_merge(alps::mpi::communicator const & comm, int root) {
+                    alps::alps_mpi::collective_merge_buffer buffer;
+                    do {
+                        collective_merge_impl(buffer, index<0>());
+                    } while (buffer.next_phase(comm, root));
+                    if (comm.rank() != root)
+                        reset();
+                }
+#endif
+
+            private:
+                template<std::size_t I> struct index : public std::integral_constant<std::size_t, I> {};
+                typedef index<sizeof...(As)> end_index;
+
+                template<std::size_t I> void merge_impl(static_accumulator_set const & rhs, index<I>) {
+                    std::get<I>(m_accumulators).merge(std::get<I>(rhs.m_accumulators));
+                    merge_impl(rhs, index<I + 1>());
+                }
+                void merge_impl(static_accumulator_set const &, end_index) {}
+
+                template<std::size_t I> void reset_impl(index<I>) {
+                    std::get<I>(m_accumulators).reset();
+                    reset_impl(index<I + 1>());
+                }
+                void reset_impl(end_index) {}
+
+                template<std::size_t I> void save_impl(hdf5::archive & ar, index<I>) const {
+                    if (std::get<I>(m_accumulators).count() != 0)
+                        ar[m_names[I]] = std::get<I>(m_accumulators);
+                    save_impl(ar, index<I + 1>());
+                }
+                void save_impl(hdf5::archive &, end_index) const {}
+
+                template<std::size_t I> void load_impl(hdf5::archive & ar, index<I>) {
+                    std::get<I>(m_accumulators).reset();
+                    if (ar.is_group(m_names[I]))
+                        ar[m_names[I]] >> std::get<I>(m_accumulators);
+                    load_impl(ar, index<I + 1>());
+                }
+                void load_impl(hdf5::archive &, end_index) {}
+
+                template<std::size_t I> void results_impl(result_set & res, index<I>) const {
+                    typedef typename accumulator_type<I>::type::result_type result_type;
+                    res.insert(m_names[I], boost::shared_ptr<result_wrapper>(new result_wrapper(result_type(std::get<I>(m_accumulators)))));
+                    results_impl(res, index<I + 1>());
+                }
+                void results_impl(result_set &, end_index) const {}
+
+#ifdef ALPS_HAVE_MPI
+                template<std::size_t I> void collective_merge_impl(alps::alps_mpi::collective_merge_buffer & buffer, index<I>) {
+                    std::get<I>(m_accumulators).collective_merge(buffer);
+                    collective_merge_impl(buffer, index<I + 1>());
+                }
+                void collective_merge_impl(alps::alps_mpi::collective_merge_buffer &, end_index) {}
+#endif
+
+                std::array<std::string, sizeof...(As)> m_names;
+                storage_type m_accumulators;
+        };
+
+    }
+}
@@ -8,6 +8,8 @@
 
 #include <alps/config.hpp>
 #include <alps/hdf5/archive.hpp>
+#include <alps/accumulators/mpi.hpp>
+#include <alps/utilities/stacktrace.hpp>
 
 #include <boost/shared_ptr.hpp>
 #include <mutex>
@@ -17,6 +19,7 @@ namespace alps {
 
         class accumulator_wrapper;
         class result_wrapper;
+        template<typename A> class accumulator_handle;
 
         namespace detail {
             template<typename T> struct serializable_type;
@@ -86,6 +89,19 @@ namespace alps {
                         }
                     }
 
+                    /// Returns a typed handle to the named accumulator, for fast repeated measurements.
+                    /** @tparam A named accumulator type (e.g., `FullBinningAccumulator<double>`)
+                        @note Throws if there is no accumulator `name` or if it is not of type `A`.
+                    */
+                    template<typename A, typename U = T>
+                    typename std::enable_if<std::is_same<U, accumulator_wrapper>::value, accumulator_handle<A> >::type
+                    handle(std::string const & name) {
+                        iterator it = m_storage.find(name);
+                        if (it == end())
+                            throw std::out_of_range("No observable found with the name: " + name + ALPS_STACKTRACE);
+                        return it->second->template handle<A>();
+                    }
+
                     template<typename U = T>
                     typename std::enable_if<std::is_same<U, accumulator_wrapper>::value>::type
                     reset() {
@@ -93,6 +109,27 @@ namespace alps {
                             it->second->reset();
                     }
 
+#ifdef ALPS_HAVE_MPI
+                    /// Collective MPI merge of all accumulators into the accumulators of the `root` process.
+                    /** The state of all accumulators is reduced with a fixed number of collective operations,
+                        independent of the number of accumulators (see `alps::alps_mpi::collective_merge_buffer`).
+                        All processes must hold accumulators of the same names and types. As with
+                        `accumulator_wrapper::collective_merge()`, the accumulators of the other processes are reset.
+                    */
+                    template<typename U = T>
+                    typename std::enable_if<std::is_same<U, accumulator_wrapper>::value>::type
+                    collective_merge(alps::mpi::communicator const & comm, int root) {
+                        alps::alps_mpi::collective_merge_buffer buffer;
+                        do {
+                            buffer.same(size(), "number of accumulators");
+                            for (iterator it = begin(); it != end(); ++it)
+                                it->second->collective_merge(buffer);
+                        } while (buffer.next_phase(comm, root));
+                        if (comm.rank() != root)
+                            reset();
+                    }
+#endif
+
                 private:
                     std::map<std::string, boost::shared_ptr<T> > m_storage;
                     static std::vector<boost::shared_ptr<detail::serializable_type<T> > > m_types;
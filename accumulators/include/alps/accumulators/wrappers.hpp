@@ -51,6 +51,8 @@ namespace alps {
                 virtual ~base_wrapper() {}
 
                 virtual void operator()(value_type const & value) = 0;
+                /// Adds `n` values starting at `first`
+                virtual void operator()(value_type const * first, std::size_t n) = 0;
                 // virtual void operator()(value_type const & value, detail::weight_variant_type const & weight) = 0;
 
                 virtual void save(hdf5::archive & ar) const = 0;
@@ -63,6 +65,7 @@ namespace alps {
                 virtual void merge(const base_wrapper<T>&) = 0;
 #ifdef ALPS_HAVE_MPI
                 virtual void collective_merge(alps::mpi::communicator const & comm, int root) = 0;
+                virtual void collective_merge(alps::alps_mpi::collective_merge_buffer & buffer) = 0;
 #endif
 
                 virtual base_wrapper * clone() const = 0;
@@ -189,6 +192,10 @@ namespace alps {
                     this->m_data(value);
                 }
 
+                void operator()(value_type const * first, std::size_t n) {
+                    this->m_data(first, n);
+                }
+
             public:
                 void save(hdf5::archive & ar) const {
                     ar[""] = this->m_data;
@@ -225,6 +232,10 @@ namespace alps {
                 ) const {
                     this->m_data.collective_merge(comm, root);
                 }
+
+                void collective_merge(alps::alps_mpi::collective_merge_buffer & buffer) {
+                    this->m_data.collective_merge(buffer);
+                }
 #endif
         };
 
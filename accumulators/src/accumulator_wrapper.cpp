@@ -5,6 +5,10 @@
  */
 
 #include <alps/accumulators/accumulator.hpp>
+#include <alps/accumulators/convergence.hpp>
+
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 
 namespace alps {
@@ -114,6 +118,73 @@ namespace alps {
             return boost::apply_visitor(visitor, m_variant);
         }
 
+        //
+        // relative_error
+        //
+
+        namespace {
+            template<typename T>
+            typename std::enable_if<std::is_arithmetic<T>::value, double>::type
+            max_relative_error(T const & mean, T const & error) {
+                using std::abs;
+                if (error == 0)
+                    return 0.;
+                return abs(double(error) / double(mean));
+            }
+
+            template<typename T>
+            typename std::enable_if<!std::is_arithmetic<T>::value, double>::type
+            max_relative_error(T const & /*mean*/, T const & /*error*/) {
+                throw std::runtime_error(std::string("No relative error for the type ") + typeid(T).name() + ALPS_STACKTRACE);
+            }
+
+            template<typename T>
+            double max_relative_error(std::vector<T> const & mean, std::vector<T> const & error) {
+                if (mean.size() != error.size())
+                    throw std::runtime_error("Mean and error differ in size" + ALPS_STACKTRACE);
+                double result = 0.;
+                for (std::size_t i = 0; i < mean.size(); ++i)
+                    result = std::max(result, max_relative_error(mean[i], error[i]));
+                return result;
+            }
+        }
+
+        struct relative_error_visitor: public boost::static_visitor<double> {
+            template<typename T> double operator()(T const & arg) const {
+                detail::check_ptr(arg);
+                return max_relative_error(arg->mean(), arg->error());
+            }
+        };
+        double accumulator_wrapper::relative_error() const {
+            relative_error_visitor visitor;
+            return boost::apply_visitor(visitor, m_variant);
+        }
+
+        //
+        // error_converged
+        //
+
+        namespace {
+            bool all_converged(int conv) {
+                return conv == CONVERGED;
+            }
+
+            bool all_converged(std::vector<int> const & conv) {
+                return std::find_if(conv.begin(), conv.end(), [](int c) { return c != CONVERGED; }) == conv.end();
+            }
+        }
+
+        struct error_converged_visitor: public boost::static_visitor<bool> {
+            template<typename T> bool operator()(T const & arg) const {
+                detail::check_ptr(arg);
+                return !arg->has_autocorrelation() || all_converged(arg->converged_errors());
+            }
+        };
+        bool accumulator_wrapper::error_converged() const {
+            error_converged_visitor visitor;
+            return boost::apply_visitor(visitor, m_variant);
+        }
+
         //
         // save
         //
@@ -211,6 +282,16 @@ namespace alps {
             boost::apply_visitor(collective_merge_visitor(comm, root), m_variant);
             if (comm.rank()!=root) this->reset();
         }
+
+        struct collective_merge_buffer_visitor: public boost::static_visitor<> {
+            collective_merge_buffer_visitor(alps::alps_mpi::collective_merge_buffer & b): buffer(b) {}
+            template<typename T> void operator()(T & arg) const { arg->collective_merge(buffer); }
+            alps::alps_mpi::collective_merge_buffer & buffer;
+        };
+
+        void accumulator_wrapper::collective_merge(alps::alps_mpi::collective_merge_buffer & buffer) {
+            boost::apply_visitor(collective_merge_buffer_visitor(buffer), m_variant);
+        }
 #endif
 
         //
@@ -6,7 +6,9 @@
 
 #include <alps/accumulators/feature/error.hpp>
 #include <alps/accumulators/feature/binning_analysis.hpp>
+#include <alps/accumulators/convergence.hpp>
 #include <alps/hdf5/vector.hpp>
+#include <alps/numeric/inplace_functions.hpp>
 
 
 #include <boost/preprocessor/tuple/to_seq.hpp>
@@ -41,6 +43,50 @@ namespace boost {
 
 namespace alps {
     namespace accumulators {
+        namespace detail {
+            // Updates the convergence of a component from the error of a lower binning level and of the top level
+            template<typename E> void update_convergence(int & conv, E const & level_error, E const & error) {
+                using std::abs;
+                if (abs(level_error) >= abs(error))
+                    conv = CONVERGED;
+                else if (abs(level_error) < 0.824 * abs(error))
+                    conv = NOT_CONVERGED;
+                else if (abs(level_error) < 0.9 * abs(error) && conv != NOT_CONVERGED)
+                    conv = MAYBE_CONVERGED;
+            }
+
+            template<typename E> void update_convergence(std::vector<int> & conv, std::vector<E> const & level_error, std::vector<E> const & error) {
+                if (level_error.size() != error.size())
+                    throw std::runtime_error("Errors of the binning levels differ in size" + ALPS_STACKTRACE);
+                for (std::size_t i = 0; i < error.size(); ++i)
+                    update_convergence(conv[i], level_error[i], error[i]);
+            }
+
+            template<typename E> void set_convergence(int & conv, E const & /*error*/, int value) {
+                conv = value;
+            }
+
+            template<typename E> void set_convergence(std::vector<int> & conv, std::vector<E> const & error, int value) {
+                conv.assign(error.size(), value);
+            }
+
+            // Convergence of the error of the accumulator or result `arg` with `depth` binning levels: the
+            // errors of the levels just below the top level must have reached the plateau of the top level.
+            template<typename C, typename A> C binning_convergence(A const & arg, std::size_t depth) {
+                const std::size_t range = 4;
+                C conv;
+                const auto error = arg.error();
+                if (depth < range)
+                    set_convergence(conv, error, MAYBE_CONVERGED);
+                else {
+                    set_convergence(conv, error, CONVERGED);
+                    for (std::size_t i = depth - range; i < depth - 1; ++i)
+                        update_convergence(conv, arg.error(i), error);
+                }
+                return conv;
+            }
+        }
+
         namespace impl {
 
             //
@@ -65,37 +111,10 @@ namespace alps {
                 , m_ac_count(arg.m_ac_count)
             {}
 
-            // This method is broken and does not compile
-            // Apparently, it has never been instantiated before...
-            /*
             template<typename T, typename B>
             typename alps::accumulators::convergence_type<B>::type Accumulator<T, binning_analysis_tag, B>::converged_errors() const {
-                typedef typename alps::numeric::scalar<typename convergence_type<T>::type>::type convergence_scalar_type;
-
-                typename alps::accumulators::convergence_type<B>::type conv;
-                typename alps::accumulators::error_type<B>::type err = error();
-                check_size(conv, err);
-                const unsigned int range = 4;
-                const unsigned int depth = (m_ac_sum2.size() < 8 ? 1 : m_ac_sum2.size() - 7);
-                if (depth < range)
-                    conv = 0 * conv + (convergence_scalar_type)MAYBE_CONVERGED;
-                else {
-                    conv = 0 * conv + (convergence_scalar_type)CONVERGED;
-                    // TODO: how to we iterate over the datatype?
-                    for (unsigned int i = depth - range; i < depth - 1; ++i) {
-                        typename slice_index<typename alps::accumulators::convergence_type<B>::type>::type it;
-                        result_type this_err(error(i));
-                        for (it = slices(conv).first; it != slices(conv).second; ++it)
-                            if (std::abs(slice_value(this_err, it)) >= std::abs(slice_value(err,it)))
-                                slice_value(conv,it) = CONVERGED;
-                            else if (std::abs(slice_value(this_err, it)) < 0.824 * std::abs(slice_value(err,it)))
-                                slice_value(conv,it) = NOT_CONVERGED;
-                            else if (std::abs(slice_value(this_err, it)) < 0.9 * std::abs(slice_value(err,it)) && slice_value(conv, it) != NOT_CONVERGED)
-                                slice_value(conv,it) = MAYBE_CONVERGED;
-                    }
-                }
-                return conv;
-            }*/
+                return detail::binning_convergence<typename convergence_type<B>::type>(*this, binning_depth());
+            }
 
             template<typename T, typename B>
             typename alps::accumulators::error_type<B>::type const
@@ -181,8 +200,9 @@ namespace alps {
             template<typename T, typename B>
             void Accumulator<T, binning_analysis_tag, B>::operator()(T const & val) {
                 using alps::numeric::operator+=;
-                using alps::numeric::operator*;
                 using alps::numeric::check_size;
+                using alps::numeric::add_square;
+                using alps::numeric::set_zero;
 
                 B::operator()(val);
                 if(B::count() == (1UL << m_ac_sum2.size())) {
@@ -202,12 +222,54 @@ namespace alps {
 
                     // in other words: (B::count() % (1L << i) == 0)
                     if (!(B::count() & ((1ll << i) - 1))) {
-                        m_ac_sum2[i] += m_ac_partial[i] * m_ac_partial[i];
+                        add_square(m_ac_sum2[i], m_ac_partial[i]);
                         m_ac_sum[i] += m_ac_partial[i];
                         m_ac_count[i]++;
-                        m_ac_partial[i] = T();
-                        check_size(m_ac_partial[i], val);
+                        set_zero(m_ac_partial[i]);
+                    }
+                }
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, binning_analysis_tag, B>::operator()(T const * first, std::size_t n) {
+                using alps::numeric::operator+=;
+                using alps::numeric::add_square;
+                using alps::numeric::set_zero;
+
+                typedef typename count_type<B>::type count_type;
+
+                T const * const last = first + n;
+                while (first != last) {
+                    // A new binning level is opened when the count reaches 2^(number of levels);
+                    // that value goes through the one-by-one path. All values before it only
+                    // update the existing levels, which are independent of each other and are
+                    // therefore updated one level at a time over the whole block.
+                    const count_type count = B::count();
+                    const count_type new_level_count = count_type(1) << m_ac_sum2.size();
+                    if (count + 1 == new_level_count) {
+                        (*this)(*first++);
+                        continue;
                     }
+                    std::size_t block = last - first;
+                    if (count + 1 < new_level_count)
+                        block = std::min<std::size_t>(block, new_level_count - 1 - count);
+
+                    B::operator()(first, block);
+                    for (unsigned i = 0; i < m_ac_sum2.size(); ++i) {
+                        const count_type mask = (count_type(1) << i) - 1;
+                        for (std::size_t j = 0; j < block; ++j) {
+                            m_ac_partial[i] += first[j];
+
+                            // in other words: ((count + j + 1) % (1L << i) == 0)
+                            if (!((count + j + 1) & mask)) {
+                                add_square(m_ac_sum2[i], m_ac_partial[i]);
+                                m_ac_sum[i] += m_ac_partial[i];
+                                m_ac_count[i]++;
+                                set_zero(m_ac_partial[i]);
+                            }
+                        }
+                    }
+                    first += block;
                 }
             }
 
@@ -309,6 +371,37 @@ namespace alps {
                     }
                 }
             }
+
+            template<typename T, typename B>
+            void Accumulator<T, binning_analysis_tag, B>::collective_merge(alps::alps_mpi::collective_merge_buffer & buffer) {
+                using alps::numeric::check_size;
+
+                B::collective_merge(buffer);
+                std::size_t const levels = buffer.maximum(m_ac_count.size());
+                if (buffer.phase() != alps::alps_mpi::collective_merge_buffer::pack
+                 && buffer.phase() != alps::alps_mpi::collective_merge_buffer::unpack)
+                    return;
+
+                std::vector<typename count_type<B>::type> count(m_ac_count);
+                count.resize(levels);
+                std::vector<T> sum(m_ac_sum), sum2(m_ac_sum2);
+                sum.resize(levels);
+                sum2.resize(levels);
+                // pad the missing levels to the size of the mean, which is the same on all processes
+                for (std::size_t i = 0; i < levels; ++i) {
+                    check_size(sum[i], B::sum());
+                    check_size(sum2[i], B::sum());
+                }
+
+                buffer.sum(count);
+                buffer.sum(sum);
+                buffer.sum(sum2);
+                if (buffer.phase() == alps::alps_mpi::collective_merge_buffer::unpack) {
+                    m_ac_count.swap(count);
+                    m_ac_sum.swap(sum);
+                    m_ac_sum2.swap(sum2);
+                }
+            }
 #endif
 
             #define ALPS_ACCUMULATOR_INST_BINNING_ANALYSIS_ACC(r, data, T)                         \
@@ -331,6 +424,11 @@ namespace alps {
                 , m_ac_errors()
             {}
 
+            template<typename T, typename B>
+            typename alps::accumulators::convergence_type<B>::type Result<T, binning_analysis_tag, B>::converged_errors() const {
+                return detail::binning_convergence<typename convergence_type<B>::type>(*this, m_ac_errors.size());
+            }
+
             template<typename T, typename B>
             auto Result<T, binning_analysis_tag, B>::error(std::size_t bin_level) const -> error_type const {
                 if (m_ac_errors.size() < 2)
@@ -26,6 +26,11 @@ namespace alps {
                 throw std::runtime_error("No values can be added to a result" + ALPS_STACKTRACE);
             }
 
+            template<typename T, typename B>
+            void Result<T, count_tag, B>::operator()(T const *, std::size_t) {
+                throw std::runtime_error("No values can be added to a result" + ALPS_STACKTRACE);
+            }
+
             template<typename T, typename B>
             void Result<T, count_tag, B>::save(hdf5::archive & ar) const {
                 if (m_count==0) {
@@ -109,6 +114,11 @@ namespace alps {
                 else
                     alps::alps_mpi::reduce(comm, m_count, std::plus<count_type>(), root);
             }
+
+            template<typename T, typename B>
+            void Accumulator<T, count_tag, B>::collective_merge(alps::alps_mpi::collective_merge_buffer & buffer) {
+                buffer.sum(m_count);
+            }
 #endif
 
             #define ALPS_ACCUMULATOR_INST_COUNT_ACC(r, data, T) \
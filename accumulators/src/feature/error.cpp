@@ -11,6 +11,7 @@
 
 #include <alps/accumulators/feature/error.hpp>
 #include <alps/hdf5/vector.hpp>
+#include <alps/numeric/inplace_functions.hpp>
 
 #define ALPS_ACCUMULATOR_VALUE_TYPES_SEQ BOOST_PP_TUPLE_TO_SEQ(ALPS_ACCUMULATOR_VALUE_TYPES_SIZE, (ALPS_ACCUMULATOR_VALUE_TYPES))
 
@@ -39,13 +40,24 @@ namespace alps {
 
             template<typename T, typename B>
             void Accumulator<T, error_tag, B>::operator()(T const & val) {
-                using alps::numeric::operator*;
-                using alps::numeric::operator+=;
                 using alps::numeric::check_size;
+                using alps::numeric::add_square;
 
                 B::operator()(val);
                 check_size(m_sum2, val);
-                m_sum2 += val * val;
+                add_square(m_sum2, val);
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, error_tag, B>::operator()(T const * first, std::size_t n) {
+                using alps::numeric::check_size;
+                using alps::numeric::add_square;
+
+                B::operator()(first, n);
+                for (T const * it = first; it != first + n; ++it) {
+                    check_size(m_sum2, *it);
+                    add_square(m_sum2, *it);
+                }
             }
 
             template<typename T, typename B>
@@ -100,6 +112,13 @@ namespace alps {
                 else
                     B::reduce_if(comm, m_sum2, std::plus<typename alps::hdf5::scalar_type<T>::type>(), root);
             }
+
+            template<typename T, typename B>
+            void Accumulator<T, error_tag, B>::collective_merge(alps::alps_mpi::collective_merge_buffer & buffer) {
+                B::collective_merge(buffer);
+                // the size is the same as the size of the mean, checked by B
+                buffer.sum(m_sum2);
+            }
 #endif
 
             #define ALPS_ACCUMULATOR_INST_ERROR_ACC(r, data, T)                                    \
@@ -7,10 +7,14 @@
 #include <alps/accumulators/feature/max_num_binning.hpp>
 #include <alps/accumulators/feature/binning_analysis.hpp>
 #include <alps/hdf5/vector.hpp>
+#include <alps/numeric/inplace_functions.hpp>
 
 #include <boost/preprocessor/tuple/to_seq.hpp>
 #include <boost/preprocessor/seq/for_each.hpp>
 
+#include <algorithm>
+#include <iterator>
+
 #define ALPS_ACCUMULATOR_VALUE_TYPES_SEQ BOOST_PP_TUPLE_TO_SEQ(ALPS_ACCUMULATOR_VALUE_TYPES_SIZE, (ALPS_ACCUMULATOR_VALUE_TYPES))
 
 namespace alps {
@@ -42,12 +46,24 @@ namespace alps {
 
             template<typename T, typename B>
             void Accumulator<T, max_num_binning_tag, B>::operator()(T const & val) {
+                B::operator()(val);
+                add_to_bins(val);
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, max_num_binning_tag, B>::operator()(T const * first, std::size_t n) {
+                B::operator()(first, n);
+                for (T const * it = first; it != first + n; ++it)
+                    add_to_bins(*it);
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, max_num_binning_tag, B>::add_to_bins(T const & val) {
                 using alps::numeric::operator+=;
-                using alps::numeric::operator+;
-                using alps::numeric::operator/;
                 using alps::numeric::check_size;
-
-                B::operator()(val);
+                using alps::numeric::set_zero;
+                using alps::numeric::assign_divided;
+                using alps::numeric::assign_sum_divided;
 
                 if (!m_mn_elements_in_bin) {
                     m_mn_bins.push_back(val);
@@ -69,13 +85,21 @@ namespace alps {
                         m_mn_elements_in_partial += m_mn_elements_in_bin;
                     }
                     for (typename count_type<T>::type i = 0; i < m_mn_max_number / 2; ++i)
-                        m_mn_bins[i] = (m_mn_bins[2 * i] + m_mn_bins[2 * i + 1]) / two;
+                        assign_sum_divided(m_mn_bins[i], m_mn_bins[2 * i], m_mn_bins[2 * i + 1], two);
+                    // keep the storage of the dropped bins for the bins to come
+                    std::move(m_mn_bins.begin() + m_mn_max_number / 2, m_mn_bins.end(), std::back_inserter(m_mn_spare_bins));
                     m_mn_bins.erase(m_mn_bins.begin() + m_mn_max_number / 2, m_mn_bins.end());
                     m_mn_elements_in_bin *= (typename count_type<T>::type)2;
                 }
                 if (m_mn_elements_in_partial == m_mn_elements_in_bin) {
-                    m_mn_bins.push_back(m_mn_partial / elements_in_bin);
-                    m_mn_partial = T();
+                    if (m_mn_spare_bins.empty())
+                        m_mn_bins.push_back(typename mean_type<B>::type());
+                    else {
+                        m_mn_bins.push_back(std::move(m_mn_spare_bins.back()));
+                        m_mn_spare_bins.pop_back();
+                    }
+                    assign_divided(m_mn_bins.back(), m_mn_partial, elements_in_bin);
+                    set_zero(m_mn_partial);
                     m_mn_elements_in_partial = 0;
                 }
             }
@@ -131,6 +155,54 @@ namespace alps {
                 m_mn_elements_in_partial = typename B::count_type();
                 m_mn_partial = T();
                 m_mn_bins = std::vector<typename mean_type<B>::type>();
+                m_mn_spare_bins = std::vector<typename mean_type<B>::type>();
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, max_num_binning_tag, B>::rebin_local(std::vector<typename mean_type<B>::type> & local_bins,
+                                                                     typename B::count_type elements_in_bin) const
+            {
+                using alps::numeric::operator+;
+                using alps::numeric::operator/;
+
+                typename B::count_type howmany = (elements_in_bin - 1) / m_mn_elements_in_bin + 1;
+                if (howmany > 1) {
+                    typename B::count_type newbins = local_bins.size() / howmany;
+                    typename alps::numeric::scalar<typename mean_type<B>::type>::type howmany_vt = howmany;
+                    for (typename B::count_type i = 0; i < newbins; ++i) {
+                        local_bins[i] = local_bins[howmany * i];
+                        for (typename B::count_type j = 1; j < howmany; ++j)
+                            local_bins[i] = local_bins[i] + local_bins[howmany * i + j];
+                        local_bins[i] = local_bins[i] / howmany_vt;
+                    }
+                        local_bins.resize(newbins);
+                }
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, max_num_binning_tag, B>::spread_bins(std::vector<typename mean_type<B>::type> const & local_bins,
+                                                                     std::vector<std::size_t> const & index,
+                                                                     int rank,
+                                                                     std::vector<typename mean_type<B>::type> & merged_bins) const
+            {
+                using alps::numeric::operator+;
+                using alps::numeric::operator/;
+                using alps::numeric::check_size;
+
+                std::size_t total_bins = std::accumulate(index.begin(), index.end(), 0);
+                std::size_t perbin = total_bins < m_mn_max_number ? 1 : total_bins / m_mn_max_number;
+                typename alps::numeric::scalar<typename mean_type<B>::type>::type perbin_vt = perbin;
+
+                merged_bins.resize(perbin == 1 ? total_bins : m_mn_max_number);
+                for (typename std::vector<typename mean_type<B>::type>::iterator it = merged_bins.begin(); it != merged_bins.end(); ++it)
+                    check_size(*it, m_mn_bins[0]);
+
+                std::size_t start = std::accumulate(index.begin(), index.begin() + rank, 0);
+                for (std::size_t i = start / perbin, j = start % perbin, k = 0; i < merged_bins.size() && k < local_bins.size(); ++k) {
+                    merged_bins[i] = merged_bins[i] + local_bins[k] / perbin_vt;
+                    if (++j == perbin)
+                        ++i, j = 0;
+                }
             }
 
 #ifdef ALPS_HAVE_MPI
@@ -173,40 +245,34 @@ namespace alps {
                                                                         std::vector<typename mean_type<B>::type> & merged_bins,
                                                                         int) const
             {
-                using alps::numeric::operator+;
-                using alps::numeric::operator/;
-                using alps::numeric::check_size;
-
-                typename B::count_type elements_in_local_bins = alps::mpi::all_reduce(comm, m_mn_elements_in_bin, alps::mpi::maximum<typename B::count_type>());
-                typename B::count_type howmany = (elements_in_local_bins - 1) / m_mn_elements_in_bin + 1;
-                if (howmany > 1) {
-                    typename B::count_type newbins = local_bins.size() / howmany;
-                    typename alps::numeric::scalar<typename mean_type<B>::type>::type howmany_vt = howmany;
-                    for (typename B::count_type i = 0; i < newbins; ++i) {
-                        local_bins[i] = local_bins[howmany * i];
-                        for (typename B::count_type j = 1; j < howmany; ++j)
-                            local_bins[i] = local_bins[i] + local_bins[howmany * i + j];
-                        local_bins[i] = local_bins[i] / howmany_vt;
-                    }
-                        local_bins.resize(newbins);
-                }
+                rebin_local(local_bins, alps::mpi::all_reduce(comm, m_mn_elements_in_bin, alps::mpi::maximum<typename B::count_type>()));
 
                 std::vector<std::size_t> index(comm.size());
                 alps::mpi::all_gather(comm, local_bins.size(), index);
-                std::size_t total_bins = std::accumulate(index.begin(), index.end(), 0);
-                std::size_t perbin = total_bins < m_mn_max_number ? 1 : total_bins / m_mn_max_number;
-                typename alps::numeric::scalar<typename mean_type<B>::type>::type perbin_vt = perbin;
-
-                merged_bins.resize(perbin == 1 ? total_bins : m_mn_max_number);
-                for (typename std::vector<typename mean_type<B>::type>::iterator it = merged_bins.begin(); it != merged_bins.end(); ++it)
-                    check_size(*it, local_bins[0]);
+                spread_bins(local_bins, index, comm.rank(), merged_bins);
+            }
 
-                std::size_t start = std::accumulate(index.begin(), index.begin() + comm.rank(), 0);
-                for (std::size_t i = start / perbin, j = start % perbin, k = 0; i < merged_bins.size() && k < local_bins.size(); ++k) {
-                    merged_bins[i] = merged_bins[i] + local_bins[k] / perbin_vt;
-                    if (++j == perbin)
-                        ++i, j = 0;
-                }
+            template<typename T, typename B>
+            void Accumulator<T, max_num_binning_tag, B>::collective_merge(alps::alps_mpi::collective_merge_buffer & buffer)
+            {
+                typedef alps::alps_mpi::collective_merge_buffer buffer_type;
+
+                B::collective_merge(buffer);
+                bool const has_bins = buffer.same(!m_mn_bins.empty(), "presence of the full binning bins") != 0;
+                typename B::count_type const elements_in_bin = buffer.maximum(m_mn_elements_in_bin);
+                if (buffer.phase() == buffer_type::shape || !has_bins)
+                    return;
+
+                std::vector<typename mean_type<B>::type> local_bins(m_mn_bins), merged_bins;
+                rebin_local(local_bins, elements_in_bin);
+                std::vector<boost::uint64_t> const sizes = buffer.all(local_bins.size());
+                if (buffer.phase() == buffer_type::gather)
+                    return;
+
+                spread_bins(local_bins, std::vector<std::size_t>(sizes.begin(), sizes.end()), buffer.rank(), merged_bins);
+                buffer.sum(merged_bins);
+                if (buffer.phase() == buffer_type::unpack)
+                    m_mn_bins.swap(merged_bins);
             }
 #endif
 
@@ -42,6 +42,18 @@ namespace alps {
                 m_sum += val;
             }
 
+            template<typename T, typename B>
+            void Accumulator<T, mean_tag, B>::operator()(T const * first, std::size_t n) {
+                using alps::numeric::operator+=;
+                using alps::numeric::check_size;
+
+                B::operator()(first, n);
+                for (T const * it = first; it != first + n; ++it) {
+                    check_size(m_sum, *it);
+                    m_sum += *it;
+                }
+            }
+
             template<typename T, typename B>
             void Accumulator<T, mean_tag, B>::save(hdf5::archive & ar) const {
                 B::save(ar);
@@ -94,6 +106,13 @@ namespace alps {
                 else
                     B::reduce_if(comm, m_sum, std::plus<typename alps::hdf5::scalar_type<T>::type>(), root);
             }
+
+            template<typename T, typename B>
+            void Accumulator<T, mean_tag, B>::collective_merge(alps::alps_mpi::collective_merge_buffer & buffer) {
+                B::collective_merge(buffer);
+                buffer.same(buffer.size(m_sum), "size of the mean");
+                buffer.sum(m_sum);
+            }
 #endif
 
             template<typename T, typename B>
@@ -271,6 +271,111 @@
             ALPS_INST_MPI_REDUCE(double)
             ALPS_INST_MPI_REDUCE(long double)
 
+            //
+            // collective_merge_buffer
+            //
+
+            collective_merge_buffer::collective_merge_buffer()
+                : m_phase(shape)
+                , m_rank(0)
+                , m_size(1)
+                , m_maximum_position(0)
+                , m_all_count(0)
+                , m_all_position(0)
+            {}
+
+            boost::uint64_t collective_merge_buffer::maximum(boost::uint64_t value) {
+                if (m_phase == shape) {
+                    m_maximum.push_back(value);
+                    return value;
+                }
+                if (m_maximum_position >= m_maximum.size())
+                    throw std::logic_error("The accumulators made more calls to maximum() than in the shape phase" + ALPS_STACKTRACE);
+                return m_maximum[m_maximum_position++];
+            }
+
+            boost::uint64_t collective_merge_buffer::same(boost::uint64_t value, std::string const & what) {
+                boost::uint64_t const max = maximum(value);
+                boost::uint64_t const min = ~maximum(~value);
+                if (m_phase != shape && max != min)
+                    throw std::runtime_error("The " + what + " differs between MPI processes: between "
+                                             + std::to_string(min) + " and " + std::to_string(max) + ALPS_STACKTRACE);
+                return value;
+            }
+
+            std::vector<boost::uint64_t> collective_merge_buffer::all(boost::uint64_t value) {
+                if (m_phase == gather) {
+                    m_all.push_back(value);
+                    ++m_all_count;
+                    return std::vector<boost::uint64_t>();
+                }
+                if (m_phase == shape)
+                    return std::vector<boost::uint64_t>();
+                if (m_all_position >= m_all_count)
+                    throw std::logic_error("The accumulators made more calls to all() than in the gather phase" + ALPS_STACKTRACE);
+                // m_all is laid out rank by rank
+                std::vector<boost::uint64_t> values(m_size);
+                for (int r = 0; r < m_size; ++r)
+                    values[r] = m_all[r * m_all_count + m_all_position];
+                ++m_all_position;
+                return values;
+            }
+
+            template<typename S> void collective_merge_buffer::reduce(alps::mpi::communicator const & comm, int root, sum_buffer<S> & buffer) {
+                if (buffer.data.empty())
+                    return;
+                using alps::mpi::get_mpi_datatype;
+                alps::mpi::checked(detail::checked_mpi_reduce(comm.rank() == root ? MPI_IN_PLACE : &buffer.data.front(),
+                                                              comm.rank() == root ? &buffer.data.front() : NULL,
+                                                              buffer.data.size(), get_mpi_datatype(S()), MPI_SUM, root, comm));
+                buffer.position = 0;
+            }
+
+            bool collective_merge_buffer::next_phase(alps::mpi::communicator const & comm, int root) {
+                using alps::mpi::get_mpi_datatype;
+                switch (m_phase) {
+                    case shape:
+                        m_rank = comm.rank();
+                        m_size = comm.size();
+                        {
+                            // the buffers are only well-formed if all ranks made the same number of calls
+                            boost::uint64_t counts[2] = { m_maximum.size(), ~boost::uint64_t(m_maximum.size()) };
+                            alps::mpi::checked(MPI_Allreduce(MPI_IN_PLACE, counts, 2, get_mpi_datatype(boost::uint64_t()), MPI_MAX, comm));
+                            if (counts[0] != ~counts[1])
+                                throw std::runtime_error("The accumulators to merge differ between MPI processes" + ALPS_STACKTRACE);
+                        }
+                        if (!m_maximum.empty())
+                            alps::mpi::checked(MPI_Allreduce(MPI_IN_PLACE, &m_maximum.front(), m_maximum.size(),
+                                                             get_mpi_datatype(boost::uint64_t()), MPI_MAX, comm));
+                        m_phase = gather;
+                        break;
+                    case gather:
+                        if (m_all_count != 0) {
+                            std::vector<boost::uint64_t> local;
+                            local.swap(m_all);
+                            m_all.resize(m_all_count * m_size);
+                            alps::mpi::checked(MPI_Allgather(&local.front(), m_all_count, get_mpi_datatype(boost::uint64_t()),
+                                                             &m_all.front(), m_all_count, get_mpi_datatype(boost::uint64_t()), comm));
+                        }
+                        m_phase = pack;
+                        break;
+                    case pack:
+                        reduce(comm, root, std::get<0>(m_sums));
+                        reduce(comm, root, std::get<1>(m_sums));
+                        reduce(comm, root, std::get<2>(m_sums));
+                        reduce(comm, root, std::get<3>(m_sums));
+                        m_phase = (comm.rank() == root ? unpack : done);
+                        break;
+                    case unpack:
+                    case done:
+                        m_phase = done;
+                        break;
+                }
+                m_maximum_position = 0;
+                m_all_position = 0;
+                return m_phase != done;
+            }
+
         } // alps_mpi::
     } // alps::
 
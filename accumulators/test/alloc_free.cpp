@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file alloc_free.cpp
+    Test that adding vector values does not allocate once the accumulator is warmed up
+*/
+
+#include <cstdlib>
+#include <new>
+
+#include <alps/config.hpp>
+#include <alps/accumulators.hpp>
+#include "gtest/gtest.h"
+
+namespace aa=alps::accumulators;
+
+/// Number of calls to the global operator new
+static std::size_t num_allocations=0;
+
+void* operator new(std::size_t size) {
+    ++num_allocations;
+    if (void* p=std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+/// Google Test Fixture: A is a named accumulator type
+template <typename A>
+class AccumulatorAllocFreeTest : public ::testing::Test {
+  public:
+    typedef A named_acc_type;
+    typedef typename aa::accumulator_handle<named_acc_type>::value_type value_type;
+
+    aa::accumulator_set m;
+    aa::accumulator_handle<named_acc_type> h;
+    std::vector<value_type> data;
+
+    AccumulatorAllocFreeTest() {
+        m << named_acc_type("data");
+        h=m.template handle<named_acc_type>("data");
+        for (int i=0; i<16; ++i) data.push_back(value_type(1000, 0.5*i-3.));
+    }
+
+    /// Add values until the count reaches `last`
+    void add_up_to(std::size_t last) {
+        for (std::size_t i=h.accumulator().count(); i<last; ++i) h << data[i%data.size()];
+    }
+
+    /// Add values in batches of 5 until the count reaches `last`
+    void add_batches_up_to(std::size_t last) {
+        for (std::size_t i=h.accumulator().count(); i<last; i+=5) h(&data[i%(data.size()-5)], std::min<std::size_t>(5, last-i));
+    }
+};
+
+typedef ::testing::Types<
+    aa::MeanAccumulator<std::vector<double> >,
+    aa::NoBinningAccumulator<std::vector<double> >,
+    aa::LogBinningAccumulator<std::vector<double> >,
+    aa::FullBinningAccumulator<std::vector<double> >
+    > MyTypes;
+
+TYPED_TEST_CASE(AccumulatorAllocFreeTest, MyTypes);
+
+// New binning levels are opened at counts 2^k: the values in between must not allocate
+TYPED_TEST(AccumulatorAllocFreeTest, SingleValues) {
+    this->add_up_to(4097);
+    std::size_t before=num_allocations;
+    this->add_up_to(8191);
+    EXPECT_EQ(before, num_allocations);
+}
+
+TYPED_TEST(AccumulatorAllocFreeTest, Batches) {
+    this->add_batches_up_to(4097);
+    std::size_t before=num_allocations;
+    this->add_batches_up_to(8191);
+    EXPECT_EQ(before, num_allocations);
+}
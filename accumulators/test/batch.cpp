@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file batch.cpp
+    Test that adding values in batches gives the same state as adding them one by one
+*/
+
+#include <alps/config.hpp>
+#include <alps/accumulators.hpp>
+#include "gtest/gtest.h"
+
+#include "accumulator_generator.hpp"
+
+namespace aa=alps::accumulators;
+namespace aat=alps::accumulators::testing;
+
+/// Google Test Fixture: A is a named accumulator type
+template <typename A>
+class AccumulatorBatchTest : public ::testing::Test {
+  public:
+    typedef A named_acc_type;
+    typedef typename named_acc_type::accumulator_type raw_acc_type;
+    typedef typename aa::value_type<raw_acc_type>::type value_type;
+    static const bool is_mean_acc = aat::is_same_accumulator<named_acc_type, aa::MeanAccumulator>::value;
+    static const bool is_nobin_acc = aat::is_same_accumulator<named_acc_type, aa::NoBinningAccumulator>::value;
+    static const bool is_fullbin_acc = aat::is_same_accumulator<named_acc_type, aa::FullBinningAccumulator>::value;
+
+    std::vector<value_type> data;
+    aa::accumulator_set one_by_one, batched;
+
+    AccumulatorBatchTest() {
+        aat::RandomData gen;
+        for (int i=0; i<5000; ++i) data.push_back(aat::gen_data<value_type>(gen(), 3).value());
+        one_by_one << named_acc_type("data");
+        batched << named_acc_type("data");
+        for (std::size_t i=0; i<data.size(); ++i) one_by_one["data"] << data[i];
+    }
+
+    const raw_acc_type& raw(aa::accumulator_set& m) { return m["data"].extract<raw_acc_type>(); }
+
+    void compare_binning(const raw_acc_type&, const raw_acc_type&, std::false_type) {}
+    void compare_binning(const raw_acc_type& expected, const raw_acc_type& actual, std::true_type) {
+        ASSERT_EQ(expected.binning_depth(), actual.binning_depth());
+        for (std::size_t i=0; i<expected.binning_depth(); ++i) {
+            EXPECT_EQ(expected.error(i), actual.error(i)) << "at binning level " << i;
+        }
+        EXPECT_EQ(expected.autocorrelation(), actual.autocorrelation());
+    }
+
+    void compare_bins(const raw_acc_type&, const raw_acc_type&, std::false_type) {}
+    void compare_bins(const raw_acc_type& expected, const raw_acc_type& actual, std::true_type) {
+        EXPECT_EQ(expected.max_num_binning().num_elements(), actual.max_num_binning().num_elements());
+        EXPECT_EQ(expected.max_num_binning().bins(), actual.max_num_binning().bins());
+    }
+
+    /// Bitwise comparison of the accumulator states
+    void compare() {
+        const raw_acc_type& expected=raw(one_by_one);
+        const raw_acc_type& actual=raw(batched);
+        EXPECT_EQ(expected.count(), actual.count());
+        EXPECT_EQ(expected.mean(), actual.mean());
+        compare_error(expected, actual, std::integral_constant<bool, !is_mean_acc>());
+        compare_binning(expected, actual, std::integral_constant<bool, !is_mean_acc && !is_nobin_acc>());
+        compare_bins(expected, actual, std::integral_constant<bool, is_fullbin_acc>());
+    }
+
+    void compare_error(const raw_acc_type&, const raw_acc_type&, std::false_type) {}
+    void compare_error(const raw_acc_type& expected, const raw_acc_type& actual, std::true_type) {
+        EXPECT_EQ(expected.error(), actual.error());
+    }
+
+    /// Add data in batches of the given size via the wrapper
+    void add_via_wrapper(std::size_t batch) {
+        for (std::size_t i=0; i<data.size(); i+=batch)
+            batched["data"](&data[i], std::min(batch, data.size()-i));
+    }
+
+    /// Add data in batches of the given size via a handle
+    void add_via_handle(std::size_t batch) {
+        aa::accumulator_handle<named_acc_type> h=batched.handle<named_acc_type>("data");
+        for (std::size_t i=0; i<data.size(); i+=batch)
+            h(&data[i], std::min(batch, data.size()-i));
+    }
+};
+
+typedef ::testing::Types<
+    aa::MeanAccumulator<double>,
+    aa::NoBinningAccumulator<double>,
+    aa::LogBinningAccumulator<double>,
+    aa::FullBinningAccumulator<double>,
+    aa::MeanAccumulator<std::vector<double> >,
+    aa::NoBinningAccumulator<std::vector<double> >,
+    aa::LogBinningAccumulator<std::vector<double> >,
+    aa::FullBinningAccumulator<std::vector<double> >
+    > MyTypes;
+
+TYPED_TEST_CASE(AccumulatorBatchTest, MyTypes);
+
+TYPED_TEST(AccumulatorBatchTest, WholeData) { this->add_via_wrapper(this->data.size()); this->compare(); }
+TYPED_TEST(AccumulatorBatchTest, SingleValues) { this->add_via_wrapper(1); this->compare(); }
+TYPED_TEST(AccumulatorBatchTest, OddBatches) { this->add_via_wrapper(7); this->compare(); }
+TYPED_TEST(AccumulatorBatchTest, PowerOfTwoBatches) { this->add_via_wrapper(64); this->compare(); }
+TYPED_TEST(AccumulatorBatchTest, Handle) { this->add_via_handle(333); this->compare(); }
+
+TEST(AccumulatorBatch, WrongType) {
+    aa::accumulator_set m;
+    m << aa::MeanAccumulator<double>("mean");
+    std::vector<float> data(10, 1.f);
+    EXPECT_THROW(m["mean"](&data[0], data.size()), std::logic_error);
+}
+
+TEST(AccumulatorBatch, EmptyVector) {
+    aa::accumulator_set m;
+    m << aa::MeanAccumulator< std::vector<double> >("vec");
+    std::vector< std::vector<double> > data(2);
+    data[0].resize(3);
+    EXPECT_THROW(m["vec"](&data[0], data.size()), std::runtime_error);
+}
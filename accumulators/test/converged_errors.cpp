@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file converged_errors.cpp
+    Test the convergence of the binning analysis
+*/
+
+#include <alps/config.hpp>
+#include <alps/accumulators.hpp>
+#include <alps/accumulators/convergence.hpp>
+#include "gtest/gtest.h"
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+
+#include <vector>
+
+namespace aa=alps::accumulators;
+
+class AccumulatorConvergenceTest : public ::testing::Test {
+  public:
+    typedef aa::LogBinningAccumulator<double>::accumulator_type raw_acc_type;
+    typedef aa::LogBinningAccumulator<std::vector<double> >::accumulator_type raw_vec_acc_type;
+
+    aa::accumulator_set m;
+
+    AccumulatorConvergenceTest() {
+        m << aa::LogBinningAccumulator<double>("uncorrelated")
+          << aa::LogBinningAccumulator<double>("correlated")
+          << aa::LogBinningAccumulator<double>("short")
+          << aa::LogBinningAccumulator<std::vector<double> >("vector")
+          << aa::NoBinningAccumulator<double>("nobinning");
+
+        boost::random::mt19937 rng(42);
+        boost::random::uniform_real_distribution<double> dist;
+        // the correlated value is constant over blocks of 1024 measurements
+        double block = 0;
+        for (int i=0; i<(1<<14); ++i) {
+            if (i%1024 == 0) block = dist(rng);
+            double x = dist(rng);
+            m["uncorrelated"] << x;
+            m["correlated"] << block;
+            m["nobinning"] << block;
+            std::vector<double> v(2, x);
+            v[1] = block;
+            m["vector"] << v;
+            if (i < 100) m["short"] << x;
+        }
+    }
+};
+
+TEST_F(AccumulatorConvergenceTest, Accumulator) {
+    EXPECT_EQ(alps::CONVERGED, m["uncorrelated"].extract<raw_acc_type>().converged_errors());
+    EXPECT_EQ(alps::NOT_CONVERGED, m["correlated"].extract<raw_acc_type>().converged_errors());
+    EXPECT_EQ(alps::MAYBE_CONVERGED, m["short"].extract<raw_acc_type>().converged_errors());
+
+    std::vector<int> conv = m["vector"].extract<raw_vec_acc_type>().converged_errors();
+    ASSERT_EQ(2u, conv.size());
+    EXPECT_EQ(alps::CONVERGED, conv[0]);
+    EXPECT_EQ(alps::NOT_CONVERGED, conv[1]);
+}
+
+TEST_F(AccumulatorConvergenceTest, Result) {
+    typedef raw_acc_type::result_type raw_result_type;
+    EXPECT_EQ(alps::CONVERGED, m["uncorrelated"].result()->extract<raw_result_type>().converged_errors());
+    EXPECT_EQ(alps::NOT_CONVERGED, m["correlated"].result()->extract<raw_result_type>().converged_errors());
+    EXPECT_EQ(alps::MAYBE_CONVERGED, m["short"].result()->extract<raw_result_type>().converged_errors());
+}
+
+TEST_F(AccumulatorConvergenceTest, Wrapper) {
+    EXPECT_TRUE(m["uncorrelated"].error_converged());
+    EXPECT_FALSE(m["correlated"].error_converged());
+    EXPECT_FALSE(m["short"].error_converged());
+    EXPECT_FALSE(m["vector"].error_converged());
+    // without binning analysis, there is nothing to check
+    EXPECT_TRUE(m["nobinning"].error_converged());
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file handle.cpp
+    Test typed accumulator handles obtained from an accumulator_set
+*/
+
+#include <alps/config.hpp>
+#include <alps/accumulators.hpp>
+#include "gtest/gtest.h"
+
+#include "accumulator_generator.hpp"
+
+namespace aa=alps::accumulators;
+namespace aat=alps::accumulators::testing;
+
+/// Google Test Fixture: A is a named accumulator type
+template <typename A>
+class AccumulatorHandleTest : public ::testing::Test {
+  public:
+    typedef A named_acc_type;
+    typedef typename aa::accumulator_handle<named_acc_type>::value_type value_type;
+    static const bool is_mean_acc = aat::is_same_accumulator<named_acc_type, aa::MeanAccumulator>::value;
+
+    aa::accumulator_set via_handle, via_name;
+
+    AccumulatorHandleTest() {
+        via_handle << named_acc_type("data");
+        via_name << named_acc_type("data");
+    }
+
+    static value_type make_value(double x, const double&) { return x; }
+    static value_type make_value(double x, const std::vector<double>&) { return value_type(3, x); }
+
+    /// Values added via a handle and via the set give identical results
+    void SameAsByName() {
+        aa::accumulator_handle<named_acc_type> h=via_handle.template handle<named_acc_type>("data");
+        ASSERT_TRUE(h.valid());
+        for (int i=0; i<1000; ++i) {
+            const value_type v=make_value(0.5*(i%7)+0.25*(i%3), value_type());
+            h << v;
+            via_name["data"] << v;
+        }
+        aa::result_set r1(via_handle), r2(via_name);
+        EXPECT_EQ(r2["data"].count(), r1["data"].count());
+        EXPECT_EQ(r2["data"].template mean<value_type>(), r1["data"].template mean<value_type>());
+        if (!is_mean_acc) {
+            EXPECT_EQ(r2["data"].template error<value_type>(), r1["data"].template error<value_type>());
+        }
+    }
+
+    /// Handles to non-existing accumulators or of a wrong type throw
+    void Invalid() {
+        EXPECT_FALSE(aa::accumulator_handle<named_acc_type>().valid());
+        EXPECT_THROW(via_handle.template handle<named_acc_type>("nonexistent"), std::out_of_range);
+        EXPECT_THROW(via_handle.template handle< aa::MeanAccumulator<float> >("data"), std::runtime_error);
+    }
+};
+
+typedef ::testing::Types<
+    aa::MeanAccumulator<double>,
+    aa::NoBinningAccumulator<double>,
+    aa::LogBinningAccumulator<double>,
+    aa::FullBinningAccumulator<double>,
+    aa::MeanAccumulator<std::vector<double> >,
+    aa::NoBinningAccumulator<std::vector<double> >,
+    aa::LogBinningAccumulator<std::vector<double> >,
+    aa::FullBinningAccumulator<std::vector<double> >
+    > MyTypes;
+
+TYPED_TEST_CASE(AccumulatorHandleTest, MyTypes);
+
+TYPED_TEST(AccumulatorHandleTest, SameAsByName) { this->SameAsByName(); }
+TYPED_TEST(AccumulatorHandleTest, Invalid) { this->Invalid(); }
+
+TEST(AccumulatorHandle, WrongAccumulatorType) {
+    aa::accumulator_set m;
+    m << aa::MeanAccumulator<double>("mean");
+    EXPECT_THROW(m.handle< aa::FullBinningAccumulator<double> >("mean"), std::runtime_error);
+}
+
+TEST(AccumulatorHandle, EmptyVector) {
+    aa::accumulator_set m;
+    m << aa::MeanAccumulator< std::vector<double> >("vec");
+    aa::accumulator_handle< aa::MeanAccumulator< std::vector<double> > > h=m.handle< aa::MeanAccumulator< std::vector<double> > >("vec");
+    EXPECT_THROW(h << std::vector<double>(), std::runtime_error);
+}
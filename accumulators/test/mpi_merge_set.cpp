@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file mpi_merge_set.cpp
+    Test the collective merge of a whole accumulator set against the merge of each accumulator
+*/
+
+#include <cmath>
+#include <cstdlib>
+
+#include "alps/utilities/mpi.hpp"
+
+#include "alps/config.hpp"
+#include "alps/accumulators.hpp"
+
+#include "alps/utilities/gtest_par_xml_output.hpp"
+#include "gtest/gtest.h"
+
+namespace aa=alps::accumulators;
+
+// The summation order of MPI may depend on the message size
+static const double REL_TOL=1E-6;
+
+static void expect_near(double expected, double actual, const std::string& msg)
+{
+    EXPECT_NEAR(expected, actual, REL_TOL*std::fabs(expected)) << msg;
+}
+
+template <typename T>
+static void expect_near(const std::vector<T>& expected, const std::vector<T>& actual, const std::string& msg)
+{
+    ASSERT_EQ(expected.size(), actual.size()) << msg;
+    for (std::size_t i=0; i<expected.size(); ++i) expect_near(expected[i], actual[i], msg);
+}
+
+class AccumulatorSetMergeTest : public ::testing::Test {
+  public:
+    alps::mpi::communicator comm;
+    aa::accumulator_set set_merged;
+    aa::accumulator_set each_merged;
+
+    AccumulatorSetMergeTest() {
+        add_accumulators(set_merged);
+        add_accumulators(each_merged);
+        fill(set_merged);
+        fill(each_merged);
+    }
+
+    static void add_accumulators(aa::accumulator_set& m) {
+        m << aa::FullBinningAccumulator<double>("full_scalar", aa::max_bin_number=32)
+          << aa::FullBinningAccumulator< std::vector<float> >("full_vector", aa::max_bin_number=32)
+          << aa::LogBinningAccumulator< std::vector<double> >("log_vector")
+          << aa::NoBinningAccumulator<long double>("nobin_scalar")
+          << aa::MeanAccumulator<float>("mean_scalar");
+    }
+
+    /// Fills the accumulators with a different number of samples on each rank
+    void fill(aa::accumulator_set& m) const {
+        srand48(43+comm.rank());
+        const int n=1000+337*comm.rank();
+        for (int i=0; i<n; ++i) {
+            const double x=drand48();
+            m["full_scalar"] << x;
+            m["full_vector"] << std::vector<float>(3, x);
+            m["log_vector"] << std::vector<double>(2, x);
+            m["nobin_scalar"] << (long double)x;
+            m["mean_scalar"] << (float)x;
+        }
+    }
+};
+
+TEST_F(AccumulatorSetMergeTest, SameAsEach) {
+    set_merged.collective_merge(comm, 0);
+    for (aa::accumulator_set::iterator it=each_merged.begin(); it!=each_merged.end(); ++it) {
+        it->second->collective_merge(comm, 0);
+    }
+
+    if (comm.rank()!=0) {
+        // the accumulators of the other ranks are reset
+        EXPECT_EQ(0u, set_merged["full_scalar"].count());
+        EXPECT_EQ(0u, set_merged["mean_scalar"].count());
+        return;
+    }
+    const int ntot=1000*comm.size()+337*comm.size()*(comm.size()-1)/2;
+    aa::result_set expected(each_merged), actual(set_merged);
+
+    EXPECT_EQ(ntot, actual["full_scalar"].count());
+    EXPECT_EQ(expected["full_scalar"].count(), actual["full_scalar"].count());
+    expect_near(expected["full_scalar"].mean<double>(), actual["full_scalar"].mean<double>(), "full_scalar mean");
+    expect_near(expected["full_scalar"].error<double>(), actual["full_scalar"].error<double>(), "full_scalar error");
+    // the jackknife error depends on the merged bins
+    expect_near((expected["full_scalar"]*expected["full_scalar"]).error<double>(),
+                (actual["full_scalar"]*actual["full_scalar"]).error<double>(), "full_scalar bins");
+
+    expect_near(expected["full_vector"].mean< std::vector<float> >(), actual["full_vector"].mean< std::vector<float> >(), "full_vector mean");
+    expect_near(expected["full_vector"].error< std::vector<float> >(), actual["full_vector"].error< std::vector<float> >(), "full_vector error");
+
+    expect_near(expected["log_vector"].mean< std::vector<double> >(), actual["log_vector"].mean< std::vector<double> >(), "log_vector mean");
+    expect_near(expected["log_vector"].error< std::vector<double> >(), actual["log_vector"].error< std::vector<double> >(), "log_vector error");
+
+    expect_near(expected["nobin_scalar"].mean<long double>(), actual["nobin_scalar"].mean<long double>(), "nobin_scalar mean");
+    expect_near(expected["nobin_scalar"].error<long double>(), actual["nobin_scalar"].error<long double>(), "nobin_scalar error");
+
+    EXPECT_EQ(ntot, actual["mean_scalar"].count());
+    expect_near(expected["mean_scalar"].mean<float>(), actual["mean_scalar"].mean<float>(), "mean_scalar mean");
+}
+
+TEST_F(AccumulatorSetMergeTest, StaticSet) {
+    typedef aa::static_accumulator_set< aa::FullBinningAccumulator<double>, aa::LogBinningAccumulator< std::vector<double> > > static_set_type;
+    static_set_type sset(aa::FullBinningAccumulator<double>("full_scalar", aa::max_bin_number=32),
+                         aa::LogBinningAccumulator< std::vector<double> >("log_vector"));
+    srand48(43+comm.rank());
+    const int n=1000+337*comm.rank();
+    for (int i=0; i<n; ++i) {
+        const double x=drand48();
+        sset.push<0>(x);
+        sset.push<1>(std::vector<double>(2, x));
+    }
+
+    sset.collective_merge(comm, 0);
+    each_merged["full_scalar"].collective_merge(comm, 0);
+    each_merged["log_vector"].collective_merge(comm, 0);
+
+    if (comm.rank()!=0) {
+        // the accumulators of the other ranks are reset
+        EXPECT_EQ(0u, sset.get<0>().count());
+        EXPECT_EQ(0u, sset.get<1>().count());
+        return;
+    }
+    aa::result_set expected(each_merged), actual(sset.results());
+    EXPECT_EQ(expected["full_scalar"].count(), actual["full_scalar"].count());
+    expect_near(expected["full_scalar"].error<double>(), actual["full_scalar"].error<double>(), "full_scalar error");
+    expect_near((expected["full_scalar"]*expected["full_scalar"]).error<double>(),
+                (actual["full_scalar"]*actual["full_scalar"]).error<double>(), "full_scalar bins");
+    expect_near(expected["log_vector"].error< std::vector<double> >(), actual["log_vector"].error< std::vector<double> >(), "log_vector error");
+}
+
+TEST_F(AccumulatorSetMergeTest, DifferentSets) {
+    if (comm.size()<2) return;
+    if (comm.rank()==1) set_merged << aa::MeanAccumulator<double>("extra");
+    // all ranks detect the mismatch
+    EXPECT_THROW(set_merged.collective_merge(comm, 0), std::runtime_error);
+}
+
+
+int main(int argc, char** argv)
+{
+   alps::mpi::environment env(argc, argv);
+   alps::gtest_par_xml_output tweak;
+   tweak(alps::mpi::communicator().rank(), argc, argv);
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file static_accumulator_set.cpp
+    Test the compile-time-typed accumulator set against the type-erased accumulator_set
+*/
+
+#include <cstdio>
+
+#include <alps/config.hpp>
+#include <alps/accumulators.hpp>
+#include <alps/testing/unique_file.hpp>
+#include <alps/hdf5.hpp>
+#include "gtest/gtest.h"
+
+#include "accumulator_generator.hpp"
+
+namespace aa=alps::accumulators;
+namespace aat=alps::accumulators::testing;
+
+typedef aa::static_accumulator_set<
+    aa::FullBinningAccumulator<double>,
+    aa::LogBinningAccumulator< std::vector<double> >,
+    aa::MeanAccumulator< std::vector<double> >
+    > static_set_type;
+
+// Instantiate all members, including the MPI-only ones
+template class aa::static_accumulator_set<
+    aa::FullBinningAccumulator<double>,
+    aa::LogBinningAccumulator< std::vector<double> >,
+    aa::MeanAccumulator< std::vector<double> >
+    >;
+
+class StaticAccumulatorSetTest : public ::testing::Test {
+  public:
+    static_set_type sset;
+    aa::accumulator_set dset;
+
+    StaticAccumulatorSetTest()
+        : sset(aa::FullBinningAccumulator<double>("scalar", aa::max_bin_number=64),
+               aa::LogBinningAccumulator< std::vector<double> >("vector"),
+               aa::MeanAccumulator< std::vector<double> >("mean"))
+    {
+        dset << aa::FullBinningAccumulator<double>("scalar", aa::max_bin_number=64)
+             << aa::LogBinningAccumulator< std::vector<double> >("vector")
+             << aa::MeanAccumulator< std::vector<double> >("mean");
+    }
+
+    /// Adds the same data to both sets
+    void fill(std::size_t n) {
+        aat::RandomData gen;
+        for (std::size_t i=0; i<n; ++i) {
+            const double x=gen();
+            const std::vector<double> v(3, x);
+            sset.push<0>(x);
+            sset.push<1>(v);
+            sset.push<2>(v);
+            dset["scalar"] << x;
+            dset["vector"] << v;
+            dset["mean"] << v;
+        }
+    }
+
+    /// Checks that the results of both sets are identical
+    static void compare(const aa::result_set& expected, const aa::result_set& actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        EXPECT_EQ(expected["scalar"].count(), actual["scalar"].count());
+        EXPECT_EQ(expected["scalar"].mean<double>(), actual["scalar"].mean<double>());
+        EXPECT_EQ(expected["scalar"].error<double>(), actual["scalar"].error<double>());
+        EXPECT_EQ(expected["vector"].mean< std::vector<double> >(), actual["vector"].mean< std::vector<double> >());
+        EXPECT_EQ(expected["vector"].error< std::vector<double> >(), actual["vector"].error< std::vector<double> >());
+        EXPECT_EQ(expected["mean"].mean< std::vector<double> >(), actual["mean"].mean< std::vector<double> >());
+    }
+};
+
+TEST_F(StaticAccumulatorSetTest, Names) {
+    EXPECT_EQ(3u, static_set_type::size());
+    EXPECT_EQ("scalar", sset.name(0));
+    EXPECT_EQ("mean", sset.name(2));
+    EXPECT_EQ(64u, sset.get<0>().max_num_binning().max_number());
+}
+
+TEST_F(StaticAccumulatorSetTest, SameAsDynamic) {
+    fill(1000);
+    EXPECT_EQ(1000u, sset.get<1>().count());
+    compare(aa::result_set(dset), sset.results());
+}
+
+TEST_F(StaticAccumulatorSetTest, Batch) {
+    std::vector<double> data(100, 0.25);
+    sset.push<0>(&data[0], data.size());
+    EXPECT_EQ(100u, sset.get<0>().count());
+    EXPECT_EQ(0.25, sset.get<0>().mean());
+}
+
+TEST_F(StaticAccumulatorSetTest, Reset) {
+    fill(100);
+    sset.reset();
+    EXPECT_EQ(0u, sset.get<0>().count());
+    EXPECT_EQ(0u, sset.get<2>().count());
+}
+
+TEST_F(StaticAccumulatorSetTest, SaveLoad) {
+    fill(1000);
+    const std::string fname=alps::testing::temporary_filename("static_set.h5.");
+    {
+        alps::hdf5::archive ar(fname, "w");
+        ar["static"] << sset;
+    }
+    // The static set is saved in the layout of an accumulator_set
+    aa::accumulator_set loaded_dynamic;
+    static_set_type loaded_static(aa::FullBinningAccumulator<double>("scalar"),
+                                  aa::LogBinningAccumulator< std::vector<double> >("vector"),
+                                  aa::MeanAccumulator< std::vector<double> >("mean"));
+    {
+        alps::hdf5::archive ar(fname, "r");
+        ar["static"] >> loaded_dynamic;
+        ar["static"] >> loaded_static;
+    }
+    std::remove(fname.c_str());
+    compare(sset.results(), aa::result_set(loaded_dynamic));
+    compare(sset.results(), loaded_static.results());
+    EXPECT_EQ(64u, loaded_static.get<0>().max_num_binning().max_number());
+}
+
+TEST_F(StaticAccumulatorSetTest, EmptyVector) {
+    EXPECT_THROW(sset.push<2>(std::vector<double>()), std::runtime_error);
+}
+
+TEST(StaticAccumulatorSet, Merge) {
+    typedef aa::static_accumulator_set< aa::FullBinningAccumulator<double>, aa::MeanAccumulator< std::vector<double> > > set_type;
+    set_type s1(aa::FullBinningAccumulator<double>("scalar"), aa::MeanAccumulator< std::vector<double> >("vector"));
+    set_type s2(s1);
+    for (int i=0; i<100; ++i) {
+        s1.push<0>(1.);
+        s1.push<1>(std::vector<double>(2, 1.));
+        s2.push<0>(3.);
+        s2.push<1>(std::vector<double>(2, 3.));
+    }
+    s1.merge(s2);
+    EXPECT_EQ(200u, s1.get<0>().count());
+    EXPECT_EQ(2., s1.get<0>().mean());
+    EXPECT_EQ(std::vector<double>(2, 2.), s1.get<1>().mean());
+    EXPECT_EQ(100u, s2.get<1>().count());
+}
+
+TEST(StaticAccumulatorSet, DuplicateName) {
+    typedef aa::static_accumulator_set< aa::MeanAccumulator<double>, aa::MeanAccumulator<double> > set_type;
+    EXPECT_THROW(set_type(aa::MeanAccumulator<double>("x"), aa::MeanAccumulator<double>("x")), std::out_of_range);
+}
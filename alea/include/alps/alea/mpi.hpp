@@ -8,17 +8,12 @@
 #include <alps/alea/core.hpp>
 #include <alps/utilities/mpi.hpp>     /* provides mpi.h */
 
+#include <algorithm>
+#include <vector>
+
 // TODO: merge into MPI
 namespace alps { namespace mpi {
 
-struct failed_operation : std::exception { };
-
-inline void checked(int retcode)
-{
-    if (retcode != MPI_SUCCESS)
-        throw failed_operation();
-}
-
 inline bool is_intercomm(const communicator &comm)
 {
     int flag;
@@ -97,4 +92,68 @@ private:
     int root_;
 };
 
+/**
+ * Deferred sum-reduction via an MPI communicator.
+ *
+ * Instead of reducing each view immediately, the views are queued and
+ * concatenated by data type at `commit()`, such that each data type is
+ * reduced with a single `MPI_Reduce`.  The views must stay valid until
+ * `commit()`, and their data is only reduced afterwards.
+ *
+ * As the results commit once after queueing all of their data, reducing e.g.
+ * an `autocorr_result` takes one collective per data type rather than a few
+ * per level.
+ */
+struct batched_mpi_reducer
+    : public mpi_reducer
+{
+    batched_mpi_reducer(const mpi::communicator &comm=mpi::communicator(), int root=0)
+        : mpi_reducer(comm, root)
+    { }
+
+    void reduce(view<double> data) const override { double_queue_.push_back(data); }
+
+    void reduce(view<long> data) const override { long_queue_.push_back(data); }
+
+    void commit() const override
+    {
+        flush(double_queue_, double_buffer_);
+        flush(long_queue_, long_buffer_);
+    }
+
+protected:
+    template <typename T>
+    void flush(std::vector<view<T> > &queue, std::vector<T> &buffer) const
+    {
+        size_t total = 0;
+        for (const view<T> &data : queue)
+            total += data.size();
+
+        if (total != 0) {
+            // Concatenate, reduce, and scatter back the reduced data on root
+            buffer.resize(total);
+            T *pos = buffer.data();
+            for (const view<T> &data : queue)
+                pos = std::copy(data.data(), data.data() + data.size(), pos);
+
+            inplace_reduce(view<T>(buffer.data(), total));
+
+            if (am_root()) {
+                const T *src = buffer.data();
+                for (view<T> &data : queue) {
+                    std::copy(src, src + data.size(), data.data());
+                    src += data.size();
+                }
+            }
+        }
+        queue.clear();
+    }
+
+private:
+    mutable std::vector<view<double> > double_queue_;
+    mutable std::vector<view<long> > long_queue_;
+    mutable std::vector<double> double_buffer_;
+    mutable std::vector<long> long_buffer_;
+};
+
 }}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 1998-2017 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+#pragma once
+
+#include <alps/alea/core.hpp>
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+namespace alps { namespace alea {
+
+struct thread_reducer;
+
+/** Outer reducer of the thread team has failed on the first thread */
+struct outer_reduction_failed : public std::exception { };
+
+/**
+ * Team of threads within a process which sum-reduce their data.
+ *
+ * The team is shared by all threads, while each thread reduces through its
+ * own `thread_reducer`.  If an `outer` reducer is given, the data reduced
+ * within the team is further reduced with it by the first thread of the team,
+ * which allows for a two-level reduction, e.g., threads within an MPI rank and
+ * MPI ranks within the cluster:
+ *
+ *     alps::alea::mpi_reducer mpi_red(comm);
+ *     alps::alea::thread_team team(nthreads, &mpi_red);
+ *     // in thread number i:
+ *     alps::alea::thread_reducer red(team, i);
+ *     result.reduce(red);
+ *
+ * The first thread of the team is the only one calling the outer reducer, so
+ * with `MPI_THREAD_FUNNELED`, it must be the main thread.  If the outer
+ * reducer throws, the first thread rethrows its exception, while the other
+ * threads throw `outer_reduction_failed`.
+ */
+class thread_team
+{
+public:
+    /** Creates team of `size` threads, optionally reducing further with `outer` */
+    thread_team(size_t size, const reducer *outer=nullptr);
+
+    /** Number of threads in the team */
+    size_t size() const { return size_; }
+
+    /** Reducer combining the teams, or `nullptr` */
+    const reducer *outer() const { return outer_; }
+
+protected:
+    void barrier();
+
+private:
+    size_t size_;
+    const reducer *outer_;
+    reducer_setup outer_setup_;
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    size_t waiting_, generation_;
+
+    std::vector<long> max_;
+    long shared_max_;
+    std::exception_ptr outer_error_;
+    std::vector<const std::vector<view<double> > *> double_queues_;
+    std::vector<const std::vector<view<long> > *> long_queues_;
+
+    friend struct thread_reducer;
+
+/** Outer reducer of the thread team has failed on the first thread */
+struct outer_reduction_failed : public std::exception { };
+};
+
+/**
+ * In-place sum-reduction over the threads of a `thread_team`.
+ *
+ * All threads of the team must call the methods of their reducers in the same
+ * order.  The views passed to `reduce()` are queued and summed at `commit()`
+ * along a binary tree, with one synchronization point per tree level.  After
+ * the commit, only the first thread of the team has the sum; the data of the
+ * other threads is unspecified.  With an outer reducer, all threads wait for
+ * the outer commit, so that an error there is raised on all threads.
+ */
+struct thread_reducer
+    : public reducer
+{
+    /** Creates reducer for the thread at position `pos` in the team */
+    thread_reducer(thread_team &team, size_t pos);
+
+    reducer_setup get_setup() const override;
+
+    long get_max(long value) const override;
+
+    void reduce(view<double> data) const override { double_queue_.push_back(data); }
+
+    void reduce(view<long> data) const override { long_queue_.push_back(data); }
+
+    void commit() const override;
+
+    thread_team &team() const { return team_; }
+
+    size_t pos() const { return pos_; }
+
+private:
+    void throw_outer_error(std::exception_ptr error) const;
+
+    thread_team &team_;
+    size_t pos_;
+
+    mutable std::vector<view<double> > double_queue_;
+    mutable std::vector<view<long> > long_queue_;
+};
+
+}}
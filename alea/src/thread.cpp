@@ -0,0 +1,180 @@
+#include <alps/alea/thread.hpp>
+
+#include <algorithm>
+
+namespace alps { namespace alea {
+
+namespace {
+
+/** Adds the views of `other` element-wise to the views of `self` */
+template <typename T>
+void add_views(std::vector<view<T> > &self, const std::vector<view<T> > &other)
+{
+    for (size_t k = 0; k != self.size(); ++k) {
+        T *dest = self[k].data();
+        const T *src = other[k].data();
+        for (size_t i = 0; i != self[k].size(); ++i)
+            dest[i] += src[i];
+    }
+}
+
+/** Checks whether the views of all threads have the same layout */
+template <typename T>
+bool same_layout(const std::vector<const std::vector<view<T> > *> &queues)
+{
+    const std::vector<view<T> > &first = *queues[0];
+    for (size_t j = 1; j != queues.size(); ++j) {
+        const std::vector<view<T> > &other = *queues[j];
+        if (other.size() != first.size())
+            return false;
+        for (size_t k = 0; k != first.size(); ++k) {
+            if (other[k].size() != first[k].size())
+                return false;
+        }
+    }
+    return true;
+}
+
+}
+
+thread_team::thread_team(size_t size, const reducer *outer)
+    : size_(size)
+    , outer_(outer)
+    , waiting_(0)
+    , generation_(0)
+    , max_(size)
+    , shared_max_(0)
+    , double_queues_(size)
+    , long_queues_(size)
+{
+    if (size == 0)
+        throw std::invalid_argument("Thread team must not be empty");
+
+    // Query the setup here, as the outer reducer may not be thread-safe
+    if (outer_ != nullptr) {
+        outer_setup_ = outer_->get_setup();
+    } else {
+        reducer_setup single = { 0, 1, true };
+        outer_setup_ = single;
+    }
+}
+
+void thread_team::barrier()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t generation = generation_;
+    if (++waiting_ == size_) {
+        waiting_ = 0;
+        ++generation_;
+        cond_.notify_all();
+    } else {
+        cond_.wait(lock, [this, generation] { return generation != generation_; });
+    }
+}
+
+thread_reducer::thread_reducer(thread_team &team, size_t pos)
+    : team_(team)
+    , pos_(pos)
+{
+    if (pos >= team.size())
+        throw std::out_of_range("Position in thread team out of range");
+}
+
+reducer_setup thread_reducer::get_setup() const
+{
+    const reducer_setup &outer = team_.outer_setup_;
+    reducer_setup setup = { outer.pos * team_.size() + pos_,
+                            outer.count * team_.size(),
+                            pos_ == 0 && outer.have_result };
+    return setup;
+}
+
+long thread_reducer::get_max(long value) const
+{
+    team_.max_[pos_] = value;
+    team_.barrier();
+    if (pos_ == 0) {
+        // Other threads are blocked at the barrier, so catch and pass on errors
+        team_.outer_error_ = nullptr;
+        try {
+            long result = *std::max_element(team_.max_.begin(), team_.max_.end());
+            if (team_.outer_ != nullptr)
+                result = team_.outer_->get_max(result);
+            team_.shared_max_ = result;
+        } catch (...) {
+            team_.outer_error_ = std::current_exception();
+        }
+    }
+    team_.barrier();
+    long result = team_.shared_max_;
+    std::exception_ptr error = team_.outer_error_;
+
+    // Do not let the next call overwrite the values before all threads read
+    team_.barrier();
+    if (error)
+        throw_outer_error(error);
+    return result;
+}
+
+void thread_reducer::commit() const
+{
+    team_.double_queues_[pos_] = &double_queue_;
+    team_.long_queues_[pos_] = &long_queue_;
+    team_.barrier();
+
+    // All threads come to the same conclusion here, so either all or none throw
+    bool ok = same_layout(team_.double_queues_) && same_layout(team_.long_queues_);
+    if (!ok) {
+        team_.barrier();
+        double_queue_.clear();
+        long_queue_.clear();
+        throw size_mismatch();
+    }
+
+    // Binary tree: at each level, thread i adds the data of thread i + step
+    for (size_t step = 1; step < team_.size(); step *= 2) {
+        if (pos_ % (2 * step) == 0 && pos_ + step < team_.size()) {
+            add_views(double_queue_, *team_.double_queues_[pos_ + step]);
+            add_views(long_queue_, *team_.long_queues_[pos_ + step]);
+        }
+        team_.barrier();
+    }
+
+    if (team_.outer_ == nullptr) {
+        double_queue_.clear();
+        long_queue_.clear();
+        return;
+    }
+
+    // Other threads wait for the outer commit, so catch and pass on errors
+    if (pos_ == 0) {
+        team_.outer_error_ = nullptr;
+        try {
+            for (view<double> &data : double_queue_)
+                team_.outer_->reduce(data);
+            for (view<long> &data : long_queue_)
+                team_.outer_->reduce(data);
+            team_.outer_->commit();
+        } catch (...) {
+            team_.outer_error_ = std::current_exception();
+        }
+    }
+    double_queue_.clear();
+    long_queue_.clear();
+
+    // The next call resets the error only after its first barrier, when all
+    // threads have read it
+    team_.barrier();
+    std::exception_ptr error = team_.outer_error_;
+    if (error)
+        throw_outer_error(error);
+}
+
+void thread_reducer::throw_outer_error(std::exception_ptr error) const
+{
+    if (pos_ == 0)
+        std::rethrow_exception(error);
+    throw outer_reduction_failed();
+}
+
+}}
@@ -4,12 +4,14 @@
 #include <alps/alea/covariance.hpp>
 #include <alps/alea/autocorr.hpp>
 #include <alps/alea/batch.hpp>
+#include <alps/alea/thread.hpp>
 
 #include "alps/utilities/gtest_par_xml_output.hpp"
 #include "gtest/gtest.h"
 #include "dataset.hpp"
 
 #include <iostream>
+#include <future>
 
 TEST(reducer, setup)
 {
@@ -32,6 +34,65 @@ TEST(reducer, get_max)
     EXPECT_EQ(setup.count, (unsigned)red.get_max(setup.pos) + 1);
 }
 
+TEST(batched_reducer, deferred)
+{
+    alps::mpi::communicator comm;
+    alps::alea::batched_mpi_reducer red(comm, 0);
+
+    std::vector<double> x(3, 1.0), y(2, 2.0);
+    std::vector<long> n(4, 1);
+    red.reduce(alps::alea::view<double>(x.data(), x.size()));
+    red.reduce(alps::alea::view<long>(n.data(), n.size()));
+    red.reduce(alps::alea::view<double>(y.data(), y.size()));
+
+    // nothing is reduced before the commit
+    EXPECT_EQ(std::vector<double>(3, 1.0), x);
+
+    red.commit();
+    if (comm.rank() == 0) {
+        EXPECT_EQ(std::vector<double>(3, comm.size()), x);
+        EXPECT_EQ(std::vector<double>(2, 2.0 * comm.size()), y);
+        EXPECT_EQ(std::vector<long>(4, comm.size()), n);
+    }
+}
+
+TEST(thread_reducer, two_level)
+{
+    const size_t nthreads = 3;
+    alps::alea::mpi_reducer mpi_red(alps::mpi::communicator(), 0);
+    alps::alea::thread_team team(nthreads, &mpi_red);
+
+    auto reduce_in_thread = [&team](size_t pos) {
+        alps::alea::thread_reducer red(team, pos);
+        alps::alea::reducer_setup setup = red.get_setup();
+
+        alps::alea::autocorr_acc<double> acc(2);
+        std::vector<double> curr(2);
+        for (size_t i = setup.pos; i < twogauss_count; i += setup.count) {
+            std::copy(twogauss_data[i], twogauss_data[i+1], curr.begin());
+            acc << curr;
+        }
+        alps::alea::autocorr_result<double> result = acc.result();
+        result.reduce(red);
+
+        EXPECT_EQ(setup.have_result, result.valid());
+        if (setup.have_result) {
+            EXPECT_EQ(twogauss_count, result.count());
+            std::vector<double> obs_mean = result.mean();
+            EXPECT_NEAR(obs_mean[0], twogauss_mean[0], 1e-6);
+            EXPECT_NEAR(obs_mean[1], twogauss_mean[1], 1e-6);
+        }
+    };
+
+    // the first thread calls MPI, so run it on the main thread
+    std::vector<std::future<void> > others;
+    for (size_t i = 1; i != nthreads; ++i)
+        others.push_back(std::async(std::launch::async, reduce_in_thread, i));
+    reduce_in_thread(0);
+    for (size_t i = 0; i != others.size(); ++i)
+        others[i].get();
+}
+
 TEST(autocorr, asymmetry)
 {
     alps::alea::autocorr_acc<double> acc_(2);
@@ -102,6 +163,24 @@ public:
         }
     }
 
+    void test_batched()
+    {
+        result_type result = acc_.result(), expected = acc_.result();
+
+        alps::alea::batched_mpi_reducer red(alps::mpi::communicator(), 0);
+        alps::alea::reducer_setup setup = red.get_setup();
+        result.reduce(red);
+        expected.reduce(red_);
+
+        EXPECT_EQ(setup.have_result, result.valid());
+        if (setup.have_result) {
+            EXPECT_EQ(expected.count(), result.count());
+            std::vector<value_type> obs_mean = result.mean(), exp_mean = expected.mean();
+            EXPECT_NEAR(exp_mean[0], obs_mean[0], 1e-12);
+            EXPECT_NEAR(exp_mean[1], obs_mean[1], 1e-12);
+        }
+    }
+
 private:
     Acc acc_;
     alps::alea::mpi_reducer red_;
@@ -119,6 +198,8 @@ TYPED_TEST_CASE(mpi_twogauss_case, test_types);
 
 TYPED_TEST(mpi_twogauss_case, test_mean) { this->test_mean(); }
 
+TYPED_TEST(mpi_twogauss_case, test_batched) { this->test_batched(); }
+
 int main(int argc, char** argv)
 {
    alps::mpi::environment env(argc, argv, false);
@@ -0,0 +1,171 @@
+#include <alps/alea/mean.hpp>
+#include <alps/alea/variance.hpp>
+#include <alps/alea/covariance.hpp>
+#include <alps/alea/autocorr.hpp>
+#include <alps/alea/batch.hpp>
+#include <alps/alea/thread.hpp>
+
+#include "gtest/gtest.h"
+#include "dataset.hpp"
+
+#include <future>
+#include <stdexcept>
+
+static const size_t nthreads = 5;
+
+/** Runs `func(pos)` in each thread of the team, returning the results */
+template <typename F>
+std::vector<bool> run_team(F func)
+{
+    std::vector<std::future<bool> > futures;
+    for (size_t i = 0; i != nthreads; ++i)
+        futures.push_back(std::async(std::launch::async, func, i));
+
+    std::vector<bool> results;
+    for (size_t i = 0; i != nthreads; ++i)
+        results.push_back(futures[i].get());
+    return results;
+}
+
+TEST(thread_reducer, setup)
+{
+    alps::alea::thread_team team(nthreads);
+    for (size_t i = 0; i != nthreads; ++i) {
+        alps::alea::reducer_setup setup = alps::alea::thread_reducer(team, i).get_setup();
+        EXPECT_EQ(i, setup.pos);
+        EXPECT_EQ(nthreads, setup.count);
+        EXPECT_EQ(i == 0, setup.have_result);
+    }
+    EXPECT_THROW(alps::alea::thread_reducer(team, nthreads), std::out_of_range);
+}
+
+TEST(thread_reducer, get_max)
+{
+    alps::alea::thread_team team(nthreads);
+    std::vector<bool> ok = run_team([&team](size_t pos) {
+        alps::alea::thread_reducer red(team, pos);
+        bool ok = true;
+        for (long round = 0; round != 10; ++round)
+            ok = ok && red.get_max(pos + round) == long(nthreads - 1 + round);
+        return ok;
+    });
+    EXPECT_EQ(std::vector<bool>(nthreads, true), ok);
+}
+
+TEST(thread_reducer, size_mismatch)
+{
+    alps::alea::thread_team team(nthreads);
+    std::vector<bool> ok = run_team([&team](size_t pos) {
+        alps::alea::thread_reducer red(team, pos);
+        std::vector<double> data(pos == 1 ? 2 : 3);
+        red.reduce(alps::alea::view<double>(data.data(), data.size()));
+        try {
+            red.commit();
+        } catch (const alps::alea::size_mismatch &) {
+            return true;
+        }
+        return false;
+    });
+    EXPECT_EQ(std::vector<bool>(nthreads, true), ok);
+}
+
+/** Outer reducer which fails in all reductions */
+struct failing_reducer
+    : public alps::alea::reducer
+{
+    alps::alea::reducer_setup get_setup() const override
+    {
+        alps::alea::reducer_setup setup = { 0, 1, true };
+        return setup;
+    }
+
+    long get_max(long) const override { throw std::runtime_error("get_max"); }
+
+    void reduce(alps::alea::view<double>) const override { }
+
+    void reduce(alps::alea::view<long>) const override { }
+
+    void commit() const override { throw std::runtime_error("commit"); }
+};
+
+/** Returns whether `func()` raises the error expected on thread `pos` */
+template <typename F>
+bool throws_outer_error(size_t pos, F func)
+{
+    try {
+        func();
+    } catch (const std::runtime_error &) {
+        return pos == 0;
+    } catch (const alps::alea::outer_reduction_failed &) {
+        return pos != 0;
+    }
+    return false;
+}
+
+TEST(thread_reducer, outer_error)
+{
+    failing_reducer outer;
+    alps::alea::thread_team team(nthreads, &outer);
+    std::vector<bool> ok = run_team([&team](size_t pos) {
+        alps::alea::thread_reducer red(team, pos);
+        std::vector<double> data(3, 1.0);
+        bool ok = true;
+        for (int round = 0; round != 3; ++round) {
+            ok = throws_outer_error(pos, [&] { red.get_max(pos); }) && ok;
+            red.reduce(alps::alea::view<double>(data.data(), data.size()));
+            ok = throws_outer_error(pos, [&] { red.commit(); }) && ok;
+        }
+        return ok;
+    });
+    EXPECT_EQ(std::vector<bool>(nthreads, true), ok);
+}
+
+template <typename Acc>
+class thread_twogauss_case
+    : public ::testing::Test
+{
+public:
+    typedef typename alps::alea::traits<Acc>::value_type value_type;
+    typedef typename alps::alea::traits<Acc>::result_type result_type;
+
+    void test_mean()
+    {
+        alps::alea::thread_team team(nthreads);
+        std::vector<bool> ok = run_team([&team](size_t pos) {
+            alps::alea::thread_reducer red(team, pos);
+            alps::alea::reducer_setup setup = red.get_setup();
+
+            Acc acc(2);
+            std::vector<value_type> curr(2);
+            for (size_t i = setup.pos; i < twogauss_count; i += setup.count) {
+                std::copy(twogauss_data[i], twogauss_data[i+1], curr.begin());
+                acc << curr;
+            }
+
+            result_type result = acc.result();
+            result.reduce(red);
+            if (result.valid() != setup.have_result)
+                return false;
+            if (!setup.have_result)
+                return true;
+
+            std::vector<value_type> obs_mean = result.mean();
+            return result.count() == twogauss_count
+                && std::abs(obs_mean[0] - twogauss_mean[0]) < 1e-6
+                && std::abs(obs_mean[1] - twogauss_mean[1]) < 1e-6;
+        });
+        EXPECT_EQ(std::vector<bool>(nthreads, true), ok);
+    }
+};
+
+typedef ::testing::Types<
+      alps::alea::mean_acc<double>
+    , alps::alea::var_acc<double>
+    , alps::alea::cov_acc<double>
+    , alps::alea::autocorr_acc<double>
+    , alps::alea::batch_acc<double>
+    > test_types;
+
+TYPED_TEST_CASE(thread_twogauss_case, test_types);
+
+TYPED_TEST(thread_twogauss_case, test_mean) { this->test_mean(); }
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace alps {
+namespace gf {
+
+/// Plan of a batched, mixed-radix fast Fourier transform of a fixed length N
+/**
+ * The plan transforms `batch` interleaved sequences at once: element k of sequence b is
+ * stored at `data[k*batch+b]`. This is the row-major layout of a Green's function whose
+ * first mesh is transformed, so all trailing indices are transformed together.
+ *
+ * The length is split into prime factors (powers of 2, 3 and 5 are efficient); a prime
+ * factor p costs O(p) operations per element, so lengths with large prime factors are slow.
+ */
+class fft_plan {
+public:
+  typedef std::complex<double> complex_type;
+
+  /// Prepares the transforms of length `size`
+  explicit fft_plan(std::size_t size);
+
+  /// Returns the (shared) plan for the length `size`
+  static std::shared_ptr<const fft_plan> get(std::size_t size);
+
+  std::size_t size() const { return size_; }
+
+  /// out[k] = sum_j in[j] exp(-2 pi i j k/N); `in` and `out` must not overlap
+  void forward(const complex_type *in, complex_type *out, std::size_t batch=1) const;
+
+  /// out[k] = sum_j in[j] exp(+2 pi i j k/N), without normalization; `in` and `out` must not overlap
+  void backward(const complex_type *in, complex_type *out, std::size_t batch=1) const;
+
+private:
+  void transform(const complex_type *in, complex_type *out, std::size_t batch, bool inverse) const;
+  void transform(const complex_type *in, complex_type *out, std::size_t n, std::size_t stride,
+                 std::size_t level, std::size_t batch, bool inverse, complex_type *scratch) const;
+  complex_type root(std::size_t power, bool inverse) const {
+    const complex_type &w=roots_[power%size_];
+    return inverse ? std::conj(w) : w;
+  }
+
+  std::size_t size_;
+  std::vector<std::size_t> factors_;
+  /// exp(-2 pi i j/N)
+  std::vector<complex_type> roots_;
+};
+
+}
+}
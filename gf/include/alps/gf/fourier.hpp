@@ -5,6 +5,23 @@
  */
 #pragma once
 #include <alps/gf/gf.hpp>
+#include <alps/gf/fft.hpp>
+#include <alps/numeric/tensors/parallel.hpp>
+
+#include <Eigen/Dense>
+
+#include <boost/math/special_functions/bessel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
 
 namespace alps {
 namespace gf {
@@ -29,109 +46,748 @@ inline void transform_vector_no_tail(const std::vector<std::complex<double> >&in
     }
   }
 }
-///Fourier transform a two-index matsubara gf to an imag time gf
-template<class MESH1> void fourier_frequency_to_time(const two_index_gf_with_tail<
-    two_index_gf<std::complex<double>, matsubara_positive_mesh, MESH1>, one_index_gf<double, MESH1> > &g_omega,
-    two_index_gf_with_tail<two_index_gf<double, itime_mesh, MESH1>, one_index_gf<double, MESH1> > &g_tau){
+/// Cache of the most recently used Fourier and Legendre kernels
+/**
+ * The kernels returned by get() are kept, most recently used first, as long as their total size
+ * stays within max_bytes() (256 MiB by default). The most recently used kernel is always kept,
+ * even if it is larger than that, so that repeated transforms between large meshes reuse it.
+ * The cached kernels live until they are evicted, or released by clear(); a kernel still in use
+ * is freed when its last user drops it.
+ *
+ * Kernels are computed without holding the lock of the cache, so that other threads can use it
+ * meanwhile; threads asking for the same missing kernel at the same time may each compute it.
+ */
+class kernel_cache {
+public:
+  /// Returns the cached kernel of type KERNEL for these arguments, or computes and caches it
+  /**
+   * KERNEL must be constructible from, and have a member matches() taking, the arguments of get(),
+   * and a member bytes() returning its size in memory.
+   */
+  template<class KERNEL, class... ARGS> static std::shared_ptr<const KERNEL> get(const ARGS &... args) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_());
+      std::shared_ptr<const KERNEL> kernel=find<KERNEL>(args...);
+      if (kernel) return kernel;
+    }
+    std::shared_ptr<const KERNEL> kernel=std::make_shared<KERNEL>(args...);
+    std::lock_guard<std::mutex> lock(mutex_());
+    // another thread may have cached the same kernel meanwhile
+    std::shared_ptr<const KERNEL> cached=find<KERNEL>(args...);
+    if (cached) return cached;
+    if (max_bytes_()>0) {
+      const entry e={kernel, &typeid(KERNEL), kernel->bytes()};
+      entries_().push_front(e);
+      bytes_()+=e.bytes;
+      shrink(max_bytes_());
+    }
+    return kernel;
+  }
+
+  /// Releases all cached kernels
+  static void clear() {
+    std::lock_guard<std::mutex> lock(mutex_());
+    entries_().clear();
+    bytes_()=0;
+  }
+
+  /// Total size of the cached kernels in bytes
+  static std::size_t bytes() {
+    std::lock_guard<std::mutex> lock(mutex_());
+    return bytes_();
+  }
+
+  /// Maximal total size of the cached kernels in bytes
+  static std::size_t max_bytes() {
+    std::lock_guard<std::mutex> lock(mutex_());
+    return max_bytes_();
+  }
+
+  /// Set the maximal total size of the cached kernels in bytes, evicting the least recently used kernels; 0 disables the cache
+  static void set_max_bytes(std::size_t max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_());
+    max_bytes_()=max_bytes;
+    if (max_bytes==0) {
+      entries_().clear();
+      bytes_()=0;
+    } else
+      shrink(max_bytes);
+  }
+
+private:
+  struct entry {
+    std::shared_ptr<const void> kernel;
+    const std::type_info *type;
+    std::size_t bytes;
+  };
+
+  static std::mutex &mutex_() {
+    static std::mutex mutex;
+    return mutex;
+  }
+  static std::list<entry> &entries_() {
+    static std::list<entry> entries;
+    return entries;
+  }
+  static std::size_t &bytes_() {
+    static std::size_t bytes=0;
+    return bytes;
+  }
+  static std::size_t &max_bytes_() {
+    static std::size_t max_bytes=std::size_t(256)<<20;
+    return max_bytes;
+  }
 
-  std::vector<std::complex<double> > input_data(g_omega.mesh1().extent(), 0.);
-  std::vector<double >               output_data(g_tau.mesh1().extent(), 0.);
-
-  for(int i=0;i<g_omega.mesh2().extent();++i){
-    double c0=(g_omega.min_tail_order()==0 && g_omega.max_tail_order()>=0 )? g_omega.tail(0)(typename MESH1::index_type(i)):0;
-    double c1=(g_omega.min_tail_order()<=1 && g_omega.max_tail_order()>=1 )? g_omega.tail(1)(typename MESH1::index_type(i)):0;
-    double c2=(g_omega.min_tail_order()<=2 && g_omega.max_tail_order()>=2 )? g_omega.tail(2)(typename MESH1::index_type(i)):0;
-    double c3=(g_omega.min_tail_order()<=3 && g_omega.max_tail_order()>=3 )? g_omega.tail(3)(typename MESH1::index_type(i)):0;
-    if(c0 != 0) throw std::runtime_error("attempt to Fourier transform an object which goes to a constant. FT is ill defined");
-    for(int n=0;n<g_omega.mesh1().extent();++n){
-      input_data[n]=g_omega(matsubara_index(n),typename MESH1::index_type(i))-f_omega(g_omega.mesh1().points()[n],c1,c2,c3);
+  /// Cached kernel of type KERNEL for these arguments, moved to the front, or null; the lock must be held
+  template<class KERNEL, class... ARGS> static std::shared_ptr<const KERNEL> find(const ARGS &... args) {
+    std::list<entry> &entries=entries_();
+    for (std::list<entry>::iterator it=entries.begin(); it!=entries.end(); ++it) {
+      if (*it->type==typeid(KERNEL)) {
+        std::shared_ptr<const KERNEL> kernel=std::static_pointer_cast<const KERNEL>(it->kernel);
+        if (kernel->matches(args...)) {
+          // keep the most recently used kernel at the front
+          entries.splice(entries.begin(), entries, it);
+          return kernel;
+        }
+      }
     }
-    transform_vector_no_tail(input_data,g_omega.mesh1().points(), output_data, g_tau.mesh1().points(), g_tau.mesh1().beta());
-    for(int t=0;t<g_tau.mesh1().extent();++t){
-      g_tau(itime_index(t),typename MESH1::index_type(i))=output_data[t]+f_tau(g_tau.mesh1().points()[t],g_tau.mesh1().beta(),c1,c2,c3);
+    return std::shared_ptr<const KERNEL>();
+  }
+
+  /// Evicts the least recently used kernels until the cached kernels fit into max_bytes, but keeps the most recent one
+  static void shrink(std::size_t max_bytes) {
+    while (bytes_()>max_bytes && entries_().size()>1) {
+      bytes_()-=entries_().back().bytes;
+      entries_().pop_back();
     }
   }
-}
-///Fourier transform a three-index matsubara gf to an imag time gf
-template<class MESH1, class MESH2> void fourier_frequency_to_time(const three_index_gf_with_tail<
-    three_index_gf<std::complex<double>, matsubara_positive_mesh, MESH1,MESH2>, two_index_gf<double, MESH1,MESH2> > &g_omega,
-    three_index_gf_with_tail<three_index_gf<double, itime_mesh, MESH1,MESH2>, two_index_gf<double, MESH1,MESH2> > &g_tau){
+};
 
-  std::vector<std::complex<double> > input_data(g_omega.mesh1().extent(), 0.);
-  std::vector<double >               output_data(g_tau.mesh1().extent(), 0.);
-
-  for(int i=0;i<g_omega.mesh2().extent();++i){
-    for(int j=0;j<g_omega.mesh3().extent();++j){
-      double c0=(g_omega.min_tail_order()==0 && g_omega.max_tail_order()>=0 )? g_omega.tail(0)(typename MESH1::index_type(i),typename MESH2::index_type(j)):0;
-      double c1=(g_omega.min_tail_order()<=1 && g_omega.max_tail_order()>=1 )? g_omega.tail(1)(typename MESH1::index_type(i),typename MESH2::index_type(j)):0;
-      double c2=(g_omega.min_tail_order()<=2 && g_omega.max_tail_order()>=2 )? g_omega.tail(2)(typename MESH1::index_type(i),typename MESH2::index_type(j)):0;
-      double c3=(g_omega.min_tail_order()<=3 && g_omega.max_tail_order()>=3 )? g_omega.tail(3)(typename MESH1::index_type(i),typename MESH2::index_type(j)):0;
-      if(c0 != 0) throw std::runtime_error("attempt to Fourier transform an object which goes to a constant. FT is ill defined");
-      for(int n=0;n<g_omega.mesh1().extent();++n){
-        input_data[n]=g_omega(matsubara_index(n),typename MESH1::index_type(i),typename MESH2::index_type(j))-f_omega(g_omega.mesh1().points()[n],c1,c2,c3);
+/// Kernel of the omega -> tau transform, precomputed for a pair of meshes
+/**
+ * Holds the matrices K_cos(t,n)=2/beta cos(omega_n tau_t) and K_sin(t,n)=2/beta sin(omega_n tau_t),
+ * so that the transform of all inner indices of a Green's function is a pair of matrix-matrix
+ * products instead of recomputing the trigonometric functions for each inner index.
+ * The kernels of the most recently used meshes are cached, see kernel_cache.
+ */
+class fourier_kernel_frequency_to_time {
+public:
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+  typedef Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> complex_matrix_type;
+
+  fourier_kernel_frequency_to_time(const std::vector<double> &omega, const std::vector<double> &tau, double beta):
+    omega_(omega), tau_(tau), beta_(beta), cos_(tau.size(), omega.size()), sin_(tau.size(), omega.size())
+  {
+    for (unsigned int i=0; i<tau.size(); ++i) {
+      for (unsigned int k=0; k<omega.size(); ++k) {
+        double wt=omega[k]*tau[i];
+        cos_(i,k)=2/beta*cos(wt);
+        sin_(i,k)=2/beta*sin(wt);
       }
-      transform_vector_no_tail(input_data,g_omega.mesh1().points(), output_data, g_tau.mesh1().points(), g_tau.mesh1().beta());
-      for(int t=0;t<g_tau.mesh1().extent();++t){
-        g_tau(itime_index(t),typename MESH1::index_type(i),typename MESH2::index_type(j))=output_data[t]+f_tau(g_tau.mesh1().points()[t],g_tau.mesh1().beta(),c1,c2,c3);
+    }
+  }
+
+  /// Returns true if the kernel was computed for these frequencies, times and inverse temperature
+  bool matches(const std::vector<double> &omega, const std::vector<double> &tau, double beta) const {
+    return beta==beta_ && omega==omega_ && tau==tau_;
+  }
+
+  /// Size of the kernel in memory
+  std::size_t bytes() const {
+    return sizeof(double)*(cos_.size()+sin_.size()+omega_.size()+tau_.size());
+  }
+
+  /// Transforms the columns of `input` (frequency x inner index) to the columns of `output` (time x inner index)
+  template<typename DerivedIn, typename DerivedOut>
+  void apply(const Eigen::MatrixBase<DerivedIn> &input, const Eigen::MatrixBase<DerivedOut> &output) const {
+    if (input.rows()!=cos_.cols() || output.rows()!=cos_.rows() || input.cols()!=output.cols())
+      throw std::invalid_argument("Fourier kernel and data sizes do not match");
+    Eigen::MatrixBase<DerivedOut> &out=const_cast<Eigen::MatrixBase<DerivedOut>&>(output);
+    out.noalias() =cos_*input.real();
+    out.noalias()+=sin_*input.imag();
+  }
+
+  /// Returns the (cached) kernel for these frequencies, times and inverse temperature
+  static std::shared_ptr<const fourier_kernel_frequency_to_time> get(const std::vector<double> &omega, const std::vector<double> &tau, double beta) {
+    return kernel_cache::get<fourier_kernel_frequency_to_time>(omega, tau, beta);
+  }
+
+private:
+  std::vector<double> omega_;
+  std::vector<double> tau_;
+  double beta_;
+  matrix_type cos_;
+  matrix_type sin_;
+};
+
+namespace detail {
+  ///Reads the tail coefficients c0..c3 of each inner index of a gf with tail; throws if c0 is not zero
+  template<class GF> void tail_coefficients(const GF &g, std::size_t ninner, std::vector<double> (&c)[4]) {
+    for (int order=0; order<4; ++order) {
+      c[order].assign(ninner, 0.);
+      if (g.min_tail_order()<=order && g.max_tail_order()>=order) {
+        const double *tail=g.tail(order).data().data();
+        std::copy(tail, tail+ninner, c[order].begin());
       }
     }
+    for (std::size_t i=0; i<ninner; ++i)
+      if(c[0][i] != 0) throw std::runtime_error("attempt to Fourier transform an object which goes to a constant. FT is ill defined");
+  }
+
+  ///Fourier transform a matsubara gf with tail to an imag time gf, all inner indices at once
+  template<class GOMEGA, class GTAU> void fourier_frequency_to_time(const GOMEGA &g_omega, GTAU &g_tau) {
+    typedef fourier_kernel_frequency_to_time::complex_matrix_type complex_matrix_type;
+    typedef Eigen::Map<const complex_matrix_type> const_input_map;
+    typedef Eigen::Map<fourier_kernel_frequency_to_time::matrix_type> output_map;
+
+    const int nomega=g_omega.mesh1().extent();
+    const int ntau=g_tau.mesh1().extent();
+    const std::size_t ninner=g_omega.data().size()/nomega;
+    if (g_tau.data().size()/ntau != ninner)
+      throw std::invalid_argument("Fourier transform between Green's functions with different inner meshes");
+
+    // high-frequency tail coefficients of each inner index
+    std::vector<double> c[4];
+    tail_coefficients(g_omega, ninner, c);
+
+    const std::vector<double> &omega=g_omega.mesh1().points();
+    const std::vector<double> &tau=g_tau.mesh1().points();
+    const double beta=g_tau.mesh1().beta();
+
+    complex_matrix_type input=const_input_map(g_omega.data().data(), nomega, ninner);
+    for (int n=0; n<nomega; ++n)
+      for (std::size_t i=0; i<ninner; ++i)
+        input(n,i)-=f_omega(omega[n],c[1][i],c[2][i],c[3][i]);
+
+    output_map output(g_tau.data().data(), ntau, ninner);
+    fourier_kernel_frequency_to_time::get(omega, tau, beta)->apply(input, output);
+
+    for (int t=0; t<ntau; ++t)
+      for (std::size_t i=0; i<ninner; ++i)
+        output(t,i)+=f_tau(tau[t],beta,c[1][i],c[2][i],c[3][i]);
   }
 }
+
+///Fourier transform a two-index matsubara gf to an imag time gf
+template<class MESH1> void fourier_frequency_to_time(const two_index_gf_with_tail<
+    two_index_gf<std::complex<double>, matsubara_positive_mesh, MESH1>, one_index_gf<double, MESH1> > &g_omega,
+    two_index_gf_with_tail<two_index_gf<double, itime_mesh, MESH1>, one_index_gf<double, MESH1> > &g_tau){
+  detail::fourier_frequency_to_time(g_omega, g_tau);
+}
+///Fourier transform a three-index matsubara gf to an imag time gf
+template<class MESH1, class MESH2> void fourier_frequency_to_time(const three_index_gf_with_tail<
+    three_index_gf<std::complex<double>, matsubara_positive_mesh, MESH1,MESH2>, two_index_gf<double, MESH1,MESH2> > &g_omega,
+    three_index_gf_with_tail<three_index_gf<double, itime_mesh, MESH1,MESH2>, two_index_gf<double, MESH1,MESH2> > &g_tau){
+  detail::fourier_frequency_to_time(g_omega, g_tau);
+}
 ///Fourier transform a four-index matsubara gf to an imag time gf
 template<class MESH1, class MESH2, class MESH3> void fourier_frequency_to_time(const four_index_gf_with_tail<
     four_index_gf<std::complex<double>, matsubara_positive_mesh, MESH1,MESH2,MESH3>, three_index_gf<double, MESH1,MESH2,MESH3> > &g_omega,
     four_index_gf_with_tail<four_index_gf<double, itime_mesh, MESH1,MESH2,MESH3>, three_index_gf<double, MESH1,MESH2,MESH3> > &g_tau){
-
-  std::vector<std::complex<double> > input_data(g_omega.mesh1().extent(), 0.);
-  std::vector<double >               output_data(g_tau.mesh1().extent(), 0.);
-
-  for(int i=0;i<g_omega.mesh2().extent();++i){
-    for(int j=0;j<g_omega.mesh3().extent();++j){
-      for(int k=0;k<g_omega.mesh4().extent();++k){
-        double c0=(g_omega.min_tail_order()==0 && g_omega.max_tail_order()>=0 )? g_omega.tail(0)(typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k)):0;
-        double c1=(g_omega.min_tail_order()<=1 && g_omega.max_tail_order()>=1 )? g_omega.tail(1)(typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k)):0;
-        double c2=(g_omega.min_tail_order()<=2 && g_omega.max_tail_order()>=2 )? g_omega.tail(2)(typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k)):0;
-        double c3=(g_omega.min_tail_order()<=3 && g_omega.max_tail_order()>=3 )? g_omega.tail(3)(typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k)):0;
-        if(c0 != 0) throw std::runtime_error("attempt to Fourier transform an object which goes to a constant. FT is ill defined");
-        for(int n=0;n<g_omega.mesh1().extent();++n){
-          input_data[n]=g_omega(matsubara_index(n),typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k))-f_omega(g_omega.mesh1().points()[n],c1,c2,c3);
-        }
-        transform_vector_no_tail(input_data,g_omega.mesh1().points(), output_data, g_tau.mesh1().points(), g_tau.mesh1().beta());
-        for(int t=0;t<g_tau.mesh1().extent();++t){
-          g_tau(itime_index(t),typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k))=output_data[t]+f_tau(g_tau.mesh1().points()[t],g_tau.mesh1().beta(),c1,c2,c3);
-        }
-      }
-    }
-  }
+  detail::fourier_frequency_to_time(g_omega, g_tau);
 }
 ///Fourier transform a five-index matsubara gf to an imag time gf
 template<class MESH1, class MESH2, class MESH3,class MESH4> void fourier_frequency_to_time(const five_index_gf_with_tail<
     five_index_gf<std::complex<double>, matsubara_positive_mesh, MESH1,MESH2,MESH3,MESH4>, four_index_gf<double, MESH1,MESH2,MESH3,MESH4> > &g_omega,
     five_index_gf_with_tail<five_index_gf<double, itime_mesh, MESH1,MESH2,MESH3,MESH4>, four_index_gf<double, MESH1,MESH2,MESH3,MESH4> > &g_tau){
+  detail::fourier_frequency_to_time(g_omega, g_tau);
+}
 
-  std::vector<std::complex<double> > input_data(g_omega.mesh1().extent(), 0.);
-  std::vector<double >               output_data(g_tau.mesh1().extent(), 0.);
-
-  for(int i=0;i<g_omega.mesh2().extent();++i){
-    for(int j=0;j<g_omega.mesh3().extent();++j){
-      for(int k=0;k<g_omega.mesh4().extent();++k){
-        for(int l=0;l<g_omega.mesh5().extent();++l){
-        double c0=(g_omega.min_tail_order()==0 && g_omega.max_tail_order()>=0 )? g_omega.tail(0)(typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k),typename MESH4::index_type(l)):0;
-        double c1=(g_omega.min_tail_order()<=1 && g_omega.max_tail_order()>=1 )? g_omega.tail(1)(typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k),typename MESH4::index_type(l)):0;
-        double c2=(g_omega.min_tail_order()<=2 && g_omega.max_tail_order()>=2 )? g_omega.tail(2)(typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k),typename MESH4::index_type(l)):0;
-        double c3=(g_omega.min_tail_order()<=3 && g_omega.max_tail_order()>=3 )? g_omega.tail(3)(typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k),typename MESH4::index_type(l)):0;
-        if(c0 != 0) throw std::runtime_error("attempt to Fourier transform an object which goes to a constant. FT is ill defined");
-        for(int n=0;n<g_omega.mesh1().extent();++n){
-          input_data[n]=g_omega(matsubara_index(n),typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k),typename MESH4::index_type(l))-f_omega(g_omega.mesh1().points()[n],c1,c2,c3);
-        }
-        transform_vector_no_tail(input_data,g_omega.mesh1().points(), output_data, g_tau.mesh1().points(), g_tau.mesh1().beta());
-        for(int t=0;t<g_tau.mesh1().extent();++t){
-          g_tau(itime_index(t),typename MESH1::index_type(i),typename MESH2::index_type(j),typename MESH3::index_type(k),typename MESH4::index_type(l))=output_data[t]+f_tau(g_tau.mesh1().points()[t],g_tau.mesh1().beta(),c1,c2,c3);
-        }
+
+namespace detail {
+  template<class MESH> struct is_matsubara_mesh: public std::false_type {};
+  template<mesh::frequency_positivity_type PTYPE> struct is_matsubara_mesh<matsubara_mesh<PTYPE> >: public std::true_type {};
+
+  template<class GF> struct first_mesh {
+    typedef typename std::tuple_element<0, typename GF::mesh_types>::type type;
+  };
+
+  ///Number of intervals of an imaginary time mesh including both 0 and beta
+  inline std::size_t fft_itime_intervals(const itime_mesh &mesh) {
+    const std::vector<double> &tau=mesh.points();
+    if (tau.size()<2 || tau.front()!=0. || std::abs(tau.back()-mesh.beta())>1e-12*mesh.beta())
+      throw std::invalid_argument("FFT needs a uniform imaginary time mesh including both 0 and beta");
+    return tau.size()-1;
+  }
+
+  ///Index n of the fermionic frequencies omega_n=(2n+1)pi/beta of a Matsubara mesh
+  template<class MESH> std::vector<long> fft_matsubara_indices(const MESH &mesh) {
+    if (mesh.statistics()!=statistics::FERMIONIC)
+      throw std::invalid_argument("FFT is only implemented for fermionic Matsubara meshes");
+    std::vector<long> n(mesh.extent());
+    for (int i=0; i<mesh.extent(); ++i) n[i]=std::lround((mesh.points()[i]*mesh.beta()/M_PI-1)/2);
+    return n;
+  }
+
+  ///Position of the frequency index n in a sequence folded with period N
+  inline std::size_t fft_fold(long n, std::size_t nint) {
+    long m=n%long(nint);
+    return m<0 ? m+nint : m;
+  }
+
+  inline void fft_assign(double &dest, const std::complex<double> &value) { dest=value.real(); }
+  inline void fft_assign(std::complex<double> &dest, const std::complex<double> &value) { dest=value; }
+}
+
+///Fourier transform a matsubara gf with tail to an imag time gf by FFT
+/**
+ * Both Green's functions may have any number of trailing meshes, which are transformed together.
+ * The Matsubara mesh must be fermionic, and the imaginary time mesh uniform including 0 and beta
+ * (as constructed by `itime_mesh(beta, ntau)`). The high-frequency tail c1..c3 is subtracted
+ * before and added back after the transform, as in fourier_frequency_to_time().
+ *
+ * A mesh with positive frequencies only stands for G(-i omega_n)=G(i omega_n)^*, so G(tau) is real;
+ * with a mesh of positive and negative frequencies, the real part is taken for a real G(tau).
+ * The cost is O(N_tau log N_tau) per trailing index, plus O(N_omega) for the frequencies.
+ */
+template<class GOMEGA, class GTAU> void fourier_frequency_to_time_fft(const GOMEGA &g_omega, GTAU &g_tau) {
+  static_assert(detail::is_matsubara_mesh<typename detail::first_mesh<GOMEGA>::type>::value, "The gf to transform must have a Matsubara mesh first");
+  static_assert(std::is_same<typename detail::first_mesh<GTAU>::type, itime_mesh>::value, "The transformed gf must have an imaginary time mesh first");
+  typedef std::complex<double> complex_type;
+
+  const std::size_t nomega=g_omega.mesh1().extent();
+  const std::size_t ntau=g_tau.mesh1().extent();
+  const std::size_t ninner=g_omega.data().size()/nomega;
+  if (g_tau.data().size()/ntau != ninner)
+    throw std::invalid_argument("Fourier transform between Green's functions with different inner meshes");
+  if (g_omega.mesh1().beta()!=g_tau.mesh1().beta())
+    throw std::invalid_argument("Fourier transform between Green's functions with different beta");
+
+  const std::size_t nint=detail::fft_itime_intervals(g_tau.mesh1());
+  const std::vector<long> index=detail::fft_matsubara_indices(g_omega.mesh1());
+  const std::vector<double> &omega=g_omega.mesh1().points();
+  const std::vector<double> &tau=g_tau.mesh1().points();
+  const double beta=g_tau.mesh1().beta();
+
+  std::vector<double> c[4];
+  detail::tail_coefficients(g_omega, ninner, c);
+
+  // exp(-i omega_n tau_t)=exp(-i pi t/N) exp(-2 pi i n t/N): fold the frequencies modulo N
+  std::vector<complex_type> folded(nint*ninner, 0.), transformed(nint*ninner);
+  const complex_type *g=g_omega.data().data();
+  for (std::size_t k=0; k<nomega; ++k) {
+    complex_type *dest=&folded[detail::fft_fold(index[k], nint)*ninner];
+    for (std::size_t i=0; i<ninner; ++i)
+      dest[i]+=g[k*ninner+i]-f_omega(omega[k],c[1][i],c[2][i],c[3][i]);
+  }
+  fft_plan::get(nint)->forward(folded.data(), transformed.data(), ninner);
+
+  const bool positive_only=(g_omega.mesh1().positivity()==mesh::POSITIVE_ONLY);
+  typename GTAU::value_type *out=g_tau.data().data();
+  for (std::size_t t=0; t<ntau; ++t) {
+    const complex_type phase=std::polar((positive_only ? 2. : 1.)/beta, -M_PI*double(t)/double(nint));
+    const complex_type *src=&transformed[(t%nint)*ninner];
+    for (std::size_t i=0; i<ninner; ++i) {
+      complex_type value=phase*src[i];
+      if (positive_only) value=value.real();
+      detail::fft_assign(out[t*ninner+i], value+f_tau(tau[t],beta,c[1][i],c[2][i],c[3][i]));
+    }
+  }
+}
+
+///Fourier transform an imag time gf with tail to a matsubara gf by FFT
+/**
+ * The inverse of fourier_frequency_to_time_fft(), with the same requirements on the meshes.
+ * The tail c1..c3 of G(tau) is subtracted, and the smooth remainder is integrated by the
+ * trapezoidal rule, which converges fast for the antiperiodic remainder. The frequencies
+ * alias with period N_tau-1, so the result is accurate only for |n| much smaller than N_tau;
+ * frequencies that alias to each other throw.
+ */
+template<class GTAU, class GOMEGA> void fourier_time_to_frequency_fft(const GTAU &g_tau, GOMEGA &g_omega) {
+  static_assert(std::is_same<typename detail::first_mesh<GTAU>::type, itime_mesh>::value, "The gf to transform must have an imaginary time mesh first");
+  static_assert(detail::is_matsubara_mesh<typename detail::first_mesh<GOMEGA>::type>::value, "The transformed gf must have a Matsubara mesh first");
+  typedef std::complex<double> complex_type;
+
+  const std::size_t nomega=g_omega.mesh1().extent();
+  const std::size_t ntau=g_tau.mesh1().extent();
+  const std::size_t ninner=g_tau.data().size()/ntau;
+  if (g_omega.data().size()/nomega != ninner)
+    throw std::invalid_argument("Fourier transform between Green's functions with different inner meshes");
+  if (g_omega.mesh1().beta()!=g_tau.mesh1().beta())
+    throw std::invalid_argument("Fourier transform between Green's functions with different beta");
+
+  const std::size_t nint=detail::fft_itime_intervals(g_tau.mesh1());
+  const std::vector<long> index=detail::fft_matsubara_indices(g_omega.mesh1());
+  if (nomega>0 && std::size_t(*std::max_element(index.begin(), index.end())-*std::min_element(index.begin(), index.end()))>=nint)
+    throw std::invalid_argument("FFT needs more imaginary time intervals than Matsubara frequencies");
+  const std::vector<double> &omega=g_omega.mesh1().points();
+  const std::vector<double> &tau=g_tau.mesh1().points();
+  const double beta=g_tau.mesh1().beta();
+  const double dtau=beta/nint;
+
+  std::vector<double> c[4];
+  detail::tail_coefficients(g_tau, ninner, c);
+
+  // exp(i omega_n tau_t)=exp(i pi t/N) exp(2 pi i n t/N): the point tau=beta folds onto tau=0
+  std::vector<complex_type> folded(nint*ninner, 0.), transformed(nint*ninner);
+  const typename GTAU::value_type *g=g_tau.data().data();
+  for (std::size_t t=0; t<ntau; ++t) {
+    const double weight=(t==0 || t==nint) ? 0.5*dtau : dtau;
+    const complex_type phase=std::polar(weight, M_PI*double(t)/double(nint));
+    complex_type *dest=&folded[(t%nint)*ninner];
+    for (std::size_t i=0; i<ninner; ++i)
+      dest[i]+=phase*(complex_type(g[t*ninner+i])-f_tau(tau[t],beta,c[1][i],c[2][i],c[3][i]));
+  }
+  fft_plan::get(nint)->backward(folded.data(), transformed.data(), ninner);
+
+  complex_type *out=g_omega.data().data();
+  for (std::size_t k=0; k<nomega; ++k) {
+    const complex_type *src=&transformed[detail::fft_fold(index[k], nint)*ninner];
+    for (std::size_t i=0; i<ninner; ++i)
+      out[k*ninner+i]=src[i]+f_omega(omega[k],c[1][i],c[2][i],c[3][i]);
+  }
+}
+
+
+namespace detail {
+  ///Tail coefficients of a gf with tail
+  template<class HEADGF, class TAILGF> void tail_coefficients_if_any(const gf_tail_base<HEADGF, TAILGF> &g, std::size_t ninner, std::vector<double> (&c)[4]) {
+    tail_coefficients(g, ninner, c);
+  }
+
+  ///A gf without tail has no tail coefficients
+  template<class VTYPE, class STORAGE, class... MESHES> void tail_coefficients_if_any(const gf_base<VTYPE, STORAGE, MESHES...> &, std::size_t ninner, std::vector<double> (&c)[4]) {
+    for (int order=0; order<4; ++order) c[order].assign(ninner, 0.);
+  }
+
+  ///Integrals I_l=\int_0^d u^l exp(i w u) du for l=0..order
+  /**
+   * With a=w d, I_l=d^(l+1) J_l for J_l=\int_0^1 t^l exp(i a t) dt, which obey
+   * J_l=(exp(i a)-l J_(l-1))/(i a). The recursion is stable upwards for l<=|a| and downwards
+   * above, where it is started far enough from `order` for the start value not to matter.
+   */
+  inline void fourier_monomial_integrals(double w, double d, int order, std::complex<double> *integrals) {
+    const double a=w*d;
+    const std::complex<double> ia(0., a), e=std::exp(ia);
+    // J_0..J_nup upwards, J_(nup+1)..J_order downwards
+    const int nup=std::abs(a)<1. ? -1 : std::min(int(std::abs(a)), order);
+    if (nup>=0) {
+      integrals[0]=(e-1.)/ia;
+      for (int l=1; l<=nup; ++l) integrals[l]=(e-double(l)*integrals[l-1])/ia;
+    }
+    std::complex<double> j=0.;
+    for (int l=order+int(2*std::abs(a))+40; nup<order && l>nup+1; --l) {
+      j=(e-ia*j)/double(l);
+      if (l<=order+1) integrals[l-1]=j;
+    }
+    double power=d;
+    for (int l=0; l<=order; ++l, power*=d) integrals[l]*=power;
+  }
+
+  ///Integrals I_l=\int_0^d u^l exp(i w u) du for l=0..3
+  inline void fourier_monomial_integrals(double w, double d, std::complex<double> (&integrals)[4]) {
+    fourier_monomial_integrals(w, d, 3, integrals);
+  }
+
+  ///Coefficients of the not-a-knot cubic splines through the columns of y
+  /**
+   * On section s, the spline of column i is \sum_{l=0}^3 a(l*nsec+s, i) (x-x_s)^l,
+   * the representation also used by piecewise_polynomial. Needs at least 4 points.
+   */
+  template<typename T> Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+  cubic_spline_coefficients(const std::vector<double> &x, const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> &y) {
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+    const std::size_t nsec=x.size()-1;
+    if (x.size()<4) throw std::invalid_argument("A cubic spline needs at least 4 points");
+    std::vector<double> h(nsec);
+    for (std::size_t s=0; s<nsec; ++s) h[s]=x[s+1]-x[s];
+
+    // tridiagonal system for the second derivatives m_1..m_{nsec-1}, with m_0 and m_nsec
+    // eliminated by the not-a-knot conditions (continuous third derivative at x_1 and x_{nsec-1})
+    matrix_type m=matrix_type::Zero(nsec+1, y.cols());
+    std::vector<double> sub(nsec), diag(nsec), sup(nsec);
+    for (std::size_t i=1; i<nsec; ++i) {
+      sub[i]=h[i-1];
+      diag[i]=2*(h[i-1]+h[i]);
+      sup[i]=h[i];
+      m.row(i)=6.*((y.row(i+1)-y.row(i))/h[i]-(y.row(i)-y.row(i-1))/h[i-1]);
+    }
+    diag[1]+=h[0]*(h[0]+h[1])/h[1];
+    sup[1]-=h[0]*h[0]/h[1];
+    diag[nsec-1]+=h[nsec-1]*(h[nsec-2]+h[nsec-1])/h[nsec-2];
+    sub[nsec-1]-=h[nsec-1]*h[nsec-1]/h[nsec-2];
+    for (std::size_t i=2; i<nsec; ++i) {
+      double factor=sub[i]/diag[i-1];
+      diag[i]-=factor*sup[i-1];
+      m.row(i)-=factor*m.row(i-1);
+    }
+    m.row(nsec-1)/=diag[nsec-1];
+    for (std::size_t i=nsec-2; i>=1; --i) m.row(i)=(m.row(i)-sup[i]*m.row(i+1))/diag[i];
+    m.row(0)=((h[0]+h[1])*m.row(1)-h[0]*m.row(2))/h[1];
+    m.row(nsec)=((h[nsec-2]+h[nsec-1])*m.row(nsec-1)-h[nsec-1]*m.row(nsec-2))/h[nsec-2];
+
+    matrix_type a(4*nsec, y.cols());
+    for (std::size_t s=0; s<nsec; ++s) {
+      a.row(s)=y.row(s);
+      a.row(nsec+s)=(y.row(s+1)-y.row(s))/h[s]-h[s]*(2.*m.row(s)+m.row(s+1))/6.;
+      a.row(2*nsec+s)=m.row(s)/2.;
+      a.row(3*nsec+s)=(m.row(s+1)-m.row(s))/(6.*h[s]);
+    }
+    return a;
+  }
+}
+
+/// Kernel of the tau -> omega transform of cubic splines, precomputed for a pair of meshes
+/**
+ * Holds the matrix K(n,l*nsec+s)=exp(i omega_n tau_s) \int_0^{h_s} u^l exp(i omega_n u) du for the
+ * nsec=N_tau-1 sections of length h_s=tau_{s+1}-tau_s, so that the transform of the spline coefficients
+ * of all inner indices (see detail::cubic_spline_coefficients()) is one matrix-matrix product.
+ * The kernels of the most recently used meshes are cached, see kernel_cache.
+ */
+class fourier_kernel_time_to_frequency {
+public:
+  typedef Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> complex_matrix_type;
+
+  fourier_kernel_time_to_frequency(const std::vector<double> &tau, const std::vector<double> &omega):
+    tau_(tau), omega_(omega), k_(omega.size(), 4*(tau.size()-1))
+  {
+    if (tau.size()<2) throw std::invalid_argument("The imaginary time mesh needs at least 2 points");
+    const std::size_t nsec=tau.size()-1;
+    numerics::detail::parallel_chunks(omega.size(), omega.size()*nsec, [&](std::size_t first, std::size_t last) {
+      std::complex<double> integrals[4];
+      for (std::size_t n=first; n<last; ++n) {
+        for (std::size_t s=0; s<nsec; ++s) {
+          detail::fourier_monomial_integrals(omega[n], tau[s+1]-tau[s], integrals);
+          const std::complex<double> phase=std::polar(1., omega[n]*tau[s]);
+          for (int l=0; l<4; ++l) k_(n, l*nsec+s)=phase*integrals[l];
         }
       }
+    });
+  }
+
+  /// Returns true if the kernel was computed for these times and frequencies
+  bool matches(const std::vector<double> &tau, const std::vector<double> &omega) const {
+    return tau==tau_ && omega==omega_;
+  }
+
+  /// Size of the kernel in memory
+  std::size_t bytes() const {
+    return sizeof(std::complex<double>)*k_.size()+sizeof(double)*(tau_.size()+omega_.size());
+  }
+
+  /// The matrix K(n,l*nsec+s)
+  const complex_matrix_type &matrix() const { return k_; }
+
+  /// Returns the (cached) kernel for these times and frequencies
+  static std::shared_ptr<const fourier_kernel_time_to_frequency> get(const std::vector<double> &tau, const std::vector<double> &omega) {
+    return kernel_cache::get<fourier_kernel_time_to_frequency>(tau, omega);
+  }
+
+private:
+  std::vector<double> tau_;
+  std::vector<double> omega_;
+  complex_matrix_type k_;
+};
+
+///Fourier transform an imag time gf to a matsubara gf, with any number of trailing meshes
+/**
+ * G(i omega_n)=\int_0^beta exp(i omega_n tau) G(tau) dtau, where G(tau) is interpolated by a
+ * not-a-knot cubic spline between the points of the (not necessarily uniform) imaginary time
+ * mesh, and the integral over each spline section is done exactly. If G(tau) has a tail, the
+ * tail c1..c3 is subtracted from G(tau) before, and added to G(i omega_n) after the transform.
+ *
+ * The (cached) matrix of fourier_kernel_time_to_frequency is applied to the spline coefficients
+ * of all trailing indices by matrix-matrix products. The trailing indices are split among threads
+ * according to numerics::tensor_parallel_policy.
+ */
+template<class GTAU, class GOMEGA> void fourier_time_to_frequency(const GTAU &g_tau, GOMEGA &g_omega) {
+  static_assert(std::is_same<typename detail::first_mesh<GTAU>::type, itime_mesh>::value, "The gf to transform must have an imaginary time mesh first");
+  static_assert(detail::is_matsubara_mesh<typename detail::first_mesh<GOMEGA>::type>::value, "The transformed gf must have a Matsubara mesh first");
+  typedef typename GTAU::value_type value_type;
+  typedef std::complex<double> complex_type;
+  typedef Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+  typedef fourier_kernel_time_to_frequency::complex_matrix_type complex_matrix_type;
+
+  const std::size_t nomega=g_omega.mesh1().extent();
+  const std::size_t ntau=g_tau.mesh1().extent();
+  const std::size_t ninner=g_tau.data().size()/ntau;
+  if (g_omega.data().size()/nomega != ninner)
+    throw std::invalid_argument("Fourier transform between Green's functions with different inner meshes");
+  if (g_omega.mesh1().beta()!=g_tau.mesh1().beta())
+    throw std::invalid_argument("Fourier transform between Green's functions with different beta");
+  if (g_omega.mesh1().statistics()!=statistics::FERMIONIC)
+    throw std::invalid_argument("Fourier transform to bosonic Matsubara frequencies is not implemented");
+
+  const std::vector<double> &omega=g_omega.mesh1().points();
+  const std::vector<double> &tau=g_tau.mesh1().points();
+  const double beta=g_tau.mesh1().beta();
+
+  std::vector<double> c[4];
+  detail::tail_coefficients_if_any(g_tau, ninner, c);
+
+  matrix_type y=Eigen::Map<const matrix_type>(g_tau.data().data(), ntau, ninner);
+  for (std::size_t t=0; t<ntau; ++t)
+    for (std::size_t i=0; i<ninner; ++i)
+      y(t,i)-=f_tau(tau[t],beta,c[1][i],c[2][i],c[3][i]);
+  const complex_matrix_type a=detail::cubic_spline_coefficients(tau, y).template cast<complex_type>();
+  const std::shared_ptr<const fourier_kernel_time_to_frequency> kernel=fourier_kernel_time_to_frequency::get(tau, omega);
+
+  // the kernel is shared by the threads, each of which transforms a block of trailing indices
+  Eigen::Map<complex_matrix_type> out(g_omega.data().data(), nomega, ninner);
+  numerics::detail::parallel_chunks(ninner, nomega*a.size(), [&](std::size_t first, std::size_t last) {
+    out.middleCols(first, last-first).noalias()=kernel->matrix()*a.middleCols(first, last-first);
+    for (std::size_t n=0; n<nomega; ++n)
+      for (std::size_t i=first; i<last; ++i)
+        out(n,i)+=f_omega(omega[n],c[1][i],c[2][i],c[3][i]);
+  });
+}
+
+/// Kernel of the Legendre -> Matsubara transform, precomputed for a Legendre mesh and a set of frequencies
+/**
+ * Holds the matrix T(n,l)=sqrt(2l+1) i^l exp(i omega_n beta/2) j_l(omega_n beta/2), with the
+ * spherical Bessel functions j_l, so that G(i omega_n)=sum_l T(n,l) G_l for all inner indices
+ * is one matrix-matrix product. For fermionic frequencies, T(n,l) reduces to
+ * (-1)^n i^(l+1) sqrt(2l+1) j_l((2n+1)pi/2). The kernels of the most recently used meshes are cached, see kernel_cache.
+ */
+class legendre_kernel_to_frequency {
+public:
+  typedef Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> complex_matrix_type;
+
+  legendre_kernel_to_frequency(double beta, int nl, const std::vector<double> &omega):
+    beta_(beta), nl_(nl), omega_(omega), t_(omega.size(), nl)
+  {
+    for (unsigned int k=0; k<omega.size(); ++k) {
+      const double x=0.5*omega[k]*beta;
+      const std::complex<double> phase=std::polar(1., x);
+      std::complex<double> il(1.);
+      for (int l=0; l<nl; ++l) {
+        // j_l(-x)=(-1)^l j_l(x)
+        const double jl=boost::math::sph_bessel(l, std::abs(x))*((x<0 && l%2) ? -1. : 1.);
+        t_(k,l)=std::sqrt(2.*l+1.)*il*phase*jl;
+        il*=std::complex<double>(0., 1.);
+      }
+    }
+  }
+
+  /// Returns true if the kernel was computed for these inverse temperature, number of polynomials and frequencies
+  bool matches(double beta, int nl, const std::vector<double> &omega) const {
+    return beta==beta_ && nl==nl_ && omega==omega_;
+  }
+
+  /// Size of the kernel in memory
+  std::size_t bytes() const {
+    return sizeof(std::complex<double>)*t_.size()+sizeof(double)*omega_.size();
+  }
+
+  /// The matrix T(n,l)
+  const complex_matrix_type &matrix() const { return t_; }
+
+  /// Returns the (cached) kernel for these inverse temperature, number of polynomials and frequencies
+  static std::shared_ptr<const legendre_kernel_to_frequency> get(double beta, int nl, const std::vector<double> &omega) {
+    return kernel_cache::get<legendre_kernel_to_frequency>(beta, nl, omega);
+  }
+
+private:
+  double beta_;
+  int nl_;
+  std::vector<double> omega_;
+  complex_matrix_type t_;
+};
+
+/// Kernel of the Legendre -> tau transform, precomputed for a Legendre mesh and a set of times
+/**
+ * Holds the matrix P(t,l)=sqrt(2l+1)/beta P_l(2 tau_t/beta-1), with the Legendre polynomials P_l,
+ * so that G(tau_t)=sum_l P(t,l) G_l for all inner indices is one matrix-matrix product.
+ * The kernels of the most recently used meshes are cached, see kernel_cache.
+ */
+class legendre_kernel_to_time {
+public:
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+
+  legendre_kernel_to_time(double beta, int nl, const std::vector<double> &tau):
+    beta_(beta), nl_(nl), tau_(tau), p_(tau.size(), nl)
+  {
+    for (unsigned int t=0; t<tau.size(); ++t) {
+      const double x=2*tau[t]/beta-1;
+      // (l+1) P_{l+1}(x)=(2l+1) x P_l(x)-l P_{l-1}(x)
+      double p0=1., p1=x;
+      for (int l=0; l<nl; ++l) {
+        p_(t,l)=std::sqrt(2.*l+1.)/beta*p0;
+        const double p2=((2*l+3)*x*p1-(l+1)*p0)/(l+2);
+        p0=p1;
+        p1=p2;
+      }
     }
   }
+
+  /// Returns true if the kernel was computed for these inverse temperature, number of polynomials and times
+  bool matches(double beta, int nl, const std::vector<double> &tau) const {
+    return beta==beta_ && nl==nl_ && tau==tau_;
+  }
+
+  /// Size of the kernel in memory
+  std::size_t bytes() const {
+    return sizeof(double)*(p_.size()+tau_.size());
+  }
+
+  /// The matrix P(t,l)
+  const matrix_type &matrix() const { return p_; }
+
+  /// Returns the (cached) kernel for these inverse temperature, number of polynomials and times
+  static std::shared_ptr<const legendre_kernel_to_time> get(double beta, int nl, const std::vector<double> &tau) {
+    return kernel_cache::get<legendre_kernel_to_time>(beta, nl, tau);
+  }
+
+private:
+  double beta_;
+  int nl_;
+  std::vector<double> tau_;
+  matrix_type p_;
+};
+
+namespace detail {
+  template<class GL, class GOUT> std::size_t legendre_inner_size(const GL &g_l, const GOUT &g_out) {
+    static_assert(std::is_same<typename first_mesh<GL>::type, legendre_mesh>::value, "The gf to transform must have a Legendre mesh first");
+    const std::size_t ninner=g_l.data().size()/g_l.mesh1().extent();
+    if (g_out.data().size()/g_out.mesh1().extent() != ninner)
+      throw std::invalid_argument("Legendre transform between Green's functions with different inner meshes");
+    if (g_l.mesh1().beta()!=g_out.mesh1().beta())
+      throw std::invalid_argument("Legendre transform between Green's functions with different beta");
+    return ninner;
+  }
+}
+
+///Transform a Legendre gf to a matsubara gf
+/**
+ * Both Green's functions may have any number of trailing meshes, which are transformed together
+ * by one product with the (cached) matrix of legendre_kernel_to_frequency.
+ */
+template<class GL, class GOMEGA> void legendre_to_frequency(const GL &g_l, GOMEGA &g_omega) {
+  static_assert(detail::is_matsubara_mesh<typename detail::first_mesh<GOMEGA>::type>::value, "The transformed gf must have a Matsubara mesh first");
+  typedef std::complex<double> complex_type;
+  typedef Eigen::Matrix<typename GL::value_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+  typedef Eigen::Matrix<complex_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> complex_matrix_type;
+
+  const std::size_t ninner=detail::legendre_inner_size(g_l, g_omega);
+  if (g_l.mesh1().statistics()!=g_omega.mesh1().statistics())
+    throw std::invalid_argument("Legendre transform between Green's functions with different statistics");
+  const int nl=g_l.mesh1().extent();
+  const std::shared_ptr<const legendre_kernel_to_frequency> kernel=legendre_kernel_to_frequency::get(g_l.mesh1().beta(), nl, g_omega.mesh1().points());
+
+  Eigen::Map<const matrix_type> in(g_l.data().data(), nl, ninner);
+  Eigen::Map<complex_matrix_type> out(g_omega.data().data(), g_omega.mesh1().extent(), ninner);
+  out.noalias()=kernel->matrix()*in.template cast<complex_type>();
+}
+
+///Transform a Legendre gf to an imag time gf
+/**
+ * Both Green's functions may have any number of trailing meshes, which are transformed together
+ * by one product with the (cached) matrix of legendre_kernel_to_time.
+ */
+template<class GL, class GTAU> void legendre_to_time(const GL &g_l, GTAU &g_tau) {
+  static_assert(std::is_same<typename detail::first_mesh<GTAU>::type, itime_mesh>::value, "The transformed gf must have an imaginary time mesh first");
+  static_assert(std::is_same<typename GL::value_type, typename GTAU::value_type>::value
+                || std::is_same<typename GTAU::value_type, std::complex<double> >::value, "A complex Legendre gf needs a complex imaginary time gf");
+  typedef Eigen::Matrix<typename GL::value_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+  typedef Eigen::Matrix<typename GTAU::value_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> out_matrix_type;
+
+  const std::size_t ninner=detail::legendre_inner_size(g_l, g_tau);
+  const int nl=g_l.mesh1().extent();
+  const std::shared_ptr<const legendre_kernel_to_time> kernel=legendre_kernel_to_time::get(g_l.mesh1().beta(), nl, g_tau.mesh1().points());
+
+  Eigen::Map<const matrix_type> in(g_l.data().data(), nl, ninner);
+  Eigen::Map<out_matrix_type> out(g_tau.data().data(), g_tau.mesh1().extent(), ninner);
+  out.noalias()=(kernel->matrix().template cast<typename GL::value_type>()*in).template cast<typename GTAU::value_type>();
 }
 
 }
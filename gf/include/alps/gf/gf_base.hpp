@@ -8,6 +8,7 @@
 #define ALPSCORE_GF_H
 
 
+#include <limits>
 #include <tuple>
 #include <vector>
 
@@ -20,6 +21,7 @@
 #include <alps/utilities/mpi.hpp>
 #endif
 
+#include <alps/gf/gf_expression.hpp>
 #include <alps/gf/mesh.hpp>
 #include <alps/numeric/tensors/tensor_base.hpp>
 #include <alps/type_traits/index_sequence.hpp>
@@ -177,6 +179,8 @@ namespace alps {
         gf_base(data_storage const &data, MESHES...meshes) : data_(data), meshes_(std::make_tuple(meshes...)), empty_(false) {}
         /// Create GF with the provided data and meshes
         gf_base(data_storage && data, MESHES...meshes) : data_(std::move(data)), meshes_(std::make_tuple(meshes...)), empty_(false) {}
+        /// Create GF with the provided data and tuple of meshes
+        gf_base(data_storage && data, const mesh_types &meshes) : data_(std::move(data)), meshes_(meshes), empty_(false) {}
 
         /// construct new GF object by copy data from another GF object defined with different storage type
         template<typename St, typename = std::enable_if<!std::is_same<St, Storage>::value && std::is_same<St, data_view>::value > >
@@ -222,6 +226,31 @@ namespace alps {
           return *this;
         }
 
+        /**
+         * Create Green's function with the values of a lazy expression, evaluated in a single pass
+         *
+         * @tparam E - type of the expression, see gf_expression.hpp
+         */
+        template<class E, typename St = Storage, typename = typename std::enable_if<std::is_same<St, data_storage>::value>::type>
+        gf_base(const gf_expression<E> &e) : data_(get_sizes(e.self().meshes())), meshes_(e.self().meshes()), empty_(false) {
+          static_assert(std::is_convertible<typename E::value_type, VTYPE>::value, "Right-hand side data type is not convertible into left-hand side.");
+          e.evaluate_to(data_.data());
+        }
+
+        /**
+         * Assign the values of a lazy expression. If the meshes are the same, the values are
+         * evaluated in place, and the expression may refer to this Green's function.
+         */
+        template<class E>
+        gf_type& operator=(const gf_expression<E> &e) {
+          static_assert(std::is_convertible<typename E::value_type, VTYPE>::value, "Right-hand side data type is not convertible into left-hand side.");
+          if (!empty_ && meshes_ == e.self().meshes()) {
+            e.evaluate_to(data_.data());
+            return *this;
+          }
+          return assign_new(e, std::is_same<Storage, data_storage>());
+        }
+
         /// initialize with zeros
         void initialize() {
           data_.set_zero();
@@ -311,14 +340,20 @@ namespace alps {
          * @return updated GF object
          */
         template<typename RHS_GF>
-        typename std::enable_if < std::is_convertible < RHS_GF, generic_gf<data_storage>>::value ||
-                                  std::is_convertible < RHS_GF, generic_gf<data_view>>::value, gf_type & >::type
+        typename std::enable_if < (std::is_convertible < RHS_GF, generic_gf<data_storage>>::value ||
+                                  std::is_convertible < RHS_GF, generic_gf<data_view>>::value) && !is_gf_expression<RHS_GF>::value, gf_type & >::type
         operator+=(const RHS_GF &rhs) {
           throw_if_empty();
           data_ += rhs.data();
           return *this;
         }
 
+        /// Add the values of a lazy expression in place, in a single pass
+        template<class E>
+        gf_type& operator+=(const gf_expression<E> &e) {
+          return *this = lazy(*this) + e;
+        }
+
         /**
          * Compute difference of current GF object and rhs
          *
@@ -337,14 +372,20 @@ namespace alps {
          * Inplace subtraction
          */
         template<typename RHS_GF>
-        typename std::enable_if < std::is_convertible < RHS_GF, generic_gf<data_storage>>::value ||
-                                  std::is_convertible < RHS_GF, generic_gf<data_view>>::value, gf_type & >::type
+        typename std::enable_if < (std::is_convertible < RHS_GF, generic_gf<data_storage>>::value ||
+                                  std::is_convertible < RHS_GF, generic_gf<data_view>>::value) && !is_gf_expression<RHS_GF>::value, gf_type & >::type
         operator-=(const RHS_GF &rhs) {
           throw_if_empty();
           data_ -= rhs.data();
           return *this;
         }
 
+        /// Subtract the values of a lazy expression in place, in a single pass
+        template<class E>
+        gf_type& operator-=(const gf_expression<E> &e) {
+          return *this = lazy(*this) - e;
+        }
+
         /**
          * Scaling by scalar inplace
          *
@@ -420,6 +461,18 @@ namespace alps {
           return (*this)*(VTYPE(-1.0));
         }
 
+        /**
+         * Matrix inverse over the last two meshes, for each point of the leading meshes.
+         * The matrices are inverted in parallel, see numerics::tensor_parallel_policy.
+         *
+         * @returns Green's function of the inverse matrices (a new copy)
+         */
+        gf_base < VTYPE, numerics::tensor<VTYPE, N_>, MESHES... > inverse() const {
+          static_assert(N_ >= 2, "Matrix inverse requires at least two meshes");
+          throw_if_empty();
+          return gf_base < VTYPE, numerics::tensor<VTYPE, N_>, MESHES... >(data_.batched_inverse(), meshes_);
+        }
+
         /**
          * Comparison. GFs that are defined on the same MESH and have the value return type will be equal if they are:
          *  A. Both empty
@@ -444,8 +497,7 @@ namespace alps {
          */
         double norm() const {
           throw_if_empty();
-          return std::abs(*std::max_element(data_.data(), data_.num_elements() + data_.data(),
-                                            [](VTYPE a, VTYPE b) {return std::abs(a) < std::abs(b);} ) );
+          return data_.max_abs();
         }
 
         // reshape green's function
@@ -480,6 +532,10 @@ namespace alps {
         void save(alps::hdf5::archive &ar, const std::string &path) const {
           throw_if_empty();
           save_version(ar, path);
+          // the data is stored contiguously whatever its size, so that mapped_gf can map it
+          alps::hdf5::write_options options(ar.get_write_options(path + "/data"));
+          options.contiguous_bytes = std::numeric_limits<std::size_t>::max();
+          ar.set_write_options(options, path + "/data");
           ar[path + "/data"] << data_;
           ar[path + "/mesh/N"] << int(N_);
           save_meshes(ar, path, make_index_sequence<sizeof...(MESHES)>());
@@ -487,15 +543,22 @@ namespace alps {
 
         /// Load the GF from HDF5
         void load(alps::hdf5::archive &ar, const std::string &path) {
+          meshes_ = read_meshes(ar, path);
+          data_ = numerics::tensor < VTYPE, N_ >(get_sizes(meshes_));
+          ar[path + "/data"] >> data_;
+          empty_ = false;
+        }
+
+        /// Read the meshes of the GF saved in HDF5, after checking its version and number of meshes
+        static mesh_types read_meshes(alps::hdf5::archive &ar, const std::string &path) {
           if (!check_version(ar, path)) throw std::runtime_error("Incompatible archive version");
           int ndim;
           ar[path + "/mesh/N"] >> ndim;
           if (ndim != N_) throw std::runtime_error("Wrong number of dimension reading GF, ndim=" + std::to_string(ndim)
                                                    + ", should be N=" + std::to_string(N_));
-          load_meshes(ar, path, make_index_sequence<sizeof...(MESHES)>());
-          data_ = numerics::tensor < VTYPE, N_ >(get_sizes(meshes_));
-          ar[path + "/data"] >> data_;
-          empty_ = false;
+          mesh_types meshes;
+          load_meshes(ar, path, meshes, make_index_sequence<sizeof...(MESHES)>());
+          return meshes;
         }
 
         /// Save version of the GF object to maintain compatibility
@@ -508,7 +571,7 @@ namespace alps {
         }
 
         /// Check that version of the GF object in the HDF5 archive is the same as current version
-        bool check_version(alps::hdf5::archive &ar, const std::string &path) const {
+        static bool check_version(alps::hdf5::archive &ar, const std::string &path) {
           std::string vp = path + "/version/";
           int ver;
           ar[vp + "major"] >> ver;
@@ -586,6 +649,18 @@ namespace alps {
         }
 #endif
 
+        /// Assign a lazy expression with different meshes by creating new storage
+        template<class E>
+        gf_type& assign_new(const gf_expression<E> &e, std::true_type) {
+          return *this = gf_type(e);
+        }
+
+        /// A view can not change its meshes
+        template<class E>
+        gf_type& assign_new(const gf_expression<E> &, std::false_type) {
+          throw std::invalid_argument("Green Functions have incompatible meshes");
+        }
+
         /**
          * Throw an exception if the GF object is empty
          */
@@ -680,10 +755,11 @@ namespace alps {
          * @tparam Is  - mesh index list
          * @param ar   - hdf5 archive object
          * @param path - relative context
+         * @param meshes - meshes to load
          */
         template<size_t...Is>
-        void load_meshes(alps::hdf5::archive &ar, const std::string &path, index_sequence<Is...>) {
-          std::tie(ar[path + "/mesh/" + std::to_string(Is+1)] >> std::get < Is >(meshes_)...);
+        static void load_meshes(alps::hdf5::archive &ar, const std::string &path, mesh_types &meshes, index_sequence<Is...>) {
+          std::tie(ar[path + "/mesh/" + std::to_string(Is+1)] >> std::get < Is >(meshes)...);
         }
 
         /**
@@ -747,6 +823,47 @@ namespace alps {
         }
       };
     }
+
+    /**
+     * Solution of the Dyson equation G = (G0^{-1} - Sigma)^{-1}.
+     *
+     * The last two meshes are the orbital (matrix) indices, the leading meshes (e.g. frequency and
+     * momentum) index independent matrices. Both inverses and the subtraction are done matrix by
+     * matrix in one pass over the data, in parallel according to numerics::tensor_parallel_policy.
+     *
+     * @param g0    - non-interacting Green's function
+     * @param sigma - self-energy on the same meshes
+     * @return interacting Green's function
+     */
+    template<class VTYPE, class S1, class S2, class ...MESHES>
+    detail::gf_base<VTYPE, numerics::tensor<VTYPE, sizeof...(MESHES)>, MESHES...>
+    dyson(const detail::gf_base<VTYPE, S1, MESHES...> &g0, const detail::gf_base<VTYPE, S2, MESHES...> &sigma) {
+      static_assert(sizeof...(MESHES) >= 2, "Dyson equation requires at least two meshes");
+      if (g0.is_empty() || sigma.is_empty()) {
+        throw std::runtime_error("gf is empty");
+      }
+      if (g0.meshes() != sigma.meshes()) {
+        throw std::invalid_argument("Green Functions have incompatible meshes");
+      }
+      detail::gf_base<VTYPE, numerics::tensor<VTYPE, sizeof...(MESHES)>, MESHES...> g(g0);
+      const auto &shape = g.data().shape();
+      const size_t n = shape[sizeof...(MESHES) - 1];
+      if (shape[sizeof...(MESHES) - 2] != n) {
+        throw std::invalid_argument("Dyson equation requires square matrices over the last two meshes");
+      }
+      const size_t nn = n * n;
+      VTYPE *gd = g.data().data();
+      const VTYPE *sd = sigma.data().data();
+      numerics::detail::parallel_batches(g.data().size() / std::max<size_t>(1, nn), g.data().size(), [=](size_t k) {
+        VTYPE *m = gd + k * nn;
+        numerics::detail::invert_matrix(m, n);
+        for (size_t i = 0; i < nn; ++i) {
+          m[i] -= sd[k * nn + i];
+        }
+        numerics::detail::invert_matrix(m, n);
+      });
+      return g;
+    }
   }
 }
 
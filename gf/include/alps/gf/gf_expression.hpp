@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#ifndef ALPSCORE_GF_EXPRESSION_H
+#define ALPSCORE_GF_EXPRESSION_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+#include <alps/numeric/tensors/parallel.hpp>
+#include <alps/numeric/tensors/tensor_base.hpp>
+
+namespace alps {
+  namespace gf {
+    namespace detail {
+      template<class VTYPE, class Storage, class ...MESHES>
+      class gf_base;
+
+      /// Green's function with storage for the value type VTYPE and the mesh tuple Meshes
+      template<class VTYPE, class Meshes>
+      struct gf_base_of;
+      template<class VTYPE, class ...MESHES>
+      struct gf_base_of<VTYPE, std::tuple<MESHES...> > {
+        using type = gf_base<VTYPE, numerics::tensor<VTYPE, sizeof...(MESHES)>, MESHES...>;
+      };
+
+      /**
+       * @brief Base class of the lazily evaluated arithmetic expressions of Green's functions.
+       *
+       * The arithmetic of Green's functions returns a new Green's function for each operation. With
+       * gf::lazy(), the sums, differences and scalings (e.g. `G = lazy(G0) + alpha*lazy(G0) - G1`)
+       * are instead expression objects that refer to their operands. They are evaluated element by
+       * element in a single pass when assigned to a Green's function, so no intermediate Green's
+       * functions are allocated. The meshes of the operands are compared when the expression is built.
+       *
+       * An expression refers to its operands, so it must not outlive them: assign it to a Green's
+       * function (or call eval()) instead of storing it with `auto`.
+       *
+       * @tparam E - type of the expression
+       */
+      template<class E>
+      class gf_expression {
+      public:
+        const E &self() const { return static_cast<const E &>(*this); }
+
+        /// @return number of elements
+        size_t size() const { return self().size(); }
+
+        /// @return largest absolute value of the elements, as gf_base::norm()
+        double norm() const {
+          const E &e = self();
+          return numerics::detail::parallel_reduce(e.size(), 0.0, [&e](size_t begin, size_t end) {
+            double r = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+              r = std::max(r, double(std::abs(e.value(i))));
+            }
+            return r;
+          }, [](double a, double b) { return std::max(a, b); });
+        }
+
+        /// Store the values of the expression into the buffer `out` of size()
+        template<typename T>
+        void evaluate_to(T *out) const {
+          const E &e = self();
+          numerics::detail::parallel_chunks(e.size(), [&e, out](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+              out[i] = e.value(i);
+            }
+          });
+        }
+
+        /// @return Green's function with the values of the expression
+        template<class X = E>
+        typename X::gf_type eval() const {
+          return typename X::gf_type(*this);
+        }
+      };
+
+      template<class E>
+      std::true_type is_gf_expression_test(const gf_expression<E> *);
+      std::false_type is_gf_expression_test(...);
+
+      /// Lazy expressions, derived from gf_expression
+      template<class T>
+      struct is_gf_expression : decltype(is_gf_expression_test(std::declval<T *>())) {};
+
+      template<class VTYPE, class Storage, class ...MESHES>
+      std::true_type is_gf_base_test(const gf_base<VTYPE, Storage, MESHES...> *);
+      std::false_type is_gf_base_test(...);
+
+      /// Green's functions, including those with tails, derived from gf_base
+      template<class T>
+      struct is_gf_base : decltype(is_gf_base_test(std::declval<T *>())) {};
+
+      /// Types which may appear as operands of lazy Green's function arithmetic
+      template<class T>
+      struct is_gf_operand : std::integral_constant<bool, is_gf_base<T>::value || is_gf_expression<T>::value> {};
+
+      /// Operands of which at least one is a lazy expression: plain Green's functions use the arithmetic of gf_base
+      template<class A, class B>
+      struct is_lazy_operation : std::integral_constant<bool, is_gf_operand<A>::value && is_gf_operand<B>::value
+                                                              && (is_gf_expression<A>::value || is_gf_expression<B>::value)> {};
+
+      /**
+       * Leaf of the expression: the data of a Green's function
+       */
+      template<class VTYPE, class ...MESHES>
+      class gf_leaf_expression : public gf_expression<gf_leaf_expression<VTYPE, MESHES...> > {
+      public:
+        using value_type = VTYPE;
+        using mesh_types = std::tuple<MESHES...>;
+        using gf_type    = gf_base<VTYPE, numerics::tensor<VTYPE, sizeof...(MESHES)>, MESHES...>;
+
+        template<class Storage>
+        explicit gf_leaf_expression(const gf_base<VTYPE, Storage, MESHES...> &g) : data_(g.data().data()), size_(g.data().size()), meshes_(&g.meshes()) {
+#ifndef NDEBUG
+          if (g.is_empty()) {
+            throw std::runtime_error("gf is empty");
+          }
+#endif
+        }
+
+        size_t size() const { return size_; }
+        const mesh_types &meshes() const { return *meshes_; }
+        const VTYPE &value(size_t i) const { return data_[i]; }
+
+      private:
+        const VTYPE *data_;
+        size_t size_;
+        const mesh_types *meshes_;
+      };
+
+      /**
+       * Element-wise sum or difference of two expressions
+       */
+      template<class L, class R, bool Minus>
+      class gf_sum_expression : public gf_expression<gf_sum_expression<L, R, Minus> > {
+      public:
+        using value_type = decltype(typename R::value_type{} + typename L::value_type{});
+        using mesh_types = typename L::mesh_types;
+        using gf_type    = typename gf_base_of<value_type, mesh_types>::type;
+
+        gf_sum_expression(const L &lhs, const R &rhs) : lhs_(lhs), rhs_(rhs) {
+          static_assert(std::is_same<mesh_types, typename R::mesh_types>::value, "Green's functions with different mesh types");
+          if (lhs.meshes() != rhs.meshes()) {
+            throw std::invalid_argument("Green Functions have incompatible meshes");
+          }
+        }
+
+        size_t size() const { return lhs_.size(); }
+        const mesh_types &meshes() const { return lhs_.meshes(); }
+        value_type value(size_t i) const {
+          return Minus ? value_type(lhs_.value(i)) - value_type(rhs_.value(i)) : value_type(lhs_.value(i)) + value_type(rhs_.value(i));
+        }
+
+      private:
+        L lhs_;
+        R rhs_;
+      };
+
+      /**
+       * Expression multiplied by a scalar factor
+       */
+      template<class E, class S>
+      class gf_scaled_expression : public gf_expression<gf_scaled_expression<E, S> > {
+      public:
+        using value_type = decltype(S{} + typename E::value_type{});
+        using mesh_types = typename E::mesh_types;
+        using gf_type    = typename gf_base_of<value_type, mesh_types>::type;
+
+        gf_scaled_expression(const E &e, value_type factor) : e_(e), factor_(factor) {}
+
+        size_t size() const { return e_.size(); }
+        const mesh_types &meshes() const { return e_.meshes(); }
+        value_type value(size_t i) const { return value_type(e_.value(i)) * factor_; }
+
+      private:
+        E e_;
+        value_type factor_;
+      };
+
+      /// Expression of a Green's function
+      template<class VTYPE, class Storage, class ...MESHES>
+      gf_leaf_expression<VTYPE, MESHES...> as_expression(const gf_base<VTYPE, Storage, MESHES...> &g) {
+        return gf_leaf_expression<VTYPE, MESHES...>(g);
+      }
+
+      /// Expression of an expression
+      template<class E>
+      const E &as_expression(const gf_expression<E> &e) {
+        return e.self();
+      }
+
+      template<class T>
+      using expression_type = typename std::decay<decltype(as_expression(std::declval<const T &>()))>::type;
+
+      /// Scalar type of the scaling of a Green's function with value type VTYPE: integers are converted to VTYPE
+      template<class S, class VTYPE>
+      using scalar_type = typename std::conditional<std::is_integral<S>::value, VTYPE, S>::type;
+
+      /// Sum of Green's functions and expressions
+      template<class A, class B>
+      typename std::enable_if<is_lazy_operation<A, B>::value,
+                              gf_sum_expression<expression_type<A>, expression_type<B>, false> >::type
+      operator+(const A &a, const B &b) {
+        return gf_sum_expression<expression_type<A>, expression_type<B>, false>(as_expression(a), as_expression(b));
+      }
+
+      /// Difference of Green's functions and expressions
+      template<class A, class B>
+      typename std::enable_if<is_lazy_operation<A, B>::value,
+                              gf_sum_expression<expression_type<A>, expression_type<B>, true> >::type
+      operator-(const A &a, const B &b) {
+        return gf_sum_expression<expression_type<A>, expression_type<B>, true>(as_expression(a), as_expression(b));
+      }
+
+      /// Expression multiplied by a scalar
+      template<class A, class S>
+      typename std::enable_if<is_gf_expression<A>::value && !is_gf_operand<S>::value,
+                              gf_scaled_expression<expression_type<A>, scalar_type<S, typename expression_type<A>::value_type> > >::type
+      operator*(const A &a, S s) {
+        typedef gf_scaled_expression<expression_type<A>, scalar_type<S, typename expression_type<A>::value_type> > result_type;
+        return result_type(as_expression(a), typename result_type::value_type(s));
+      }
+
+      /// Scalar multiplied by an expression
+      template<class S, class A>
+      typename std::enable_if<is_gf_expression<A>::value && !is_gf_operand<S>::value,
+                              gf_scaled_expression<expression_type<A>, scalar_type<S, typename expression_type<A>::value_type> > >::type
+      operator*(S s, const A &a) {
+        return a * s;
+      }
+
+      /// Expression divided by a scalar
+      template<class A, class S>
+      typename std::enable_if<is_gf_expression<A>::value && !is_gf_operand<S>::value,
+                              gf_scaled_expression<expression_type<A>, scalar_type<S, typename expression_type<A>::value_type> > >::type
+      operator/(const A &a, S s) {
+        typedef gf_scaled_expression<expression_type<A>, scalar_type<S, typename expression_type<A>::value_type> > result_type;
+        typedef typename result_type::value_type value_type;
+        return result_type(as_expression(a), value_type(1.0) / value_type(s));
+      }
+
+      /// Same as a/s, as for Green's functions
+      template<class S, class A>
+      typename std::enable_if<is_gf_expression<A>::value && !is_gf_operand<S>::value,
+                              gf_scaled_expression<expression_type<A>, scalar_type<S, typename expression_type<A>::value_type> > >::type
+      operator/(S s, const A &a) {
+        return a / s;
+      }
+
+      /// Negated expression
+      template<class A>
+      typename std::enable_if<is_gf_expression<A>::value,
+                              gf_scaled_expression<expression_type<A>, typename expression_type<A>::value_type> >::type
+      operator-(const A &a) {
+        typedef gf_scaled_expression<expression_type<A>, typename expression_type<A>::value_type> result_type;
+        return result_type(as_expression(a), typename result_type::value_type(-1.0));
+      }
+    }
+
+    /**
+     * Lazily evaluated expression of a Green's function, see detail::gf_expression.
+     * Arithmetic with it yields expressions instead of new Green's functions.
+     */
+    template<class VTYPE, class Storage, class ...MESHES>
+    detail::gf_leaf_expression<VTYPE, MESHES...> lazy(const detail::gf_base<VTYPE, Storage, MESHES...> &g) {
+      return detail::gf_leaf_expression<VTYPE, MESHES...>(g);
+    }
+  }
+}
+
+#endif //ALPSCORE_GF_EXPRESSION_H
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#ifndef ALPSCORE_GF_MAPPED_GF_H
+#define ALPSCORE_GF_MAPPED_GF_H
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include <alps/gf/gf_base.hpp>
+#include <alps/hdf5/archive.hpp>
+#include <alps/type_traits/index_sequence.hpp>
+#include <alps/type_traits/is_complex.hpp>
+#include <alps/utilities/mapped_file.hpp>
+
+namespace alps {
+  namespace gf {
+
+    /**
+     * @brief Green's function whose data are memory-mapped from a file instead of loaded into memory.
+     *
+     * The data are accessed through a greenf_view, and only the pages of the file that are actually
+     * accessed are read, so slices of Green's functions larger than the memory can be extracted.
+     * The data may be mapped from
+     *  - a Green's function saved to HDF5 by gf_base::save(), which stores the data contiguously
+     *    whatever their size, unless they are compressed or tiny (see alps::hdf5::archive::data_offset()), or
+     *  - a raw file with the row-major data, e.g. written by save_raw(), for given meshes.
+     *
+     * Changes of the data through the view are private and never written back to the file.
+     * The file must not be modified while it is mapped.
+     *
+     * @tparam VTYPE  - type of the values
+     * @tparam MESHES - types of the meshes
+     */
+    template<class VTYPE, class ...MESHES>
+    class mapped_gf {
+    public:
+      using value_type = VTYPE;
+      using mesh_types = std::tuple < MESHES... >;
+      using view_type  = greenf_view < VTYPE, MESHES... >;
+
+      /**
+       * Map the Green's function saved at `path` of the HDF5 file `filename`
+       *
+       * @throws alps::hdf5::archive_error if the data are not stored contiguously
+       */
+      explicit mapped_gf(const std::string &filename, const std::string &path = "") : mapped_gf(filename, locate(filename, path)) {}
+
+      /**
+       * Map the raw row-major data starting at byte `offset` of the file `filename`
+       *
+       * @param meshes - meshes of the Green's function
+       */
+      mapped_gf(const std::string &filename, std::size_t offset, const mesh_types &meshes) :
+        file_(filename, offset, sizeof(VTYPE) * num_elements(meshes, make_index_sequence<sizeof...(MESHES)>())),
+        view_(static_cast<VTYPE *>(file_.data()), meshes) {}
+
+      mapped_gf(mapped_gf &&) = default;
+
+      /// Write the data of a Green's function to the raw file `filename`, to be mapped with the meshes of g
+      template<class Storage>
+      static void save_raw(const detail::gf_base < VTYPE, Storage, MESHES... > &g, const std::string &filename) {
+        std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(g.data().data()), sizeof(VTYPE) * g.data().size());
+        if (!out) throw std::runtime_error("Cannot write Green's function data to '" + filename + "'");
+      }
+
+      /// @return view of the mapped Green's function
+      view_type &view() { return view_; }
+      /// @return view of the mapped Green's function
+      const view_type &view() const { return view_; }
+
+      /// @return meshes of the Green's function
+      const mesh_types &meshes() const { return view_.meshes(); }
+
+      /// Access to the values or slices of the mapped Green's function, as for greenf_view
+      template<class ...Indices>
+      auto operator()(Indices...inds) -> decltype(std::declval<view_type &>()(inds...)) { return view_(inds...); }
+
+      /// @return copy of the whole Green's function in memory
+      greenf < VTYPE, MESHES... > load() const { return greenf < VTYPE, MESHES... >(view_); }
+
+    private:
+      /// Position and meshes of the data of a Green's function in HDF5
+      struct location {
+        std::size_t offset;
+        mesh_types meshes;
+      };
+
+      mapped_gf(const std::string &filename, const location &loc) : mapped_gf(filename, loc.offset, loc.meshes) {}
+
+      static location locate(const std::string &filename, const std::string &path) {
+        typedef typename alps::hdf5::scalar_type < VTYPE >::type scalar_type;
+        alps::hdf5::archive ar(filename, "r");
+        location loc;
+        loc.meshes = view_type::read_meshes(ar, path);
+        const std::string data_path = path + "/data";
+        if (ar.is_complex(data_path) != is_complex < VTYPE >::value || !ar.is_datatype < scalar_type >(data_path))
+          throw std::runtime_error("The data of the Green's function in '" + filename + "' have a different type");
+        std::size_t scalars = 1;
+        for (std::size_t e : ar.extent(data_path)) scalars *= e;
+        if (scalars * sizeof(scalar_type) != num_elements(loc.meshes, make_index_sequence<sizeof...(MESHES)>()) * sizeof(VTYPE))
+          throw std::runtime_error("The data of the Green's function in '" + filename + "' do not match its meshes");
+        loc.offset = ar.data_offset(data_path);
+        return loc;
+      }
+
+      template<size_t...Is>
+      static std::size_t num_elements(const mesh_types &meshes, index_sequence<Is...>) {
+        std::size_t n = 1;
+        for (std::size_t e : {std::size_t(std::get < Is >(meshes).extent())...}) n *= e;
+        return n;
+      }
+
+      alps::mapped_file file_;
+      view_type view_;
+    };
+  }
+}
+
+#endif //ALPSCORE_GF_MAPPED_GF_H
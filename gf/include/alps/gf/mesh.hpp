@@ -1120,6 +1120,12 @@ namespace alps {
                 return basis_functions_[l];
             }
 
+            /// Values of all basis functions at the sorted points x, see gf::compute_values()
+            boost::multi_array<T,2> compute_values(const std::vector<double> &x) const {
+                check_validity();
+                return gf::compute_values(basis_functions_, x);
+            }
+
 
             /// Swaps this and another mesh
             // It's a member function to avoid dealing with templated friend decalration.
@@ -1140,7 +1146,9 @@ namespace alps {
                 this->dim_ = other.dim_;
                 this->statistics_ = other.statistics_;
                 this->basis_functions_ = other.basis_functions_;
+                this->valid_ = other.valid_;
                 base_mesh::operator=(other);
+                return *this;
             }
 
             void save(alps::hdf5::archive& ar, const std::string& path) const
@@ -7,6 +7,7 @@
 #ifndef ALPSCORE_PIEACEWISE_POLYNOMIAL_HPP
 #define ALPSCORE_PIEACEWISE_POLYNOMIAL_HPP
 
+#include <algorithm>
 #include <complex>
 #include <cmath>
 #include <type_traits>
@@ -451,6 +452,70 @@ namespace alps {
                 pps[l] = (1.0 / std::sqrt(norm)) * pp_new;
             }
         }
+
+/// Compute the values of several piecewise polynomials at many points
+/**
+ * The polynomials must have the same section edges, and the points `x` must be sorted in
+ * ascending order. Returns the matrix values[i][l] of the polynomial `l` at the point `x[i]`.
+ * The sections are located by a single sweep over the sorted points, and the coefficients of
+ * all polynomials are interleaved so that the innermost loop runs over the polynomials with
+ * unit stride, which the compiler can vectorize.
+ */
+        template<typename T>
+        boost::multi_array<T,2> compute_values(const std::vector<piecewise_polynomial<T> > &pps, const std::vector<double> &x) {
+            const std::size_t n_pp = pps.size();
+            boost::multi_array<T,2> values(boost::extents[x.size()][n_pp]);
+            std::fill(values.origin(), values.origin()+values.num_elements(), 0.0);
+            if (n_pp == 0 || x.empty()) {
+                return values;
+            }
+
+            const std::vector<double> &edges = pps[0].section_edges();
+            const int n_sections = pps[0].num_sections();
+            int k = 0;
+            for (std::size_t l = 0; l < n_pp; ++l) {
+                if (pps[l].section_edges() != edges) {
+                    throw std::runtime_error("Computing values of piecewise polynomials with different section edges are not supported");
+                }
+                k = std::max(k, pps[l].order());
+            }
+            if (x.front() < edges.front() || x.back() > edges.back()) {
+                throw std::runtime_error("Give x is out of the range.");
+            }
+
+            // coeff[s][p][l]: lower orders are padded with zeros
+            boost::multi_array<T,3> coeff(boost::extents[n_sections][k+1][n_pp]);
+            std::fill(coeff.origin(), coeff.origin()+coeff.num_elements(), 0.0);
+            for (std::size_t l = 0; l < n_pp; ++l) {
+                for (int s = 0; s < n_sections; ++s) {
+                    for (int p = 0; p < pps[l].order() + 1; ++p) {
+                        coeff[s][p][l] = pps[l].coefficient(s, p);
+                    }
+                }
+            }
+
+            int s = 0;
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                if (i > 0 && x[i] < x[i-1]) {
+                    throw std::runtime_error("The given x are not sorted.");
+                }
+                while (s < n_sections - 1 && x[i] >= edges[s+1]) {
+                    ++s;
+                }
+
+                const double dx = x[i] - edges[s];
+                T *r = &values[i][0];
+                double x_pow = 1.0;
+                for (int p = 0; p < k + 1; ++p) {
+                    const T *c = &coeff[s][p][0];
+                    for (std::size_t l = 0; l < n_pp; ++l) {
+                        r[l] += c[l] * x_pow;
+                    }
+                    x_pow *= dx;
+                }
+            }
+            return values;
+        }
     }
 }
 
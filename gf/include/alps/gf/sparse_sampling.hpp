@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+#pragma once
+#include <alps/gf/gf.hpp>
+#include <alps/gf/fourier.hpp>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace alps {
+namespace gf {
+
+namespace detail {
+  ///Pseudo-inverse of the sampling matrix a by a singular value decomposition, and its condition number
+  template<class MATRIX> MATRIX sampling_pseudo_inverse(const MATRIX &a, double &cond) {
+    Eigen::JacobiSVD<MATRIX> svd(a, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    const Eigen::VectorXd &s=svd.singularValues();
+    if (s(s.size()-1)<=1e-12*s(0))
+      throw std::invalid_argument("The sampling points do not determine the basis coefficients");
+    cond=s(0)/s(s.size()-1);
+    return svd.matrixV()*s.cwiseInverse().template cast<typename MATRIX::Scalar>().asDiagonal()*svd.matrixU().adjoint();
+  }
+
+  ///Transforms the first index of g_in to the first index of g_out by the matrix m, for all trailing indices at once
+  template<class MATRIX, class GIN, class GOUT> void sampling_apply(const MATRIX &m, const GIN &g_in, GOUT &g_out) {
+    typedef typename GIN::value_type in_type;
+    typedef typename GOUT::value_type out_type;
+    typedef decltype(typename MATRIX::Scalar()*in_type()) product_type;
+    static_assert(std::is_same<product_type, out_type>::value || std::is_same<out_type, std::complex<double> >::value, "A complex gf can only be transformed to a complex gf");
+    typedef Eigen::Matrix<in_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> in_matrix_type;
+    typedef Eigen::Matrix<out_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> out_matrix_type;
+
+    if (std::size_t(g_in.mesh1().extent())!=std::size_t(m.cols()) || std::size_t(g_out.mesh1().extent())!=std::size_t(m.rows()))
+      throw std::invalid_argument("The meshes do not match the sampling points and the basis");
+    const std::size_t ninner=g_in.data().size()/m.cols();
+    if (g_out.data().size()/m.rows()!=ninner)
+      throw std::invalid_argument("Sparse sampling between Green's functions with different inner meshes");
+
+    Eigen::Map<const in_matrix_type> in(g_in.data().data(), m.cols(), ninner);
+    Eigen::Map<out_matrix_type> out(g_out.data().data(), m.rows(), ninner);
+    out.noalias()=(m.template cast<product_type>()*in.template cast<product_type>()).template cast<out_type>();
+  }
+}
+
+/// Sparse sampling of functions expanded in the basis of a numerical_mesh
+/**
+ * A function f(x)=sum_l f_l U_l(x) of the basis functions U_l of the mesh is determined by its
+ * values at a few sampling points x_i, at least as many as there are basis functions. By default,
+ * the points are the extrema of the highest basis function, which keeps the sampling matrix
+ * A(i,l)=U_l(x_i) well conditioned for IR-type bases.
+ *
+ * The pseudo-inverse of A is precomputed by a singular value decomposition, so that fit() and
+ * evaluate() transform all trailing indices of a Green's function with one matrix-matrix product.
+ * The sampled values are stored with an index_mesh over the sampling points, in ascending order.
+ * See matsubara_sparse_sampling for the sampling in Matsubara frequencies.
+ */
+class sparse_sampling {
+public:
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+
+  /// Samples at the extrema of the highest basis function of the mesh
+  explicit sparse_sampling(const numerical_mesh<double> &mesh):
+    sparse_sampling(mesh, default_sampling_points(mesh.basis_function(mesh.extent()-1))) {}
+
+  /// Samples at the given points, which are sorted in ascending order
+  sparse_sampling(const numerical_mesh<double> &mesh, const std::vector<double> &x): x_(x) {
+    std::sort(x_.begin(), x_.end());
+    if (x_.size()<std::size_t(mesh.extent()))
+      throw std::invalid_argument("Sparse sampling needs at least as many sampling points as basis functions");
+
+    std::vector<piecewise_polynomial<double> > basis;
+    for (int l=0; l<mesh.extent(); ++l) basis.push_back(mesh.basis_function(l));
+    const boost::multi_array<double,2> values=compute_values(basis, x_);
+    a_=Eigen::Map<const matrix_type>(values.origin(), x_.size(), basis.size());
+    fit_=detail::sampling_pseudo_inverse(a_, cond_);
+  }
+
+  /// Sampling points in the domain of the basis functions
+  const std::vector<double> &sampling_points() const { return x_; }
+
+  /// Number of sampling points
+  int num_points() const { return x_.size(); }
+
+  /// Number of basis functions
+  int num_basis() const { return a_.cols(); }
+
+  /// Sampling matrix A(i,l)=U_l(x_i)
+  const matrix_type &matrix() const { return a_; }
+
+  /// Ratio of the largest to the smallest singular value of the sampling matrix
+  double condition_number() const { return cond_; }
+
+  /// Least-squares fit of the basis coefficients to the values at the sampling points
+  /**
+   * Both Green's functions may have any number of trailing meshes, which are fitted together.
+   */
+  template<class GX, class GL> void fit(const GX &g_x, GL &g_l) const {
+    static_assert(std::is_same<typename std::tuple_element<0, typename GX::mesh_types>::type, index_mesh>::value, "The sampled gf must have an index mesh over the sampling points first");
+    static_assert(std::is_same<typename std::tuple_element<0, typename GL::mesh_types>::type, numerical_mesh<double> >::value, "The fitted gf must have a numerical mesh first");
+    detail::sampling_apply(fit_, g_x, g_l);
+  }
+
+  /// Values at the sampling points of a function given by its basis coefficients
+  /**
+   * Both Green's functions may have any number of trailing meshes, which are evaluated together.
+   */
+  template<class GL, class GX> void evaluate(const GL &g_l, GX &g_x) const {
+    static_assert(std::is_same<typename std::tuple_element<0, typename GL::mesh_types>::type, numerical_mesh<double> >::value, "The gf to evaluate must have a numerical mesh first");
+    static_assert(std::is_same<typename std::tuple_element<0, typename GX::mesh_types>::type, index_mesh>::value, "The sampled gf must have an index mesh over the sampling points first");
+    detail::sampling_apply(a_, g_l, g_x);
+  }
+
+  /// Extrema of the function u, one between each pair of consecutive roots and at each end
+  static std::vector<double> default_sampling_points(const piecewise_polynomial<double> &u) {
+    const std::vector<double> &edges=u.section_edges();
+    const int nsub=32;
+    std::vector<double> grid;
+    for (int s=0; s<u.num_sections(); ++s)
+      for (int i=0; i<nsub; ++i) grid.push_back(edges[s]+(edges[s+1]-edges[s])*i/nsub);
+    grid.push_back(edges.back());
+    const boost::multi_array<double,2> values=compute_values(std::vector<piecewise_polynomial<double> >(1, u), grid);
+
+    // bracket the sign changes on the grid and refine them by bisection
+    std::vector<double> bounds(1, edges.front());
+    for (std::size_t i=0; i+1<grid.size(); ++i) {
+      if (values[i][0]==0. || values[i][0]*values[i+1][0]>0.) continue;
+      double lo=grid[i], hi=grid[i+1];
+      const bool rising=values[i][0]<0.;
+      for (int iter=0; iter<60; ++iter) {
+        const double mid=0.5*(lo+hi);
+        if ((u.compute_value(mid)<0.)==rising) lo=mid; else hi=mid;
+      }
+      bounds.push_back(0.5*(lo+hi));
+    }
+    bounds.push_back(edges.back());
+
+    // |u| is unimodal between consecutive roots: golden-section search for its maximum
+    const double ratio=0.5*(std::sqrt(5.)-1.);
+    std::vector<double> points;
+    for (std::size_t j=0; j+1<bounds.size(); ++j) {
+      double lo=bounds[j], hi=bounds[j+1];
+      for (int iter=0; iter<60; ++iter) {
+        const double x1=hi-ratio*(hi-lo), x2=lo+ratio*(hi-lo);
+        if (std::abs(u.compute_value(x1))<std::abs(u.compute_value(x2))) lo=x1; else hi=x2;
+      }
+      points.push_back(0.5*(lo+hi));
+    }
+    return points;
+  }
+
+private:
+  std::vector<double> x_;
+  matrix_type a_;
+  matrix_type fit_;
+  double cond_;
+};
+
+/// Sparse sampling in Matsubara frequencies of functions expanded in the basis of a numerical_mesh
+/**
+ * The domain [a,b] of the basis functions U_l is mapped linearly onto [0,beta] of the mesh, so that
+ * G(tau)=sum_l g_l U_l(x(tau)) with x(tau)=a+(b-a) tau/beta. Its Matsubara values are
+ * G(i omega_n)=\int_0^beta exp(i omega_n tau) G(tau) dtau=sum_l g_l U_l(i omega_n), with omega_n=(2n+1)pi/beta
+ * for fermions and 2n pi/beta for bosons. The integrals over the polynomial sections of the basis functions
+ * are exact (see detail::fourier_monomial_integrals()).
+ *
+ * As for sparse_sampling, fit() and evaluate() use the precomputed pseudo-inverse of the sampling matrix
+ * A(i,l)=U_l(i omega_(n_i)), and the sampled values are stored with an index_mesh over the sampling
+ * frequencies, in ascending order. The values are complex, so are the fitted coefficients.
+ */
+class matsubara_sparse_sampling {
+public:
+  typedef Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+
+  /// Samples at the frequencies chosen by default_sampling_frequencies()
+  explicit matsubara_sparse_sampling(const numerical_mesh<double> &mesh):
+    matsubara_sparse_sampling(mesh, default_sampling_frequencies(mesh)) {}
+
+  /// Samples at the given Matsubara indices n, which are sorted in ascending order
+  matsubara_sparse_sampling(const numerical_mesh<double> &mesh, const std::vector<int> &n): n_(n) {
+    std::sort(n_.begin(), n_.end());
+    if (n_.size()<std::size_t(mesh.extent()))
+      throw std::invalid_argument("Sparse sampling needs at least as many sampling frequencies as basis functions");
+    a_=compute_matrix(mesh, n_);
+    fit_=detail::sampling_pseudo_inverse(a_, cond_);
+  }
+
+  /// Matsubara indices n of the sampling frequencies
+  const std::vector<int> &sampling_frequencies() const { return n_; }
+
+  /// Number of sampling frequencies
+  int num_points() const { return n_.size(); }
+
+  /// Number of basis functions
+  int num_basis() const { return a_.cols(); }
+
+  /// Sampling matrix A(i,l)=U_l(i omega_(n_i))
+  const matrix_type &matrix() const { return a_; }
+
+  /// Ratio of the largest to the smallest singular value of the sampling matrix
+  double condition_number() const { return cond_; }
+
+  /// Least-squares fit of the basis coefficients to the values at the sampling frequencies
+  /**
+   * Both Green's functions are complex and may have any number of trailing meshes, which are fitted together.
+   */
+  template<class GW, class GL> void fit(const GW &g_w, GL &g_l) const {
+    static_assert(std::is_same<typename std::tuple_element<0, typename GW::mesh_types>::type, index_mesh>::value, "The sampled gf must have an index mesh over the sampling frequencies first");
+    static_assert(std::is_same<typename std::tuple_element<0, typename GL::mesh_types>::type, numerical_mesh<double> >::value, "The fitted gf must have a numerical mesh first");
+    detail::sampling_apply(fit_, g_w, g_l);
+  }
+
+  /// Values at the sampling frequencies of a function given by its basis coefficients
+  /**
+   * The sampled Green's function is complex. Both may have any number of trailing meshes, which are evaluated together.
+   */
+  template<class GL, class GW> void evaluate(const GL &g_l, GW &g_w) const {
+    static_assert(std::is_same<typename std::tuple_element<0, typename GL::mesh_types>::type, numerical_mesh<double> >::value, "The gf to evaluate must have a numerical mesh first");
+    static_assert(std::is_same<typename std::tuple_element<0, typename GW::mesh_types>::type, index_mesh>::value, "The sampled gf must have an index mesh over the sampling frequencies first");
+    detail::sampling_apply(a_, g_l, g_w);
+  }
+
+  /// Matrix U_l(i omega_(n_i)) of the Fourier transforms of the basis functions at the Matsubara indices n
+  static matrix_type compute_matrix(const numerical_mesh<double> &mesh, const std::vector<int> &n) {
+    const std::vector<double> &edges=mesh.basis_function(0).section_edges();
+    const int nsec=edges.size()-1;
+    const double scale=mesh.beta()/(edges.back()-edges.front());
+    int order=0;
+    for (int l=0; l<mesh.extent(); ++l) order=std::max(order, mesh.basis_function(l).order());
+
+    matrix_type a=matrix_type::Zero(n.size(), mesh.extent());
+    std::vector<std::complex<double> > integrals(order+1);
+    for (std::size_t i=0; i<n.size(); ++i) {
+      const double omega=(2*n[i]+int(mesh.statistics()))*M_PI/mesh.beta();
+      for (int s=0; s<nsec; ++s) {
+        // (x-x_s)^p=(u/scale)^p for u=tau-tau_s on the section
+        detail::fourier_monomial_integrals(omega, scale*(edges[s+1]-edges[s]), order, &integrals[0]);
+        double power=1.;
+        for (int p=0; p<=order; ++p, power/=scale) integrals[p]*=power;
+        const std::complex<double> phase=std::polar(1., omega*scale*(edges[s]-edges.front()));
+        for (int l=0; l<mesh.extent(); ++l) {
+          const piecewise_polynomial<double> &u=mesh.basis_function(l);
+          std::complex<double> sum=0.;
+          for (int p=0; p<=u.order(); ++p) sum+=u.coefficient(s, p)*integrals[p];
+          a(i, l)+=phase*sum;
+        }
+      }
+    }
+    return a;
+  }
+
+  /// Frequencies that keep the sampling matrix well conditioned, one per basis function
+  /**
+   * The candidates are the Matsubara indices |n|<=(k+1) N, which are the frequencies that N sections of
+   * polynomials of order k can resolve. Among them, a QR decomposition with column pivoting of the transposed
+   * sampling matrix selects the frequencies whose rows are the most linearly independent.
+   */
+  static std::vector<int> default_sampling_frequencies(const numerical_mesh<double> &mesh) {
+    int order=0;
+    for (int l=0; l<mesh.extent(); ++l) order=std::max(order, mesh.basis_function(l).order());
+    const int nmax=std::max((order+1)*mesh.basis_function(0).num_sections(), mesh.extent());
+    std::vector<int> candidates;
+    for (int n=-nmax; n<=nmax; ++n) candidates.push_back(n);
+
+    const matrix_type a=compute_matrix(mesh, candidates);
+    Eigen::ColPivHouseholderQR<Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic> > qr(a.transpose());
+    std::vector<int> n;
+    for (int i=0; i<mesh.extent(); ++i) n.push_back(candidates[qr.colsPermutation().indices()(i)]);
+    std::sort(n.begin(), n.end());
+    return n;
+  }
+
+private:
+  std::vector<int> n_;
+  matrix_type a_;
+  matrix_type fit_;
+  double cond_;
+};
+
+}
+} // end alps::
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+#include "alps/gf/fft.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace alps{
+namespace gf{
+
+fft_plan::fft_plan(std::size_t size): size_(size), roots_(size) {
+  if(size==0) throw std::invalid_argument("FFT of length zero");
+  for(std::size_t j=0;j<size;++j){
+    double phase=-2*M_PI*double(j)/double(size);
+    roots_[j]=complex_type(std::cos(phase), std::sin(phase));
+  }
+  std::size_t n=size;
+  for(std::size_t p=2; p*p<=n; ++p){
+    while(n%p==0){
+      factors_.push_back(p);
+      n/=p;
+    }
+  }
+  if(n>1) factors_.push_back(n);
+}
+
+std::shared_ptr<const fft_plan> fft_plan::get(std::size_t size) {
+  static std::mutex mutex;
+  static std::map<std::size_t, std::shared_ptr<const fft_plan> > plans;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<const fft_plan> &plan=plans[size];
+  if(!plan) plan=std::make_shared<fft_plan>(size);
+  return plan;
+}
+
+void fft_plan::forward(const complex_type *in, complex_type *out, std::size_t batch) const {
+  transform(in, out, batch, false);
+}
+
+void fft_plan::backward(const complex_type *in, complex_type *out, std::size_t batch) const {
+  transform(in, out, batch, true);
+}
+
+void fft_plan::transform(const complex_type *in, complex_type *out, std::size_t batch, bool inverse) const {
+  std::size_t max_factor=factors_.empty() ? 1 : *std::max_element(factors_.begin(), factors_.end());
+  std::vector<complex_type> scratch(max_factor*batch);
+  transform(in, out, size_, 1, 0, batch, inverse, scratch.data());
+}
+
+// Decimation in time: the n elements of `in` (at the given stride) are split into p
+// subsequences of length m=n/p, which are transformed into consecutive blocks of `out`
+// and then combined by length-p transforms.
+void fft_plan::transform(const complex_type *in, complex_type *out, std::size_t n, std::size_t stride,
+                         std::size_t level, std::size_t batch, bool inverse, complex_type *scratch) const {
+  if(n==1){
+    std::copy(in, in+batch, out);
+    return;
+  }
+  const std::size_t p=factors_[level];
+  const std::size_t m=n/p;
+  for(std::size_t r=0;r<p;++r)
+    transform(in+r*stride*batch, out+r*m*batch, m, stride*p, level+1, batch, inverse, scratch);
+
+  const std::size_t twiddle_step=size_/n;
+  const std::size_t dft_step=size_/p;
+  for(std::size_t k=0;k<m;++k){
+    if(p==2){
+      complex_type *x0=out+k*batch, *x1=out+(k+m)*batch;
+      const complex_type w=root(k*twiddle_step, inverse);
+      for(std::size_t b=0;b<batch;++b){
+        complex_type t=w*x1[b];
+        x1[b]=x0[b]-t;
+        x0[b]+=t;
+      }
+      continue;
+    }
+    for(std::size_t r=0;r<p;++r){
+      const complex_type w=root(r*k*twiddle_step, inverse);
+      const complex_type *x=out+(r*m+k)*batch;
+      for(std::size_t b=0;b<batch;++b) scratch[r*batch+b]=w*x[b];
+    }
+    for(std::size_t q=0;q<p;++q){
+      complex_type *y=out+(q*m+k)*batch;
+      std::copy(scratch, scratch+batch, y);
+      for(std::size_t r=1;r<p;++r){
+        const complex_type w=root((r*q%p)*dft_step, inverse);
+        const complex_type *t=scratch+r*batch;
+        for(std::size_t b=0;b<batch;++b) y[b]+=w*t[b];
+      }
+    }
+  }
+}
+
+}
+}
@@ -110,3 +110,352 @@ TEST_F(AtomicFourierTestGF,MatsubaraToTimeFourierAwayHalfFilling){
 
   EXPECT_NEAR((g_tau-g_tau_2).norm(), 0, 1.e-7);
 }
+
+TEST_F(AtomicFourierTestGF,MatsubaraToTimeFourierManyIndices){
+  namespace g=alps::gf;
+  typedef g::three_index_gf<std::complex<double>, g::matsubara_positive_mesh, g::index_mesh, g::index_mesh> omega_gf_type;
+  typedef g::three_index_gf<double, g::itime_mesh, g::index_mesh, g::index_mesh> tau_gf_type;
+  typedef g::two_index_gf<double, g::index_mesh, g::index_mesh> tail_type;
+  typedef g::three_index_gf_with_tail<omega_gf_type, tail_type> omega_gf_with_tail_type;
+  typedef g::three_index_gf_with_tail<tau_gf_type, tail_type> tau_gf_with_tail_type;
+
+  const int n1=3, n2=2;
+  omega_gf_with_tail_type g3_omega(omega_gf_type(g::matsubara_positive_mesh(beta,nfreq), g::index_mesh(n1), g::index_mesh(n2)));
+  tau_gf_with_tail_type g3_tau(tau_gf_type(g::itime_mesh(beta,ntau), g::index_mesh(n1), g::index_mesh(n2)));
+  tail_type c1{g::index_mesh(n1), g::index_mesh(n2)}, c2{g::index_mesh(n1), g::index_mesh(n2)};
+  U=0.2;
+
+  // a different chemical potential for each pair of inner indices
+  for(g::index i(0); i<n1; ++i){
+    for(g::index j(0); j<n2; ++j){
+      mu=0.1*(i()*n2+j());
+      for(g::matsubara_positive_mesh::index_type n(0); n<nfreq; ++n) g3_omega(n,i,j)=atomic_matsubara(n());
+      c1(i,j)=1;
+      c2(i,j)=U*density()-mu;
+    }
+  }
+  g3_omega.set_tail(1,c1);
+  g3_omega.set_tail(2,c2);
+
+  fourier_frequency_to_time(g3_omega, g3_tau);
+
+  for(g::index i(0); i<n1; ++i){
+    for(g::index j(0); j<n2; ++j){
+      mu=0.1*(i()*n2+j());
+      for(g::itime_mesh::index_type t(0); t<ntau; ++t)
+        ASSERT_NEAR(atomic_itime(tau(t())), g3_tau(t,i,j), 1.e-7) << "at tau #" << t() << " i=" << i() << " j=" << j();
+    }
+  }
+}
+
+TEST(FourierKernel,Cache){
+  alps::gf::matsubara_positive_mesh omega(10., 100);
+  alps::gf::itime_mesh tau(10., 101), other_tau(20., 101);
+
+  std::shared_ptr<const alps::gf::fourier_kernel_frequency_to_time> kernel=
+    alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), tau.points(), tau.beta());
+  EXPECT_EQ(kernel, alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), tau.points(), tau.beta()));
+  EXPECT_NE(kernel, alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), other_tau.points(), other_tau.beta()));
+  EXPECT_TRUE(kernel->matches(omega.points(), tau.points(), tau.beta()));
+
+  // the kernel agrees with the transform of a single vector
+  std::vector<std::complex<double> > input(omega.extent());
+  for (int n=0; n<omega.extent(); ++n) input[n]=std::complex<double>(1./(n+1), -2./(n+2));
+  std::vector<double> expected(tau.extent());
+  alps::gf::transform_vector_no_tail(input, omega.points(), expected, tau.points(), tau.beta());
+
+  Eigen::VectorXd output(tau.extent());
+  kernel->apply(Eigen::Map<const Eigen::VectorXcd>(input.data(), input.size()), output);
+  for (int t=0; t<tau.extent(); ++t) EXPECT_NEAR(expected[t], output(t), 1.e-10);
+}
+
+TEST(FourierKernel,CacheBytes){
+  alps::gf::matsubara_positive_mesh omega(10., 100);
+  alps::gf::itime_mesh tau(10., 101), other_tau(20., 101);
+  const std::size_t max_bytes=alps::gf::kernel_cache::max_bytes();
+
+  alps::gf::kernel_cache::clear();
+  EXPECT_EQ(0u, alps::gf::kernel_cache::bytes());
+  std::shared_ptr<const alps::gf::fourier_kernel_frequency_to_time> kernel=
+    alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), tau.points(), tau.beta());
+  EXPECT_EQ(kernel->bytes(), alps::gf::kernel_cache::bytes());
+
+  // only the most recently used kernel fits
+  alps::gf::kernel_cache::set_max_bytes(kernel->bytes());
+  std::shared_ptr<const alps::gf::fourier_kernel_frequency_to_time> other_kernel=
+    alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), other_tau.points(), other_tau.beta());
+  EXPECT_EQ(other_kernel->bytes(), alps::gf::kernel_cache::bytes());
+  EXPECT_EQ(other_kernel, alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), other_tau.points(), other_tau.beta()));
+  EXPECT_NE(kernel, alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), tau.points(), tau.beta()));
+
+  // a released kernel stays valid for its users
+  alps::gf::kernel_cache::clear();
+  EXPECT_EQ(0u, alps::gf::kernel_cache::bytes());
+  EXPECT_TRUE(other_kernel->matches(omega.points(), other_tau.points(), other_tau.beta()));
+
+  // a kernel larger than the cache is kept alone, until another one is used
+  alps::gf::kernel_cache::set_max_bytes(kernel->bytes()-1);
+  kernel=alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), tau.points(), tau.beta());
+  EXPECT_EQ(kernel->bytes(), alps::gf::kernel_cache::bytes());
+  EXPECT_EQ(kernel, alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), tau.points(), tau.beta()));
+  other_kernel=alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), other_tau.points(), other_tau.beta());
+  EXPECT_EQ(other_kernel->bytes(), alps::gf::kernel_cache::bytes());
+  EXPECT_NE(kernel, alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), tau.points(), tau.beta()));
+
+  // a cache of size 0 keeps nothing
+  alps::gf::kernel_cache::set_max_bytes(0);
+  EXPECT_EQ(0u, alps::gf::kernel_cache::bytes());
+  kernel=alps::gf::fourier_kernel_frequency_to_time::get(omega.points(), tau.points(), tau.beta());
+  EXPECT_EQ(0u, alps::gf::kernel_cache::bytes());
+  alps::gf::kernel_cache::set_max_bytes(max_bytes);
+}
+
+TEST(FFT,AgainstDFT){
+  // lengths with factors 2, 3, 5 and a larger prime
+  const std::size_t sizes[]={1, 2, 12, 30, 64, 1000, 2*97};
+  const std::size_t batch=3;
+  for (std::size_t s=0; s<sizeof(sizes)/sizeof(sizes[0]); ++s) {
+    const std::size_t n=sizes[s];
+    std::vector<std::complex<double> > in(n*batch), out(n*batch), back(n*batch);
+    for (std::size_t j=0; j<n*batch; ++j) in[j]=std::complex<double>(std::sin(1.+j), std::cos(3.*j));
+
+    alps::gf::fft_plan::get(n)->forward(in.data(), out.data(), batch);
+    for (std::size_t k=0; k<n; ++k) {
+      for (std::size_t b=0; b<batch; ++b) {
+        std::complex<double> expected=0.;
+        for (std::size_t j=0; j<n; ++j) expected+=in[j*batch+b]*std::polar(1., -2*M_PI*double(j*k%n)/n);
+        ASSERT_NEAR(0., std::abs(expected-out[k*batch+b]), 1.e-10*n) << "n=" << n << " k=" << k;
+      }
+    }
+    alps::gf::fft_plan::get(n)->backward(out.data(), back.data(), batch);
+    for (std::size_t j=0; j<n*batch; ++j) ASSERT_NEAR(0., std::abs(double(n)*in[j]-back[j]), 1.e-10*n) << "n=" << n;
+  }
+  EXPECT_EQ(alps::gf::fft_plan::get(64), alps::gf::fft_plan::get(64));
+}
+
+TEST_F(AtomicFourierTestGF,FFTMatsubaraToTimeSameAsDirect){
+  mu=0;
+  U=0.2;
+  initialize_as_atomic_matsubara(g_omega);
+  density_matrix_type unity=density_matrix_type(alps::gf::index_mesh(2));
+  unity.initialize();
+  unity(alps::gf::index(0))=1;
+  unity(alps::gf::index(1))=1;
+  g_omega.set_tail(1,unity);
+  density_matrix_type c2=density_matrix_type(alps::gf::index_mesh(2));
+  c2.initialize();
+  c2(alps::gf::index(0))=U*density()-mu;
+  c2(alps::gf::index(1))=U*density()-mu;
+  g_omega.set_tail(2,c2);
+
+  fourier_frequency_to_time(g_omega, g_tau);
+  fourier_frequency_to_time_fft(g_omega, g_tau_2);
+  EXPECT_NEAR((g_tau-g_tau_2).norm(), 0, 1.e-10);
+}
+
+TEST_F(AtomicFourierTestGF,FFTPositiveNegativeMatsubaraToTime){
+  namespace g=alps::gf;
+  mu=0;
+  U=0.2;
+  typedef g::two_index_gf<std::complex<double>, g::matsubara_pn_mesh, g::index_mesh> pn_gf_type;
+  g::two_index_gf_with_tail<pn_gf_type, density_matrix_type> g_pn(pn_gf_type(g::matsubara_pn_mesh(beta,2*nfreq), g::index_mesh(2)));
+  for(g::matsubara_pn_mesh::index_type n(0); n<2*nfreq; ++n){
+    g_pn(n,g::index(0))=atomic_matsubara(n()-nfreq);
+    g_pn(n,g::index(1))=atomic_matsubara(n()-nfreq);
+  }
+  density_matrix_type unity(g::index_mesh(2)), c2(g::index_mesh(2));
+  unity.initialize();
+  unity(g::index(0))=1;
+  unity(g::index(1))=1;
+  c2.initialize();
+  c2(g::index(0))=U*density()-mu;
+  c2(g::index(1))=U*density()-mu;
+  g_pn.set_tail(1,unity);
+  g_pn.set_tail(2,c2);
+
+  fourier_frequency_to_time_fft(g_pn, g_tau);
+  initialize_as_atomic_itime(g_tau_2);
+  EXPECT_NEAR((g_tau-g_tau_2).norm(), 0, 1.e-7);
+}
+
+TEST_F(AtomicFourierTestGF,FFTTimeToMatsubara){
+  namespace g=alps::gf;
+  mu=0;
+  U=0.2;
+  // enough time points to resolve all frequencies
+  itime_gf_type g_tau_fine(g::itime_sigma_gf(g::itime_mesh(beta,8*nfreq+1),g::index_mesh(2)));
+  for(g::itime_mesh::index_type t(0); t<8*nfreq+1; ++t){
+    g_tau_fine(t,g::index(0))=atomic_itime(g_tau_fine.mesh1().points()[t()]);
+    g_tau_fine(t,g::index(1))=atomic_itime(g_tau_fine.mesh1().points()[t()]);
+  }
+  density_matrix_type unity(g::index_mesh(2)), c2(g::index_mesh(2));
+  unity.initialize();
+  unity(g::index(0))=1;
+  unity(g::index(1))=1;
+  c2.initialize();
+  c2(g::index(0))=U*density()-mu;
+  c2(g::index(1))=U*density()-mu;
+  g_tau_fine.set_tail(1,unity);
+  g_tau_fine.set_tail(2,c2);
+
+  fourier_time_to_frequency_fft(g_tau_fine, g_omega);
+  initialize_as_atomic_matsubara(gf2);
+  for(g::matsubara_positive_mesh::index_type n(0); n<nfreq; ++n)
+    ASSERT_NEAR(0., std::abs(gf2(n,g::index(0))-g_omega(n,g::index(0))), 1.e-6) << "at n=" << n();
+
+  // too few time points for the frequencies
+  itime_gf_type g_tau_coarse(g::itime_sigma_gf(g::itime_mesh(beta,nfreq),g::index_mesh(2)));
+  EXPECT_THROW(fourier_time_to_frequency_fft(g_tau_coarse, g_omega), std::invalid_argument);
+}
+
+TEST_F(AtomicFourierTestGF,SplineTimeToMatsubara){
+  namespace g=alps::gf;
+  mu=0;
+  U=0.2;
+  initialize_as_atomic_itime(g_tau);
+  density_matrix_type unity(g::index_mesh(2)), c2(g::index_mesh(2));
+  unity.initialize();
+  unity(g::index(0))=1;
+  unity(g::index(1))=1;
+  c2.initialize();
+  c2(g::index(0))=U*density()-mu;
+  c2(g::index(1))=U*density()-mu;
+  g_tau.set_tail(1,unity);
+  g_tau.set_tail(2,c2);
+
+  fourier_time_to_frequency(g_tau, g_omega);
+  initialize_as_atomic_matsubara(gf2);
+  for(g::matsubara_positive_mesh::index_type n(0); n<nfreq; ++n)
+    ASSERT_NEAR(0., std::abs(gf2(n,g::index(1))-g_omega(n,g::index(1))), 1.e-8) << "at n=" << n();
+
+  // and back
+  g_omega.set_tail(1,unity);
+  g_omega.set_tail(2,c2);
+  fourier_frequency_to_time(g_omega, g_tau_2);
+  EXPECT_NEAR((g_tau-g_tau_2).norm(), 0, 1.e-6);
+}
+
+TEST(Fourier,SplineTimeToMatsubaraManyIndicesNoTail){
+  namespace g=alps::gf;
+  typedef g::three_index_gf<double, g::itime_mesh, g::index_mesh, g::index_mesh> tau_gf_type;
+  typedef g::three_index_gf<std::complex<double>, g::matsubara_pn_mesh, g::index_mesh, g::index_mesh> omega_gf_type;
+  const double beta=5;
+  const int ntau=51, nfreq=40, n1=3, n2=4;
+
+  // G(tau)=-a/2 transforms exactly to a/(i omega_n)
+  tau_gf_type g_tau(g::itime_mesh(beta,ntau), g::index_mesh(n1), g::index_mesh(n2));
+  for(g::itime_mesh::index_type t(0); t<ntau; ++t)
+    for(g::index i(0); i<n1; ++i)
+      for(g::index j(0); j<n2; ++j)
+        g_tau(t,i,j)=-0.5*(1+i()*n2+j());
+
+  omega_gf_type g_omega(g::matsubara_pn_mesh(beta,nfreq), g::index_mesh(n1), g::index_mesh(n2)), g_omega_threads(g_omega);
+  fourier_time_to_frequency(g_tau, g_omega);
+  // split the n1*n2 trailing indices among 5 threads
+  const unsigned nthreads=alps::numerics::tensor_parallel_policy::num_threads();
+  const std::size_t threshold=alps::numerics::tensor_parallel_policy::threshold();
+  alps::numerics::tensor_parallel_policy::set_num_threads(5);
+  alps::numerics::tensor_parallel_policy::set_threshold(0);
+  fourier_time_to_frequency(g_tau, g_omega_threads);
+  alps::numerics::tensor_parallel_policy::set_num_threads(nthreads);
+  alps::numerics::tensor_parallel_policy::set_threshold(threshold);
+  for(g::matsubara_pn_mesh::index_type n(0); n<nfreq; ++n)
+    for(g::index i(0); i<n1; ++i)
+      for(g::index j(0); j<n2; ++j) {
+        const std::complex<double> expected=(1.+i()*n2+j())/std::complex<double>(0., g_omega.mesh1().points()[n()]);
+        ASSERT_NEAR(0., std::abs(expected-g_omega(n,i,j)), 1.e-10) << "at n=" << n() << " i=" << i() << " j=" << j();
+        ASSERT_EQ(g_omega(n,i,j), g_omega_threads(n,i,j));
+      }
+
+  // the kernel of the meshes is cached
+  std::shared_ptr<const g::fourier_kernel_time_to_frequency> kernel=g::fourier_kernel_time_to_frequency::get(g_tau.mesh1().points(), g_omega.mesh1().points());
+  EXPECT_EQ(kernel, g::fourier_kernel_time_to_frequency::get(g_tau.mesh1().points(), g_omega.mesh1().points()));
+  EXPECT_EQ(nfreq, kernel->matrix().rows());
+  EXPECT_EQ(4*(ntau-1), kernel->matrix().cols());
+}
+
+TEST(Legendre,ConstantToMatsubaraAndTime){
+  namespace g=alps::gf;
+  typedef g::two_index_gf<double, g::legendre_mesh, g::index_mesh> legendre_gf_type;
+  typedef g::two_index_gf<std::complex<double>, g::matsubara_pn_mesh, g::index_mesh> omega_gf_type;
+  typedef g::two_index_gf<double, g::itime_mesh, g::index_mesh> tau_gf_type;
+  const double beta=5;
+  const int nl=20, nfreq=30, ntau=11, n1=3;
+
+  // G_l=a delta_l0 is G(tau)=a/beta, and G(i omega_n)=2ia/(omega_n beta)
+  legendre_gf_type g_l(g::legendre_mesh(beta,nl), g::index_mesh(n1));
+  g_l.initialize();
+  for(g::index i(0); i<n1; ++i) g_l(g::legendre_index(0),i)=1.+i();
+
+  omega_gf_type g_omega(g::matsubara_pn_mesh(beta,nfreq), g::index_mesh(n1));
+  legendre_to_frequency(g_l, g_omega);
+  for(g::matsubara_pn_mesh::index_type n(0); n<nfreq; ++n)
+    for(g::index i(0); i<n1; ++i) {
+      const std::complex<double> expected(0., 2*(1.+i())/(g_omega.mesh1().points()[n()]*beta));
+      ASSERT_NEAR(0., std::abs(expected-g_omega(n,i)), 1.e-12) << "at n=" << n() << " i=" << i();
+    }
+
+  tau_gf_type g_tau(g::itime_mesh(beta,ntau), g::index_mesh(n1));
+  legendre_to_time(g_l, g_tau);
+  for(g::itime_index t(0); t<ntau; ++t)
+    for(g::index i(0); i<n1; ++i)
+      ASSERT_NEAR((1.+i())/beta, g_tau(t,i), 1.e-12) << "at t=" << t() << " i=" << i();
+
+  omega_gf_type other_beta(g::matsubara_pn_mesh(2*beta,nfreq), g::index_mesh(n1));
+  tau_gf_type other_inner(g::itime_mesh(beta,ntau), g::index_mesh(n1+1));
+  EXPECT_THROW(legendre_to_frequency(g_l, other_beta), std::invalid_argument);
+  EXPECT_THROW(legendre_to_time(g_l, other_inner), std::invalid_argument);
+}
+
+TEST(Legendre,SameAsSplineTransform){
+  namespace g=alps::gf;
+  typedef g::two_index_gf<std::complex<double>, g::legendre_mesh, g::index_mesh> legendre_gf_type;
+  typedef g::two_index_gf<std::complex<double>, g::matsubara_pn_mesh, g::index_mesh> omega_gf_type;
+  typedef g::two_index_gf<std::complex<double>, g::itime_mesh, g::index_mesh> tau_gf_type;
+  const double beta=5;
+  const int nl=6, nfreq=20, ntau=2001, n1=2;
+
+  legendre_gf_type g_l(g::legendre_mesh(beta,nl), g::index_mesh(n1));
+  for(g::legendre_index l(0); l<nl; ++l)
+    for(g::index i(0); i<n1; ++i)
+      g_l(l,i)=std::complex<double>(1./(l()+1+i()), -0.5*i()/(l()+1));
+
+  // the transform of G(tau) on a fine mesh agrees with the direct transform
+  tau_gf_type g_tau(g::itime_mesh(beta,ntau), g::index_mesh(n1));
+  legendre_to_time(g_l, g_tau);
+  g::two_index_gf<double, g::itime_mesh, g::index_mesh> re_tau(g::itime_mesh(beta,ntau), g::index_mesh(n1)), im_tau(re_tau);
+  for(g::itime_index t(0); t<ntau; ++t)
+    for(g::index i(0); i<n1; ++i) {
+      re_tau(t,i)=g_tau(t,i).real();
+      im_tau(t,i)=g_tau(t,i).imag();
+    }
+  omega_gf_type re_omega(g::matsubara_pn_mesh(beta,nfreq), g::index_mesh(n1)), im_omega(re_omega), g_omega(re_omega);
+  fourier_time_to_frequency(re_tau, re_omega);
+  fourier_time_to_frequency(im_tau, im_omega);
+
+  legendre_to_frequency(g_l, g_omega);
+  for(g::matsubara_pn_mesh::index_type n(0); n<nfreq; ++n)
+    for(g::index i(0); i<n1; ++i) {
+      const std::complex<double> expected=re_omega(n,i)+std::complex<double>(0.,1.)*im_omega(n,i);
+      ASSERT_NEAR(0., std::abs(expected-g_omega(n,i)), 1.e-8) << "at n=" << n() << " i=" << i();
+    }
+}
+
+TEST(Legendre,KernelCache){
+  alps::gf::matsubara_positive_mesh omega(10., 100);
+  alps::gf::itime_mesh tau(10., 101);
+
+  std::shared_ptr<const alps::gf::legendre_kernel_to_frequency> kernel=alps::gf::legendre_kernel_to_frequency::get(10., 30, omega.points());
+  EXPECT_EQ(kernel, alps::gf::legendre_kernel_to_frequency::get(10., 30, omega.points()));
+  EXPECT_NE(kernel, alps::gf::legendre_kernel_to_frequency::get(10., 40, omega.points()));
+  EXPECT_EQ(100, kernel->matrix().rows());
+  EXPECT_EQ(30, kernel->matrix().cols());
+
+  std::shared_ptr<const alps::gf::legendre_kernel_to_time> tkernel=alps::gf::legendre_kernel_to_time::get(10., 30, tau.points());
+  EXPECT_EQ(tkernel, alps::gf::legendre_kernel_to_time::get(10., 30, tau.points()));
+  // P_l(1)=1 and P_l(-1)=(-1)^l
+  for (int l=0; l<30; ++l) {
+    EXPECT_NEAR(std::sqrt(2.*l+1.)/10.*(l%2 ? -1 : 1), tkernel->matrix()(0,l), 1.e-12);
+    EXPECT_NEAR(std::sqrt(2.*l+1.)/10., tkernel->matrix()(100,l), 1.e-12);
+  }
+}
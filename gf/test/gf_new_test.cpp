@@ -177,6 +177,88 @@ TEST(GreensFunction, BasicArithmetics2DScalingComplex) {
   }
 }
 
+TEST(GreensFunction, LazyArithmetics) {
+  typedef greenf<std::complex<double>, alps::gf::matsubara_positive_mesh, alps::gf::index_mesh> gf_type;
+  typedef greenf<double, alps::gf::matsubara_positive_mesh, alps::gf::index_mesh> real_gf_type;
+  alps::gf::matsubara_positive_mesh x(100, 10);
+  alps::gf::index_mesh y(10);
+  gf_type g0(x,y), g1(x,y);
+  real_gf_type r(x,y);
+  for(alps::gf::matsubara_positive_mesh::index_type w(0); w<x.extent(); ++w) {
+    for(alps::gf::index_mesh::index_type i(0); i<y.extent(); ++i) {
+      g0(w, i) = std::complex<double>(i(), w());
+      g1(w, i) = std::complex<double>(-w(), 0.5*i());
+      r(w, i) = w() + 2.0*i();
+    }
+  }
+  const std::complex<double> alpha(0.5, -2.0);
+
+  // the same values as the eager arithmetic, mixing value types and scalars
+  gf_type expected = g0 + g0*alpha - g1/2 + r*3.0;
+  expected = -expected;
+  gf_type g = -(lazy(g0) + lazy(g0)*alpha - lazy(g1)/2 + 3.0*lazy(r));
+  ASSERT_EQ(expected, g);
+  EXPECT_NEAR(expected.norm(), (lazy(g0) + lazy(g0)*alpha - lazy(g1)/2 + 3.0*lazy(r)).norm(), 1e-12);
+
+  // in-place assignment may refer to the assigned function
+  gf_type h(g0);
+  h = lazy(h)*2 - g1;
+  h += lazy(g1)*alpha;
+  h -= -lazy(r);
+  for(alps::gf::matsubara_positive_mesh::index_type w(0); w<x.extent(); ++w) {
+    for(alps::gf::index_mesh::index_type i(0); i<y.extent(); ++i) {
+      const std::complex<double> v = 2.0*g0(w, i) - g1(w, i) + alpha*g1(w, i) + r(w, i);
+      ASSERT_NEAR(0.0, std::abs(v - h(w, i)), 1e-12);
+    }
+  }
+
+  // an empty GF takes the meshes of the expression; different meshes throw up front
+  gf_type empty;
+  empty = lazy(g0) + g1;
+  ASSERT_EQ(gf_type(g0 + g1), empty);
+  gf_type other(alps::gf::matsubara_positive_mesh(100, 20), y);
+  other.initialize();
+  EXPECT_THROW(lazy(g0) + other, std::invalid_argument);
+}
+
+TEST(GreensFunction, DysonEquation) {
+  typedef std::complex<double> dcomplex;
+  typedef greenf<dcomplex, alps::gf::matsubara_positive_mesh, alps::gf::index_mesh, alps::gf::index_mesh, alps::gf::index_mesh> gf_type;
+  alps::gf::matsubara_positive_mesh x(10, 20);
+  alps::gf::index_mesh k(3);
+  for(int n : {2, 5}) {
+    alps::gf::index_mesh s(n);
+    gf_type g0(x, k, s, s), sigma(x, k, s, s);
+    for(alps::gf::matsubara_positive_mesh::index_type w(0); w<x.extent(); ++w) {
+      for(alps::gf::index_mesh::index_type q(0); q<k.extent(); ++q) {
+        for(alps::gf::index_mesh::index_type i(0); i<n; ++i) {
+          for(alps::gf::index_mesh::index_type j(0); j<n; ++j) {
+            g0(w, q, i, j) = (i() == j() ? 1.0/dcomplex(0.1*q() - 0.2*i(), x.points()[w()]) : dcomplex(0.0));
+            sigma(w, q, i, j) = dcomplex(0.1/(1.0 + i() + j()), -0.05*(i() == j()));
+          }
+        }
+      }
+    }
+    gf_type g = dyson(g0, sigma);
+    gf_type ginv = g.inverse();
+    gf_type g0inv = g0.inverse();
+    // G^{-1} = G0^{-1} - Sigma
+    for(alps::gf::matsubara_positive_mesh::index_type w(0); w<x.extent(); ++w) {
+      for(alps::gf::index_mesh::index_type q(0); q<k.extent(); ++q) {
+        for(alps::gf::index_mesh::index_type i(0); i<n; ++i) {
+          for(alps::gf::index_mesh::index_type j(0); j<n; ++j) {
+            ASSERT_NEAR(0.0, std::abs(ginv(w, q, i, j) - g0inv(w, q, i, j) + sigma(w, q, i, j)), 1e-10);
+          }
+        }
+      }
+    }
+  }
+  gf_type other(x, k, alps::gf::index_mesh(2), alps::gf::index_mesh(3));
+  other.initialize();
+  EXPECT_THROW(other.inverse(), std::invalid_argument);
+  EXPECT_THROW(dyson(other, other), std::invalid_argument);
+}
+
 TEST(GreensFunction, TestSave) {
   alps::gf::matsubara_positive_mesh x(100, 10);
   alps::gf::index_mesh y(10);
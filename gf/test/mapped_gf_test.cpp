@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <gtest/gtest.h>
+
+#include <alps/gf/mapped_gf.hpp>
+#include <alps/gf/mesh.hpp>
+#include <alps/testing/unique_file.hpp>
+
+using namespace alps::gf;
+
+typedef greenf<std::complex<double>, matsubara_positive_mesh, index_mesh, index_mesh> gf_type;
+typedef mapped_gf<std::complex<double>, matsubara_positive_mesh, index_mesh, index_mesh> mapped_gf_type;
+
+class MappedGFTest : public ::testing::Test {
+public:
+  MappedGFTest() : g(matsubara_positive_mesh(10, 50), index_mesh(4), index_mesh(4)) {
+    for(matsubara_positive_mesh::index_type w(0); w<g.mesh1().extent(); ++w) {
+      for(index_mesh::index_type i(0); i<g.mesh2().extent(); ++i) {
+        for(index_mesh::index_type j(0); j<g.mesh3().extent(); ++j) {
+          g(w, i, j) = std::complex<double>(w() + 0.5*i(), -0.25*j());
+        }
+      }
+    }
+  }
+
+  gf_type g;
+};
+
+TEST_F(MappedGFTest, MapFromHDF5) {
+  alps::testing::unique_file ufile("gf.h5.", alps::testing::unique_file::REMOVE_NOW);
+  {
+    alps::hdf5::archive ar(ufile.name(), "w");
+    g.save(ar, "");
+    g.save(ar, "/sub/gf");
+  }
+  mapped_gf_type m(ufile.name());
+  ASSERT_TRUE(g.meshes() == m.meshes());
+  ASSERT_EQ(g, m.view());
+  ASSERT_EQ(g, m.load());
+
+  // slices are views of the mapped data
+  matsubara_positive_mesh::index_type w(7);
+  greenf<std::complex<double>, index_mesh, index_mesh> slice = m(w);
+  for(index_mesh::index_type i(0); i<g.mesh2().extent(); ++i) {
+    for(index_mesh::index_type j(0); j<g.mesh3().extent(); ++j) {
+      ASSERT_EQ(g(w, i, j), slice(i, j));
+      ASSERT_EQ(g(w, i, j), m(w, i, j));
+    }
+  }
+
+  mapped_gf_type sub(ufile.name(), "/sub/gf");
+  ASSERT_EQ(g, sub.view());
+
+  // changes are not written to the file
+  m(w, index_mesh::index_type(0), index_mesh::index_type(0)) = 42.0;
+  mapped_gf_type moved(std::move(m));
+  ASSERT_EQ(42.0, moved(w, index_mesh::index_type(0), index_mesh::index_type(0)));
+  ASSERT_EQ(g, mapped_gf_type(ufile.name()).view());
+}
+
+TEST_F(MappedGFTest, MapLargeData) {
+  alps::testing::unique_file ufile("gf.h5.", alps::testing::unique_file::REMOVE_NOW);
+  {
+    alps::hdf5::archive ar(ufile.name(), "w");
+    // lower the size above which unfiltered datasets are chunked
+    alps::hdf5::write_options options;
+    options.contiguous_bytes = 1024;
+    ar.set_write_options(options);
+    ar["/plain"] << std::vector<double>(1000, 1.0);
+    g.save(ar, "/gf");
+  }
+  {
+    alps::hdf5::archive ar(ufile.name(), "r");
+    ASSERT_THROW(ar.data_offset("/plain"), alps::hdf5::archive_error);
+  }
+  mapped_gf_type m(ufile.name(), "/gf");
+  ASSERT_EQ(g, m.view());
+}
+
+TEST_F(MappedGFTest, MapRawFile) {
+  alps::testing::unique_file ufile("gf.raw.", alps::testing::unique_file::REMOVE_NOW);
+  mapped_gf_type::save_raw(g, ufile.name());
+  mapped_gf_type m(ufile.name(), 0, g.meshes());
+  ASSERT_EQ(g, m.view());
+
+  // the second half of the frequencies
+  int nw = g.mesh1().extent() / 2;
+  size_t offset = nw * g.mesh2().extent() * g.mesh3().extent() * sizeof(std::complex<double>);
+  mapped_gf_type half(ufile.name(), offset, std::make_tuple(matsubara_positive_mesh(10, nw), g.mesh2(), g.mesh3()));
+  ASSERT_EQ(g(matsubara_positive_mesh::index_type(nw + 3), index_mesh::index_type(2), index_mesh::index_type(1)),
+            half(matsubara_positive_mesh::index_type(3), index_mesh::index_type(2), index_mesh::index_type(1)));
+  ASSERT_THROW(mapped_gf_type(ufile.name(), offset + 1, g.meshes()), std::runtime_error);
+}
+
+TEST_F(MappedGFTest, Errors) {
+  alps::testing::unique_file ufile("gf.h5.", alps::testing::unique_file::REMOVE_NOW);
+  {
+    alps::hdf5::archive ar(ufile.name(), "w");
+    greenf<double, matsubara_positive_mesh, index_mesh, index_mesh> r(g.meshes());
+    r.initialize();
+    r.save(ar, "/real");
+    // small data are stored in the object header and can not be mapped
+    gf_type small(matsubara_positive_mesh(10, 2), index_mesh(2), index_mesh(2));
+    small.initialize();
+    small.save(ar, "/small");
+  }
+  ASSERT_THROW(mapped_gf_type(ufile.name(), "/real"), std::runtime_error);
+  ASSERT_THROW(mapped_gf_type(ufile.name(), "/small"), alps::hdf5::archive_error);
+}
@@ -464,6 +464,35 @@ TEST(Mesh,SwapNumericalMesh) {
     ASSERT_THROW(mesh1.swap(mesh3), std::runtime_error);
 }
 
+TEST(Mesh,NumericalMeshComputeValues) {
+    const int n_section = 2, k = 2;
+    typedef alps::gf::piecewise_polynomial<double> pp_type;
+
+    std::vector<double> section_edges(n_section+1);
+    section_edges[0] = -1.0;
+    section_edges[1] =  0.0;
+    section_edges[2] =  1.0;
+
+    std::vector<pp_type> basis_functions;
+    for (int l = 0; l < 3; ++l) {
+        boost::multi_array<double,2> coeff(boost::extents[n_section][k+1]);
+        std::fill(coeff.origin(), coeff.origin()+coeff.num_elements(), 0.0);
+        coeff[0][l] = 1.0;
+        coeff[1][k-l] = -1.0;
+        basis_functions.push_back(pp_type(n_section, section_edges, coeff));
+    }
+    alps::gf::numerical_mesh<double> mesh(100.0, basis_functions);
+
+    std::vector<double> x;
+    for (int i = 0; i < 11; ++i) x.push_back(-1.0 + 0.2*i);
+    const boost::multi_array<double,2> values = mesh.compute_values(x);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        for (int l = 0; l < mesh.extent(); ++l) {
+            EXPECT_NEAR(mesh.basis_function(l).compute_value(x[i]), values[i][l], 1e-14);
+        }
+    }
+}
+
 TEST(Mesh,NumericalMeshSave) {
     const int n_section = 2, k = 3;
     const double beta = 100.0;
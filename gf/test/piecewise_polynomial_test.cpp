@@ -159,3 +159,48 @@ TEST(PiecewisePolynomial, Copy) {
     EXPECT_NO_THROW({p2 = p;});
     EXPECT_TRUE(p2 == p);
 }
+
+TEST(PiecewisePolynomial, ComputeValues) {
+    const int n_section = 7, n_basis = 5, n_points = 200;
+    typedef std::complex<double> Scalar;
+    typedef alps::gf::piecewise_polynomial<Scalar> pp_type;
+
+    std::vector<double> section_edges(n_section+1);
+    for (int s = 0; s < n_section + 1; ++s) {
+        section_edges[s] = std::sin(0.5*M_PI*(2.0*s/n_section - 1.0));
+    }
+
+    // polynomials of different orders
+    std::vector<pp_type> pps;
+    for (int n = 0; n < n_basis; ++n) {
+        boost::multi_array<Scalar,2> coeff(boost::extents[n_section][n+1]);
+        for (int s = 0; s < n_section; ++s) {
+            for (int p = 0; p < n + 1; ++p) {
+                coeff[s][p] = Scalar(std::cos(n + 3.0*s + p), 1.0/(1.0 + n + s*p));
+            }
+        }
+        pps.push_back(pp_type(n_section, section_edges, coeff));
+    }
+
+    // includes both ends and all section edges
+    std::vector<double> x;
+    for (int i = 0; i < n_points; ++i) {
+        x.push_back(-1.0 + 2.0*i/(n_points-1));
+    }
+    x.insert(x.end(), section_edges.begin(), section_edges.end());
+    std::sort(x.begin(), x.end());
+
+    const boost::multi_array<Scalar,2> values = alps::gf::compute_values(pps, x);
+    ASSERT_EQ(x.size(), values.shape()[0]);
+    ASSERT_EQ(std::size_t(n_basis), values.shape()[1]);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        for (int n = 0; n < n_basis; ++n) {
+            EXPECT_NEAR(0.0, std::abs(pps[n].compute_value(x[i]) - values[i][n]), 1e-12) << "x=" << x[i] << " n=" << n;
+        }
+    }
+
+    std::vector<double> unsorted(x.rbegin(), x.rend());
+    EXPECT_THROW(alps::gf::compute_values(pps, unsorted), std::runtime_error);
+    x.push_back(1.5);
+    EXPECT_THROW(alps::gf::compute_values(pps, x), std::runtime_error);
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include "gtest/gtest.h"
+#include "alps/gf/sparse_sampling.hpp"
+
+namespace g=alps::gf;
+
+/// Orthonormal polynomials on [-1,1] (the normalized Legendre polynomials), piecewise on n_section sections
+static g::numerical_mesh<double> legendre_basis(int n_basis, int n_section) {
+    typedef g::piecewise_polynomial<double> pp_type;
+    std::vector<double> section_edges(n_section+1);
+    for (int s = 0; s < n_section + 1; ++s) {
+        section_edges[s] = s*2.0/n_section - 1.0;
+    }
+
+    // x^n expanded around the left edge of each section
+    std::vector<pp_type> basis;
+    for (int n = 0; n < n_basis; ++n) {
+        boost::multi_array<double,2> coeff(boost::extents[n_section][n_basis]);
+        std::fill(coeff.origin(), coeff.origin()+coeff.num_elements(), 0.0);
+        for (int s = 0; s < n_section; ++s) {
+            double binomial = 1.0;
+            for (int p = 0; p <= n; ++p) {
+                coeff[s][p] = binomial * std::pow(section_edges[s], n-p);
+                binomial *= double(n-p)/(p+1);
+            }
+        }
+        basis.push_back(pp_type(n_basis-1, section_edges, coeff));
+    }
+    g::orthonormalize(basis);
+    return g::numerical_mesh<double>(10.0, basis);
+}
+
+TEST(SparseSampling, DefaultPoints) {
+    const int n_basis = 12;
+    const g::numerical_mesh<double> mesh = legendre_basis(n_basis, 6);
+    const g::sparse_sampling sampling(mesh);
+
+    // the highest basis function has n_basis-1 roots, hence n_basis extrema
+    const std::vector<double> &x = sampling.sampling_points();
+    ASSERT_EQ(n_basis, sampling.num_points());
+    EXPECT_EQ(n_basis, sampling.num_basis());
+    EXPECT_NEAR(-1.0, x.front(), 1e-8);
+    EXPECT_NEAR(1.0, x.back(), 1e-8);
+    for (int i = 1; i < n_basis - 1; ++i) {
+        EXPECT_LT(x[i-1], x[i]);
+        // the extrema of P_{n-1} are the roots of its derivative
+        const double h = 1e-6;
+        const g::piecewise_polynomial<double> &u = mesh.basis_function(n_basis-1);
+        EXPECT_NEAR(0.0, (u.compute_value(x[i]+h)-u.compute_value(x[i]-h))/(2*h), 1e-3) << "at x=" << x[i];
+    }
+    EXPECT_LT(sampling.condition_number(), 10.0);
+}
+
+TEST(SparseSampling, EvaluateAndFit) {
+    typedef g::three_index_gf<std::complex<double>, g::numerical_mesh<double>, g::index_mesh, g::index_mesh> basis_gf_type;
+    typedef g::three_index_gf<std::complex<double>, g::index_mesh, g::index_mesh, g::index_mesh> sampled_gf_type;
+    const int n_basis = 10, n1 = 2, n2 = 3;
+    const g::numerical_mesh<double> mesh = legendre_basis(n_basis, 4);
+    const g::sparse_sampling sampling(mesh);
+
+    basis_gf_type g_l(mesh, g::index_mesh(n1), g::index_mesh(n2)), fitted(g_l);
+    for (g::numerical_mesh<double>::index_type l(0); l < n_basis; ++l)
+        for (g::index i(0); i < n1; ++i)
+            for (g::index j(0); j < n2; ++j)
+                g_l(l,i,j) = std::complex<double>(1.0/(1+l()+i()), std::exp(-l()*(1.0+j())));
+
+    sampled_gf_type g_x(g::index_mesh(sampling.num_points()), g::index_mesh(n1), g::index_mesh(n2));
+    sampling.evaluate(g_l, g_x);
+    for (int k = 0; k < sampling.num_points(); ++k) {
+        std::complex<double> expected = 0.0;
+        for (int l = 0; l < n_basis; ++l)
+            expected += mesh.basis_function(l).compute_value(sampling.sampling_points()[k]) * g_l(g::numerical_mesh<double>::index_type(l), g::index(1), g::index(2));
+        EXPECT_NEAR(0.0, std::abs(expected - g_x(g::index(k), g::index(1), g::index(2))), 1e-12);
+    }
+
+    sampling.fit(g_x, fitted);
+    for (g::numerical_mesh<double>::index_type l(0); l < n_basis; ++l)
+        for (g::index i(0); i < n1; ++i)
+            for (g::index j(0); j < n2; ++j)
+                ASSERT_NEAR(0.0, std::abs(g_l(l,i,j) - fitted(l,i,j)), 1e-12) << "at l=" << l() << " i=" << i() << " j=" << j();
+
+    sampled_gf_type other_inner(g::index_mesh(sampling.num_points()), g::index_mesh(n1+1), g::index_mesh(n2));
+    EXPECT_THROW(sampling.evaluate(g_l, other_inner), std::invalid_argument);
+}
+
+TEST(SparseSampling, TooFewPoints) {
+    const g::numerical_mesh<double> mesh = legendre_basis(5, 2);
+    EXPECT_THROW(g::sparse_sampling(mesh, std::vector<double>(4, 0.0)), std::invalid_argument);
+    EXPECT_THROW(g::sparse_sampling(mesh, std::vector<double>(5, 0.0)), std::invalid_argument);
+}
+
+/// \int_0^beta exp(i omega tau) u(x(tau)) dtau by the composite Simpson rule
+static std::complex<double> matsubara_value(const g::numerical_mesh<double> &mesh, int l, int n) {
+    const g::piecewise_polynomial<double> &u = mesh.basis_function(l);
+    const double beta = mesh.beta(), omega = (2*n+int(mesh.statistics()))*M_PI/beta;
+    const double a = u.section_edges().front(), b = u.section_edges().back();
+    const int npoints = 100000;
+    std::complex<double> sum = 0.0;
+    for (int k = 0; k <= npoints; ++k) {
+        const double tau = beta*k/npoints;
+        const double weight = (k == 0 || k == npoints) ? 1.0 : (k%2 ? 4.0 : 2.0);
+        sum += weight * std::polar(u.compute_value(a+(b-a)*tau/beta), omega*tau);
+    }
+    return sum * beta/(3.0*npoints);
+}
+
+TEST(SparseSampling, MatsubaraMatrix) {
+    const int n_basis = 8;
+    const g::numerical_mesh<double> fermionic = legendre_basis(n_basis, 3);
+    std::vector<g::piecewise_polynomial<double> > basis;
+    for (int l = 0; l < n_basis; ++l) basis.push_back(fermionic.basis_function(l));
+    const g::numerical_mesh<double> bosonic(fermionic.beta(), basis, g::statistics::BOSONIC);
+
+    std::vector<int> n = {-3, 0, 7, 100};
+    for (const g::numerical_mesh<double> *mesh : {&fermionic, &bosonic}) {
+        const g::matsubara_sparse_sampling::matrix_type a = g::matsubara_sparse_sampling::compute_matrix(*mesh, n);
+        for (std::size_t i = 0; i < n.size(); ++i)
+            for (int l = 0; l < n_basis; ++l)
+                EXPECT_NEAR(0.0, std::abs(a(i, l) - matsubara_value(*mesh, l, n[i])), 1e-8)
+                    << "at n=" << n[i] << " l=" << l << " statistics=" << mesh->statistics();
+    }
+}
+
+TEST(SparseSampling, MatsubaraEvaluateAndFit) {
+    typedef g::three_index_gf<std::complex<double>, g::numerical_mesh<double>, g::index_mesh, g::index_mesh> basis_gf_type;
+    typedef g::three_index_gf<std::complex<double>, g::index_mesh, g::index_mesh, g::index_mesh> sampled_gf_type;
+    const int n_basis = 10, n1 = 2, n2 = 3;
+    const g::numerical_mesh<double> mesh = legendre_basis(n_basis, 4);
+    const g::matsubara_sparse_sampling sampling(mesh);
+
+    const std::vector<int> &n = sampling.sampling_frequencies();
+    ASSERT_EQ(n_basis, sampling.num_points());
+    EXPECT_EQ(n_basis, sampling.num_basis());
+    EXPECT_TRUE(std::is_sorted(n.begin(), n.end()));
+    EXPECT_TRUE(std::adjacent_find(n.begin(), n.end()) == n.end());
+    EXPECT_LT(sampling.condition_number(), 100.0);
+
+    basis_gf_type g_l(mesh, g::index_mesh(n1), g::index_mesh(n2)), fitted(g_l);
+    for (g::numerical_mesh<double>::index_type l(0); l < n_basis; ++l)
+        for (g::index i(0); i < n1; ++i)
+            for (g::index j(0); j < n2; ++j)
+                g_l(l,i,j) = std::complex<double>(1.0/(1+l()+i()), std::exp(-l()*(1.0+j())));
+
+    sampled_gf_type g_w(g::index_mesh(sampling.num_points()), g::index_mesh(n1), g::index_mesh(n2));
+    sampling.evaluate(g_l, g_w);
+    for (int k = 0; k < sampling.num_points(); ++k) {
+        std::complex<double> expected = 0.0;
+        for (int l = 0; l < n_basis; ++l)
+            expected += sampling.matrix()(k, l) * g_l(g::numerical_mesh<double>::index_type(l), g::index(1), g::index(2));
+        EXPECT_NEAR(0.0, std::abs(expected - g_w(g::index(k), g::index(1), g::index(2))), 1e-12);
+    }
+
+    sampling.fit(g_w, fitted);
+    for (g::numerical_mesh<double>::index_type l(0); l < n_basis; ++l)
+        for (g::index i(0); i < n1; ++i)
+            for (g::index j(0); j < n2; ++j)
+                ASSERT_NEAR(0.0, std::abs(g_l(l,i,j) - fitted(l,i,j)), 1e-10) << "at l=" << l() << " i=" << i() << " j=" << j();
+
+    EXPECT_THROW(g::matsubara_sparse_sampling(mesh, std::vector<int>(n_basis-1, 0)), std::invalid_argument);
+    EXPECT_THROW(g::matsubara_sparse_sampling(mesh, std::vector<int>(n_basis, 0)), std::invalid_argument);
+}
@@ -13,6 +13,10 @@
 #include <alps/utilities/remove_cvr.hpp>
 #include <alps/utilities/type_wrapper.hpp>
 
+#ifdef ALPS_HAVE_MPI
+    #include <alps/utilities/mpi.hpp>
+#endif
+
 #ifndef ALPS_SINGLE_THREAD
 
 #include <boost/thread.hpp>
@@ -24,6 +28,8 @@
 #include <string>
 #include <type_traits>
 #include <numeric>
+#include <algorithm>
+#include <iterator>
 
 #define ALPS_FOREACH_NATIVE_HDF5_TYPE(CALLBACK)                                                                                                                        \
     CALLBACK(char)                                                                                                                                                     \
@@ -91,6 +97,33 @@ namespace alps {
             };
         }
 
+        /// layout and compression of the datasets created by archive::write()
+        /** By default, the layout is chosen from the size of the data, and the data are compressed
+            (with SZIP) only if the archive is opened in compressing mode. Datasets of at least
+            `min_bytes` are instead stored in chunks if any of the options below is set, and
+            compressed with the filters built into HDF5. The options apply when a dataset is
+            created, not when an existing dataset of the same shape is overwritten. */
+        struct write_options {
+            write_options()
+                : deflate(0), shuffle(false), chunk_bytes(1 << 20), min_bytes(4096), contiguous_bytes(1ULL << 32)
+            {}
+
+            /// deflate (zlib) compression level from 1 to 9, 0 for no compression
+            unsigned deflate;
+            /// shuffle the bytes of the elements before compression, which helps for smooth data
+            bool shuffle;
+            /// chunk shape of the leading dimensions, the remaining ones are not split; if empty,
+            /// the leading dimensions are halved until a chunk is at most `chunk_bytes`
+            std::vector<std::size_t> chunk;
+            /// maximal size of the automatically chosen chunks in bytes
+            std::size_t chunk_bytes;
+            /// smaller datasets are written with the default layout
+            std::size_t min_bytes;
+            /// unfiltered datasets of at least this size are chunked instead of stored contiguously;
+            /// only contiguous datasets can be mapped, see `archive::data_offset()`
+            std::size_t contiguous_bytes;
+        };
+
         class archive {
             private:
                archive& operator=(const archive&) =delete; /* not implemented*/ // FIXME: ...or implement via `swap()`?
@@ -100,7 +133,8 @@ namespace alps {
                     WRITE = 0x01,
                     /* REPLACE = 0x02, */ // FIXME: reactivate when we have "replace" semantics
                     COMPRESS = 0x04,
-                    MEMORY = 0x10
+                    MEMORY = 0x10,
+                    IMAGE = 0x20
                 } properties;
 
             public:
@@ -112,6 +146,25 @@ namespace alps {
                 archive(std::string const & filename, int prop);
                 archive(archive const & arg);
 
+#ifdef ALPS_HAVE_MPI
+                /// open the file collectively by all processes of `comm`, e.g. to write a common checkpoint
+                /** All processes must perform the same sequence of operations on the archive, with the
+                    same arguments except for the data and the slices of the datasets they read or write.
+                    For example, each process writes its `n` values into a common dataset by
+                    @code
+                        ar.write("/clones/state", data, {n * comm.size()}, {n}, {n * comm.rank()});
+                    @endcode
+                    If the HDF5 library supports parallel I/O, the file is accessed through MPI-IO and
+                    the data are transferred collectively. Otherwise the processes open the file one after
+                    the other, in the order of their ranks, each waiting for the previous one to close it;
+                    no other collective operations on `comm` may then be done while the archive is open.
+                    Closing the archive synchronizes all processes. */
+                archive(std::string const & filename, alps::mpi::communicator const & comm, std::string mode = "r");
+
+                /// open a file collectively by all processes of `comm`, see the constructor
+                void open(const std::string & filename, alps::mpi::communicator const & comm, const std::string &mode = "r");
+#endif
+
                 virtual ~archive();
                 static void abort();
 
@@ -141,12 +194,24 @@ namespace alps {
                     return detail::is_datatype_caller<archive, T>::apply(*this, path);
                 }
 
+                /// content of the file, as it is written to the disk
+                /** With the mode "i", the archive is only held in memory and never read from or written
+                    to the disk, so that its content can be written by other means, e.g. in a background
+                    thread without HDF5 calls. */
+                std::vector<char> file_image() const;
+
                 std::vector<std::string> list_children(std::string path) const;
                 std::vector<std::string> list_attributes(std::string path) const;
 
                 std::vector<std::size_t> extent(std::string path) const;
                 std::size_t dimensions(std::string path) const;
 
+                /// offset in bytes of the data of `path` in the file
+                /** Only data stored contiguously and without filters (i.e., not compact,
+                    chunked or compressed) has an offset, otherwise an archive_error is thrown.
+                    Together with extent(), it allows to access the data directly in the file. */
+                std::size_t data_offset(std::string path) const;
+
                 void create_group(std::string path) const;
 
                 void delete_data(std::string path) const;
@@ -155,6 +220,12 @@ namespace alps {
 
                 void set_complex(std::string path);
 
+                /// use `options` for the datasets created by this archive under the group `path`
+                /** The options of the innermost group containing a dataset apply. */
+                void set_write_options(write_options const & options, std::string path = "/");
+                /// options for the datasets created at `path`
+                write_options const & get_write_options(std::string path) const;
+
 /* TODO: implement
                 void move_data(std::string current_path, std::string new_path) const;
                 void move_attribute(std::string current_path, std::string new_path) const;
@@ -197,15 +268,33 @@ namespace alps {
                                               , std::vector<std::size_t> offset = std::vector<std::size_t>()
                     ) const -> ONLY_NATIVE(T, void);
 
+                /// append `value` as a new row to the dataset `path`, extending it along its first dimension
+                /** The dataset is created on the first call, with the extent of `value` as its row shape,
+                    and stored in chunks such that its first dimension is unlimited. Each call then
+                    only writes the new row, e.g. to stream the bins of a time series into a checkpoint:
+                    @code
+                        ar.append("/simulation/results/E/timeseries/data", bin);
+                    @endcode
+                    The appended dataset is read as any other, e.g. as a `std::vector` of the rows.
+                    Only scalars and values with contiguous content can be appended. */
+                template<typename T> void append(std::string path, T const & value);
+
+                /// append the block of rows `value` of extent `size` to the dataset `path` along its first dimension
+                template<typename T> auto append(std::string path, T const * value, std::vector<std::size_t> size) const -> ONLY_NATIVE(T, void);
+
                 template<typename T> auto is_datatype_impl(std::string path, T) const -> ONLY_NATIVE(T, bool);
 
             private:
 
                 void construct(std::string const & filename, std::size_t props = READ);
-                std::string file_key(std::string filename, bool memory) const;
+#ifdef ALPS_HAVE_MPI
+                void construct(std::string const & filename, alps::mpi::communicator const & comm, std::size_t props);
+#endif
+                std::string file_key(std::string filename, bool memory, bool collective = false, bool image = false) const;
 
                 std::string current_;
                 detail::archivecontext * context_;
+                std::map<std::string, write_options> write_options_;
 
 #ifndef ALPS_SINGLE_THREAD
                 static boost::recursive_mutex mutex_;
@@ -368,6 +457,18 @@ namespace alps {
         ALPS_FOREACH_NATIVE_HDF5_TYPE(ALPS_HDF5_DEFINE_FREE_FUNCTIONS)
         #undef ALPS_HDF5_DEFINE_FREE_FUNCTIONS
 
+        template<typename T> void archive::append(std::string path, T const & value) {
+            if (!is_continuous<T>::value && !is_content_continuous<T>::value)
+                throw archive_error("only contiguous data can be appended to path: " + path + ALPS_STACKTRACE);
+            std::vector<std::size_t> size(1, 1), extent(get_extent(value));
+            std::copy(extent.begin(), extent.end(), std::back_inserter(size));
+            if (std::find(extent.begin(), extent.end(), 0) != extent.end())
+                throw archive_error("empty data can not be appended to path: " + path + ALPS_STACKTRACE);
+            append(path, get_pointer(value), size);
+            if (has_complex_elements<typename alps::detail::remove_cvr<T>::type>::value && !is_complex(path))
+                set_complex(path);
+        }
+
         namespace detail {
 
             template<typename T> struct make_pvp_proxy {
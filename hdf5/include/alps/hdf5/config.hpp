@@ -23,5 +23,15 @@
     #define ALPS_HDF5_SZIP_BLOCK_SIZE 32
 #endif
 
+// maximal size in bytes of the chunks of datasets created by archive::append. Default: 64 KiB
+#ifndef ALPS_HDF5_APPEND_CHUNK_SIZE
+    #define ALPS_HDF5_APPEND_CHUNK_SIZE 65536
+#endif
+
+// number of datasets and groups kept open by an archive to speed up repeated accesses. Default: 128
+#ifndef ALPS_HDF5_HANDLE_CACHE_SIZE
+    #define ALPS_HDF5_HANDLE_CACHE_SIZE 128
+#endif
+
 #endif
 
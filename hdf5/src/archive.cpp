@@ -13,6 +13,7 @@
 
 #include <hdf5.h>
 
+#include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <iostream>
@@ -36,8 +37,9 @@ namespace alps {
             std::string mode="";
             if (prop & COMPRESS) mode += "c";
             if (prop & MEMORY) mode += "m";
+            if (prop & IMAGE) mode += "i";
 
-            prop = prop & ~(COMPRESS|MEMORY);
+            prop = prop & ~(COMPRESS|MEMORY|IMAGE);
 
             if (prop == READ) {
                 mode += "r";
@@ -56,13 +58,20 @@ namespace alps {
         archive::archive(archive const & arg)
             : current_(arg.current_)
             , context_(arg.context_)
+            , write_options_(arg.write_options_)
         {
             if (context_ != NULL) {
                 ALPS_HDF5_LOCK_MUTEX
-                ++ref_cnt_[file_key(context_->filename_, context_->memory_)].second;
+                ++ref_cnt_[file_key(context_->filename_, context_->memory_, context_->collective(), context_->image_)].second;
             }
         }
 
+#ifdef ALPS_HAVE_MPI
+        archive::archive(std::string const & filename, alps::mpi::communicator const & comm, std::string mode) : context_(NULL) {
+            open(filename, comm, mode);
+        }
+#endif
+
         archive::~archive() {
             if (context_ != NULL)
                 try {
@@ -94,8 +103,8 @@ namespace alps {
                 throw archive_closed("the archive is closed" + ALPS_STACKTRACE);
             ALPS_HDF5_LOCK_MUTEX
             H5Fflush(context_->file_id_, H5F_SCOPE_GLOBAL);
-            if (!--ref_cnt_[file_key(context_->filename_, context_->memory_)].second) {
-                ref_cnt_.erase(file_key(context_->filename_, context_->memory_));
+            if (!--ref_cnt_[file_key(context_->filename_, context_->memory_, context_->collective(), context_->image_)].second) {
+                ref_cnt_.erase(file_key(context_->filename_, context_->memory_, context_->collective(), context_->image_));
                 delete context_;
             }
             context_ = NULL;
@@ -104,7 +113,7 @@ namespace alps {
         void archive::open(const std::string & filename, const std::string &mode) {
             if(is_open())
                 throw archive_opened("the archive '"+ filename + "' is already opened" + ALPS_STACKTRACE);
-            if (mode.find_first_not_of("rwacm")!=std::string::npos)
+            if (mode.find_first_not_of("rwacmi")!=std::string::npos)
                 throw wrong_mode("Incorrect mode '"+mode+"' opening file '"+filename+"'" + ALPS_STACKTRACE);
 
             construct(filename,
@@ -112,9 +121,21 @@ namespace alps {
                       | (mode.find_last_of('a') == std::string::npos ? 0 : WRITE)
                       | (mode.find_last_of('c') == std::string::npos ? 0 : COMPRESS)
                       | (mode.find_last_of('m') == std::string::npos ? 0 : MEMORY)
+                      | (mode.find_last_of('i') == std::string::npos ? 0 : WRITE | MEMORY | IMAGE)
             );
         }
 
+#ifdef ALPS_HAVE_MPI
+        void archive::open(const std::string & filename, alps::mpi::communicator const & comm, const std::string &mode) {
+            if(is_open())
+                throw archive_opened("the archive '"+ filename + "' is already opened" + ALPS_STACKTRACE);
+            if (mode.find_first_not_of("rwa")!=std::string::npos)
+                throw wrong_mode("Incorrect mode '"+mode+"' opening file '"+filename+"' collectively" + ALPS_STACKTRACE);
+
+            construct(filename, comm, mode.find_first_of("wa") == std::string::npos ? 0 : WRITE);
+        }
+#endif
+
         bool archive::is_open() {
             return context_ != NULL;
         }
@@ -173,7 +194,7 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
                 throw invalid_path("no data path: " + path + ALPS_STACKTRACE);
             ALPS_HDF5_FAKE_THREADSAFETY
-            hid_t id = H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT);
+            hid_t id = context_->open_data(path);
             return id < 0 ? false : detail::check_data(id) != 0;
         }
 
@@ -192,7 +213,7 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
                 return false;
             ALPS_HDF5_FAKE_THREADSAFETY
-            hid_t id = H5Gopen2(context_->file_id_, path.c_str(), H5P_DEFAULT);
+            hid_t id = context_->open_group(path);
             return id < 0 ? false : detail::check_group(id) != 0;
         }
 
@@ -204,10 +225,9 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') != std::string::npos && is_attribute(path)) {
                 detail::attribute_type attr_id(detail::open_attribute(*this, context_->file_id_, path));
                 space_id = H5Aget_space(attr_id);
-            } else if (path.find_last_of('@') == std::string::npos && is_data(path)) {
-                detail::data_type data_id(H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
-                space_id = H5Dget_space(data_id);
-            } else
+            } else if (path.find_last_of('@') == std::string::npos && is_data(path))
+                return context_->get_space(path).type == H5S_SCALAR;
+            else
                 #ifdef ALPS_HDF5_READ_GREEDY
                     return false;
                 #else
@@ -228,10 +248,8 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') != std::string::npos) {
                 detail::attribute_type attr_id(detail::open_attribute(*this, context_->file_id_, path));
                 space_id = H5Aget_space(attr_id);
-            } else {
-                detail::data_type data_id(H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
-                space_id = H5Dget_space(data_id);
-            }
+            } else
+                return context_->get_space(path).type == H5S_NULL;
             H5S_class_t type = H5Sget_simple_extent_type(space_id);
             detail::check_space(space_id);
             if (type == H5S_NO_CLASS)
@@ -256,6 +274,17 @@ namespace alps {
                 return is_attribute(path + "/@__complex__") && is_scalar(path + "/@__complex__");
         }
 
+        std::vector<char> archive::file_image() const {
+            if (context_ == NULL)
+                throw archive_closed("the archive is closed" + ALPS_STACKTRACE);
+            ALPS_HDF5_FAKE_THREADSAFETY
+            detail::check_error(H5Fflush(context_->file_id_, H5F_SCOPE_GLOBAL));
+            std::vector<char> image(detail::check_error(H5Fget_file_image(context_->file_id_, NULL, 0)));
+            if (image.size())
+                detail::check_error(H5Fget_file_image(context_->file_id_, &image.front(), image.size()));
+            return image;
+        }
+
         std::vector<std::string> archive::list_children(std::string path) const {
             if (context_ == NULL)
                 throw archive_closed("the archive is closed" + ALPS_STACKTRACE);
@@ -265,7 +294,7 @@ namespace alps {
             ALPS_HDF5_FAKE_THREADSAFETY
             if (!is_group(path))
                 throw path_not_found("The group '" + path + "' does not exist." + ALPS_STACKTRACE);
-            detail::group_type group_id(H5Gopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
+            detail::group_type group_id(context_->open_group(path));
             detail::check_error(H5Literate(group_id, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, detail::list_children_visitor, &list));
             return list;
         }
@@ -278,10 +307,10 @@ namespace alps {
             std::vector<std::string> list;
             ALPS_HDF5_FAKE_THREADSAFETY
             if (is_group(path)) {
-                detail::group_type id(H5Gopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
+                detail::group_type id(context_->open_group(path));
                 detail::check_error(H5Aiterate2(id, H5_INDEX_CRT_ORDER, H5_ITER_NATIVE, NULL, detail::list_attributes_visitor, &list));
             } else if (is_data(path)) {
-                detail::data_type id(H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
+                detail::data_type id(context_->open_data(path));
                 detail::check_error(H5Aiterate2(id, H5_INDEX_CRT_ORDER, H5_ITER_NATIVE, NULL, detail::list_attributes_visitor, &list));
             } else
                 throw path_not_found("The path '" + path + "' does not exist." + ALPS_STACKTRACE);
@@ -295,16 +324,14 @@ namespace alps {
                 return std::vector<std::size_t>(1, 0);
             else if (is_scalar(path))
                 return std::vector<std::size_t>(1, 1);
-            std::vector<hsize_t> buffer(dimensions(path), 0);
-            hid_t space_id;
             ALPS_HDF5_FAKE_THREADSAFETY
-            if (path.find_last_of('@') != std::string::npos) {
-                detail::attribute_type attr_id(detail::open_attribute(*this, context_->file_id_, path));
-                space_id = H5Aget_space(attr_id);
-            } else {
-                detail::data_type data_id(H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
-                space_id = H5Dget_space(data_id);
+            if (path.find_last_of('@') == std::string::npos) {
+                detail::data_space space(context_->get_space(path));
+                return std::vector<std::size_t>(space.extent.begin(), space.extent.end());
             }
+            std::vector<hsize_t> buffer(dimensions(path), 0);
+            detail::attribute_type attr_id(detail::open_attribute(*this, context_->file_id_, path));
+            hid_t space_id = H5Aget_space(attr_id);
             detail::check_error(H5Sget_simple_extent_dims(space_id, &buffer.front(), NULL));
             detail::check_space(space_id);
             std::vector<std::size_t> extent(buffer.begin(), buffer.end());
@@ -318,10 +345,28 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') != std::string::npos) {
                 detail::attribute_type attr_id(detail::open_attribute(*this, context_->file_id_, path));
                 return detail::check_error(H5Sget_simple_extent_dims(detail::space_type(H5Aget_space(attr_id)), NULL, NULL));
-            } else {
-                detail::data_type data_id(H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
-                return detail::check_error(H5Sget_simple_extent_dims(detail::space_type(H5Dget_space(data_id)), NULL, NULL));
+            } else
+                return context_->get_space(path).extent.size();
+        }
+
+        std::size_t archive::data_offset(std::string path) const {
+            if (context_ == NULL)
+                throw archive_closed("the archive is closed" + ALPS_STACKTRACE);
+            if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
+                throw invalid_path("no data path: " + path + ALPS_STACKTRACE);
+            ALPS_HDF5_FAKE_THREADSAFETY
+            if (!is_data(path))
+                throw path_not_found("The data '" + path + "' does not exist." + ALPS_STACKTRACE);
+            detail::data_type data_id(context_->open_data(path));
+            {
+                detail::property_type prop_id(H5Dget_create_plist(data_id));
+                if (H5Pget_layout(prop_id) != H5D_CONTIGUOUS || detail::check_error(H5Pget_nfilters(prop_id)) > 0)
+                    throw archive_error("The data '" + path + "' is not stored contiguously." + ALPS_STACKTRACE);
             }
+            haddr_t offset = H5Dget_offset(data_id);
+            if (offset == HADDR_UNDEF)
+                throw archive_error("The data '" + path + "' has no storage in the file." + ALPS_STACKTRACE);
+            return offset;
         }
 
         void archive::create_group(std::string path) const {
@@ -336,7 +381,7 @@ namespace alps {
                 std::size_t pos;
                 hid_t group_id = -1;
                 for (pos = path.find_last_of('/'); group_id < 0 && pos > 0 && pos < std::string::npos; pos = path.find_last_of('/', pos - 1))
-                    group_id = H5Gopen2(context_->file_id_, path.substr(0, pos).c_str(), H5P_DEFAULT);
+                    group_id = context_->open_group(path.substr(0, pos));
                 if (group_id < 0) {
                     if ((pos = path.find_first_of('/', 1)) != std::string::npos) {
                         detail::property_type prop_id(H5Pcreate(H5P_GROUP_CREATE));
@@ -367,9 +412,10 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
                 throw invalid_path("no data path: " + path + ALPS_STACKTRACE);
             ALPS_HDF5_FAKE_THREADSAFETY
-            if (is_data(path))
+            if (is_data(path)) {
+                context_->invalidate(path);
                 detail::check_error(H5Ldelete(context_->file_id_, path.c_str(), H5P_DEFAULT));
-            else if (is_group(path))
+            } else if (is_group(path))
                 throw invalid_path("the path contains a group: " + path + ALPS_STACKTRACE);
         }
 
@@ -379,9 +425,10 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
                 throw invalid_path("no group path: " + path + ALPS_STACKTRACE);
             ALPS_HDF5_FAKE_THREADSAFETY
-            if (is_group(path))
+            if (is_group(path)) {
+                context_->invalidate(path);
                 detail::check_error(H5Ldelete(context_->file_id_, path.c_str(), H5P_DEFAULT));
-            else if (is_data(path))
+            } else if (is_data(path))
                 throw invalid_path("the path contains a dataset: " + path + ALPS_STACKTRACE);
         }
 
@@ -410,6 +457,29 @@ namespace alps {
             }
         }
 
+        void archive::set_write_options(write_options const & options, std::string path) {
+            if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
+                throw invalid_path("no group path: " + path + ALPS_STACKTRACE);
+            if (options.deflate > 9)
+                throw archive_error("invalid deflate level for path: " + path + ALPS_STACKTRACE);
+            if (options.deflate > 0 && detail::check_error(H5Zfilter_avail(H5Z_FILTER_DEFLATE)) == 0)
+                throw archive_error("the HDF5 library has no deflate filter" + ALPS_STACKTRACE);
+            if (std::find(options.chunk.begin(), options.chunk.end(), 0) != options.chunk.end() || options.chunk_bytes == 0)
+                throw archive_error("chunks must not be empty for path: " + path + ALPS_STACKTRACE);
+            write_options_[path] = options;
+        }
+
+        write_options const & archive::get_write_options(std::string path) const {
+            static const write_options defaults;
+            path = complete_path(path);
+            std::map<std::string, write_options>::const_iterator found = write_options_.end();
+            for (std::map<std::string, write_options>::const_iterator it = write_options_.begin(); it != write_options_.end(); ++it)
+                if ((it->first == "/" || path == it->first || path.compare(0, it->first.size() + 1, it->first + "/") == 0)
+                    && (found == write_options_.end() || it->first.size() > found->first.size()))
+                    found = it;
+            return found == write_options_.end() ? defaults : found->second;
+        }
+
         detail::archive_proxy<archive> archive::operator[](std::string const & path) {
             return detail::archive_proxy<archive>(path, *this);
         }
@@ -422,20 +492,34 @@ namespace alps {
                 detail::check_error(H5Zget_filter_info(H5Z_FILTER_SZIP, &flag));
                 props &= (flag & H5Z_FILTER_CONFIG_ENCODE_ENABLED ? ~0x00 : ~COMPRESS);
             }
-            if (ref_cnt_.find(file_key(filename, props & MEMORY)) == ref_cnt_.end())
+            std::string const key = file_key(filename, props & MEMORY, false, props & IMAGE);
+            if (ref_cnt_.find(key) == ref_cnt_.end())
                 ref_cnt_.insert(std::make_pair(
-                      file_key(filename, props & MEMORY)
-                      , std::make_pair(context_ = new detail::archivecontext(filename, props & WRITE, false/*props & REPLACE*/, props & COMPRESS, props & MEMORY), 1)
+                      key
+                      , std::make_pair(context_ = new detail::archivecontext(filename, props & WRITE, false/*props & REPLACE*/, props & COMPRESS, props & MEMORY, props & IMAGE), 1)
                 ));
             else {
-                context_ = ref_cnt_.find(file_key(filename, props & MEMORY))->second.first;
+                context_ = ref_cnt_.find(key)->second.first;
                 context_->grant(props & WRITE, false/*props & REPLACE*/);
-                ++ref_cnt_.find(file_key(filename, props & MEMORY))->second.second;
+                ++ref_cnt_.find(key)->second.second;
             }
         }
 
-        std::string archive::file_key(std::string filename, bool memory) const {
-            return (memory ? "m" : "_") + filename;
+#ifdef ALPS_HAVE_MPI
+        void archive::construct(std::string const & filename, alps::mpi::communicator const & comm, std::size_t props) {
+            ALPS_HDF5_LOCK_MUTEX
+            detail::check_error(H5Eset_auto2(H5E_DEFAULT, NULL, NULL));
+            if (ref_cnt_.find(file_key(filename, false, true)) != ref_cnt_.end())
+                throw archive_opened("the archive '" + filename + "' is already opened collectively" + ALPS_STACKTRACE);
+            ref_cnt_.insert(std::make_pair(
+                  file_key(filename, false, true)
+                , std::make_pair(context_ = new detail::archivecontext(filename, props & WRITE, comm), 1)
+            ));
+        }
+#endif
+
+        std::string archive::file_key(std::string filename, bool memory, bool collective, bool image) const {
+            return (collective ? "p" : (image ? "i" : (memory ? "m" : "_"))) + filename;
         }
 
 #ifndef ALPS_SINGLE_THREAD
@@ -110,7 +110,7 @@ namespace alps {
                 detail::attribute_type attr_id(detail::open_attribute(*this, context_->file_id_, path));
                 type_id = H5Aget_type(attr_id);
             } else if (path.find_last_of('@') == std::string::npos && is_data(path)) {
-                detail::data_type data_id(H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
+                detail::data_type data_id(context_->open_data(path));
                 type_id = H5Dget_type(data_id);
             } else
                 throw path_not_found("no valid path: " + path + ALPS_STACKTRACE);
@@ -30,7 +30,8 @@ namespace alps {
             bool hdf5_read_vector_data_helper(T * value, data_type const &data_id, type_type const &native_id,
                                               std::vector<std::size_t> const &chunk,
                                               std::vector<std::size_t> const &offset,
-                                              std::vector<std::size_t> const &data_size);
+                                              std::vector<std::size_t> const &data_size,
+                                              hid_t transfer_id);
             template<typename T>
             bool hdf5_read_vector_attribute_helper(std::string const &path, T * value, attribute_type const &attribute_id, type_type const &native_id,
                                                    std::vector<std::size_t> const &chunk,
@@ -47,16 +48,16 @@ namespace alps {
                     throw path_not_found("the path does not exist: " + path + ALPS_STACKTRACE);
                 else if (!is_scalar(path))
                     throw wrong_type("scalar - vector conflict in path: " + path + ALPS_STACKTRACE);
-                detail::data_type data_id(H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
+                detail::data_type data_id(context_->open_data(path));
                 detail::type_type type_id(H5Dget_type(data_id));
                 detail::type_type native_id(H5Tget_native_type(type_id, H5T_DIR_ASCEND));
                 if (H5Tget_class(native_id) == H5T_STRING && !detail::check_error(H5Tis_variable_str(type_id))) {
                     std::string raw(H5Tget_size(type_id) + 1, '\0');
-                    detail::check_error(H5Dread(data_id, native_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, &raw[0]));
+                    detail::check_error(H5Dread(data_id, native_id, H5S_ALL, H5S_ALL, context_->transfer_id_, &raw[0]));
                     value = cast< T >(raw);
                 } else if (H5Tget_class(native_id) == H5T_STRING) {
                     char * raw;
-                    detail::check_error(H5Dread(data_id, native_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, &raw));
+                    detail::check_error(H5Dread(data_id, native_id, H5S_ALL, H5S_ALL, context_->transfer_id_, &raw));
                     value = cast< T >(std::string(raw));
                     detail::check_error(H5Dvlen_reclaim(type_id, detail::space_type(H5Dget_space(data_id)), H5P_DEFAULT, &raw));
                 } else if(detail::hdf5_read_scalar_data_helper(value, data_id, native_id)) {
@@ -114,7 +115,7 @@ namespace alps {
                         throw path_not_found("the path does not exist: " + path + ALPS_STACKTRACE);
                     if (is_scalar(path))
                         throw archive_error("scalar - vector conflict in path: " + path + ALPS_STACKTRACE);
-                    detail::data_type data_id(H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
+                    detail::data_type data_id(context_->open_data(path));
                     detail::type_type type_id(H5Dget_type(data_id));
                     detail::type_type native_id(H5Tget_native_type(type_id, H5T_DIR_ASCEND));
                     if (H5Tget_class(native_id) == H5T_STRING && !detail::check_error(H5Tis_variable_str(type_id)))
@@ -125,7 +126,7 @@ namespace alps {
                             new char * [len]
                         );
                         if (std::equal(chunk.begin(), chunk.end(), data_size.begin())) {
-                            detail::check_error(H5Dread(data_id, native_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, raw.get()));
+                            detail::check_error(H5Dread(data_id, native_id, H5S_ALL, H5S_ALL, context_->transfer_id_, raw.get()));
                             cast(raw.get(), raw.get() + len, value);
                             detail::check_error(H5Dvlen_reclaim(type_id, detail::space_type(H5Dget_space(data_id)), H5P_DEFAULT, raw.get()));
                         } else {
@@ -134,11 +135,11 @@ namespace alps {
                             detail::space_type space_id(H5Dget_space(data_id));
                             detail::check_error(H5Sselect_hyperslab(space_id, H5S_SELECT_SET, &offset_hid.front(), NULL, &chunk_hid.front(), NULL));
                             detail::space_type mem_id(H5Screate_simple(static_cast<int>(chunk_hid.size()), &chunk_hid.front(), NULL));
-                            detail::check_error(H5Dread(data_id, native_id, mem_id, space_id, H5P_DEFAULT, raw.get()));
+                            detail::check_error(H5Dread(data_id, native_id, mem_id, space_id, context_->transfer_id_, raw.get()));
                             cast(raw.get(), raw.get() + len, value);
                                                             detail::check_error(H5Dvlen_reclaim(type_id, mem_id, H5P_DEFAULT, raw.get()));
                         }
-                    } else if(detail::hdf5_read_vector_data_helper(value, data_id, native_id, chunk, offset, data_size)) {
+                    } else if(detail::hdf5_read_vector_data_helper(value, data_id, native_id, chunk, offset, data_size, context_->transfer_id_)) {
                     } else throw wrong_type("invalid type" + ALPS_STACKTRACE);
                 } else {
                     if (!is_attribute(path))
@@ -147,9 +148,9 @@ namespace alps {
                         throw wrong_type("scalar - vector conflict in path: " + path + ALPS_STACKTRACE);
                     hid_t parent_id;
                     if (is_group(path.substr(0, path.find_last_of('@'))))
-                        parent_id = detail::check_error(H5Gopen2(context_->file_id_, path.substr(0, path.find_last_of('@')).c_str(), H5P_DEFAULT));
+                        parent_id = detail::check_error(context_->open_group(path.substr(0, path.find_last_of('@'))));
                     else if (is_data(path.substr(0, path.find_last_of('@') - 1)))
-                        parent_id = detail::check_error(H5Dopen2(context_->file_id_, path.substr(0, path.find_last_of('@')).c_str(), H5P_DEFAULT));
+                        parent_id = detail::check_error(context_->open_data(path.substr(0, path.find_last_of('@'))));
                     else
                         throw path_not_found("unknown path: " + path.substr(0, path.find_last_of('@')) + ALPS_STACKTRACE);
                     detail::attribute_type attribute_id(H5Aopen(parent_id, path.substr(path.find_last_of('@') + 1).c_str(), H5P_DEFAULT));
@@ -24,6 +24,7 @@ namespace alps {
                   std::vector<std::size_t> const &chunk,
                   std::vector<std::size_t> const &offset,
                   std::vector<std::size_t> const &data_size,
+                  hid_t transfer_id,
                   std::true_type) {
                 if (check_error(
                     H5Tequal(type_type(H5Tcopy(native_id)), type_type(get_native_type(U())))
@@ -33,7 +34,7 @@ namespace alps {
                         new U[len]
                     );
                     if (std::equal(chunk.begin(), chunk.end(), data_size.begin())) {
-                        check_error(H5Dread(data_id, native_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, raw.get()));
+                        check_error(H5Dread(data_id, native_id, H5S_ALL, H5S_ALL, transfer_id, raw.get()));
                         cast(raw.get(), raw.get() + len, value);
                     } else {
                         std::vector<hsize_t> offset_hid(offset.begin(), offset.end()),
@@ -41,7 +42,7 @@ namespace alps {
                         space_type space_id(H5Dget_space(data_id));
                         check_error(H5Sselect_hyperslab(space_id, H5S_SELECT_SET, &offset_hid.front(), NULL, &chunk_hid.front(), NULL));
                         space_type mem_id(H5Screate_simple(static_cast<int>(chunk_hid.size()), &chunk_hid.front(), NULL));
-                        check_error(H5Dread(data_id, native_id, mem_id, space_id, H5P_DEFAULT, raw.get()));
+                        check_error(H5Dread(data_id, native_id, mem_id, space_id, transfer_id, raw.get()));
                         cast(raw.get(), raw.get() + len, value);
                     }
                     return true;
@@ -52,6 +53,7 @@ namespace alps {
                                                                           chunk,
                                                                           offset,
                                                                           data_size,
+                                                                          transfer_id,
                                                                           std::integral_constant<bool, sizeof...(UTail) != 0>());
             }
             template<typename T, typename... UTail>
@@ -59,6 +61,7 @@ namespace alps {
                   std::vector<std::size_t> const &,
                   std::vector<std::size_t> const &,
                   std::vector<std::size_t> const &,
+                  hid_t,
                   std::false_type)
             { return false; }
 
@@ -66,13 +69,15 @@ namespace alps {
             bool hdf5_read_vector_data_helper(T * value, data_type const &data_id, type_type const &native_id,
                                               std::vector<std::size_t> const &chunk,
                                               std::vector<std::size_t> const &offset,
-                                              std::vector<std::size_t> const &data_size) {
+                                              std::vector<std::size_t> const &data_size,
+                                              hid_t transfer_id) {
                 return hdf5_read_vector_data_helper_impl<T, ALPS_HDF5_NATIVE_INTEGRAL_TYPES>(value,
                                                                                              data_id,
                                                                                              native_id,
                                                                                              chunk,
                                                                                              offset,
                                                                                              data_size,
+                                                                                             transfer_id,
                                                                                              std::true_type());
             }
 
@@ -80,7 +85,8 @@ namespace alps {
                 template bool hdf5_read_vector_data_helper(T *, data_type const &, type_type const &,     \
                                                            std::vector<std::size_t> const &,              \
                                                            std::vector<std::size_t> const &,              \
-                                                           std::vector<std::size_t> const &);
+                                                           std::vector<std::size_t> const &,              \
+                                                           hid_t);
             ALPS_FOREACH_NATIVE_HDF5_TYPE(ALPS_HDF5_READ_VECTOR_DATA_HELPER);
         }
     }
@@ -28,7 +28,7 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') == std::string::npos) {
                 if (is_group(path))
                     delete_group(path);
-                data_id = H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT);
+                data_id = context_->open_data(path);
                 if (data_id < 0) {
                     if (path.find_last_of('/') < std::string::npos && path.find_last_of('/') > 0)
                         create_group(path.substr(0, path.find_last_of('/')));
@@ -40,8 +40,9 @@ namespace alps {
                     }
                     if (class_type != H5S_SCALAR || !is_datatype<T>(path)) {
                         detail::check_data(data_id);
+                        context_->invalidate(path);
                         if (path.find_last_of('/') < std::string::npos && path.find_last_of('/') > 0) {
-                            detail::group_type group_id(H5Gopen2(context_->file_id_, path.substr(0, path.find_last_of('/')).c_str(), H5P_DEFAULT));
+                            detail::group_type group_id(context_->open_group(path.substr(0, path.find_last_of('/'))));
                             detail::check_error(H5Ldelete(group_id, path.substr(path.find_last_of('/') + 1).c_str(), H5P_DEFAULT));
                         } else
                             detail::check_error(H5Ldelete(context_->file_id_, path.c_str(), H5P_DEFAULT));
@@ -63,14 +64,14 @@ namespace alps {
                     );
                 }
                 detail::native_ptr_converter<typename std::remove_cv<typename std::remove_reference<T>::type>::type> converter(1);
-                detail::check_error(H5Dwrite(data_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, converter.apply(&value)));
+                detail::check_error(H5Dwrite(data_id, type_id, H5S_ALL, H5S_ALL, context_->transfer_id_, converter.apply(&value)));
                 detail::check_data(data_id);
             } else {
                 hid_t parent_id;
                 if (is_group(path.substr(0, path.find_last_of('@'))))
-                    parent_id = detail::check_error(H5Gopen2(context_->file_id_, path.substr(0, path.find_last_of('@')).c_str(), H5P_DEFAULT));
+                    parent_id = detail::check_error(context_->open_group(path.substr(0, path.find_last_of('@'))));
                 else if (is_data(path.substr(0, path.find_last_of('@'))))
-                    parent_id = detail::check_error(H5Dopen2(context_->file_id_, path.substr(0, path.find_last_of('@')).c_str(), H5P_DEFAULT));
+                    parent_id = detail::check_error(context_->open_data(path.substr(0, path.find_last_of('@'))));
                 else
                     throw path_not_found("unknown path: " + path.substr(0, path.find_last_of('@')) + ALPS_STACKTRACE);
                 hid_t data_id = H5Aopen(parent_id, path.substr(path.find_last_of('@') + 1).c_str(), H5P_DEFAULT);
@@ -127,7 +128,7 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') == std::string::npos) {
                 if (is_group(path))
                     delete_group(path);
-                data_id = H5Dopen2(context_->file_id_, path.c_str(), H5P_DEFAULT);
+                data_id = context_->open_data(path);
                 if (data_id < 0) {
                     if (path.find_last_of('/') < std::string::npos && path.find_last_of('/') > 0)
                         create_group(path.substr(0, path.find_last_of('/')));
@@ -144,6 +145,7 @@ namespace alps {
                         || !is_datatype<T>(path)
                     ) {
                         detail::check_data(data_id);
+                        context_->invalidate(path);
                         detail::check_error(H5Ldelete(context_->file_id_, path.c_str(), H5P_DEFAULT));
                         data_id = -1;
                     }
@@ -184,9 +186,26 @@ namespace alps {
                         else {
                             detail::check_error(H5Pset_fill_time(prop_id, H5D_FILL_TIME_NEVER));
                             std::size_t dataset_size = std::accumulate(size.begin(), size.end(), std::size_t(sizeof( T )), std::multiplies<std::size_t>());
-                            if (dataset_size < ALPS_HDF5_SZIP_BLOCK_SIZE * sizeof( T ))
+                            write_options const & options = get_write_options(path);
+                            // filters can not be used with MPI-IO
+                            if (!context_->mpio_ && dataset_size >= options.min_bytes && (options.deflate > 0 || options.shuffle || !options.chunk.empty())) {
+                                std::vector<hsize_t> chunk_shape(detail::get_chunk_shape(size, options.chunk, sizeof( T ), options.chunk_bytes));
+                                detail::check_error(H5Pset_chunk(prop_id, static_cast<int>(chunk_shape.size()), &chunk_shape.front()));
+                                if (options.shuffle)
+                                    detail::check_error(H5Pset_shuffle(prop_id));
+                                if (options.deflate > 0)
+                                    detail::check_error(H5Pset_deflate(prop_id, options.deflate));
+                            }
+                            // the write options replace the SZIP compression of the archive; SZIP needs chunks
+                            else if (context_->compress_ && !context_->mpio_ && dataset_size > ALPS_HDF5_SZIP_BLOCK_SIZE * sizeof( T )) {
+                                std::vector<hsize_t> chunk_shape(detail::get_chunk_shape(size, std::vector<std::size_t>(), sizeof( T ), write_options().chunk_bytes));
+                                detail::check_error(H5Pset_chunk(prop_id, static_cast<int>(chunk_shape.size()), &chunk_shape.front()));
+                                detail::check_error(H5Pset_szip(prop_id, H5_SZIP_NN_OPTION_MASK, ALPS_HDF5_SZIP_BLOCK_SIZE));
+                            }
+                            // MPI-IO can not write compact datasets collectively
+                            else if (dataset_size < ALPS_HDF5_SZIP_BLOCK_SIZE * sizeof( T ) && !context_->mpio_)
                                 detail::check_error(H5Pset_layout(prop_id, H5D_COMPACT));
-                            else if (dataset_size < (1ULL<<32))
+                            else if (dataset_size < options.contiguous_bytes)
                                 detail::check_error(H5Pset_layout(prop_id, H5D_CONTIGUOUS));
                             else {
                                 detail::check_error(H5Pset_layout(prop_id, H5D_CHUNKED));
@@ -204,8 +223,6 @@ namespace alps {
                                 }
                                 detail::check_error(H5Pset_chunk(prop_id, static_cast<int>(max_chunk.size()), &max_chunk.front()));
                             }
-                            if (context_->compress_ && dataset_size > ALPS_HDF5_SZIP_BLOCK_SIZE * sizeof( T ))
-                                detail::check_error(H5Pset_szip(prop_id, H5_SZIP_NN_OPTION_MASK, ALPS_HDF5_SZIP_BLOCK_SIZE));
                             detail::check_error(H5Pset_attr_creation_order(prop_id, (H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED)));
                             detail::check_error(data_id = H5Dcreate2(
                                   context_->file_id_
@@ -221,20 +238,20 @@ namespace alps {
                     detail::data_type raii_id(data_id);
                     detail::native_ptr_converter<T> converter(std::accumulate(chunk.begin(), chunk.end(), std::size_t(1), std::multiplies<std::size_t>()));
                     if (std::equal(chunk.begin(), chunk.end(), size.begin()))
-                        detail::check_error(H5Dwrite(raii_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, converter.apply(value)));
+                        detail::check_error(H5Dwrite(raii_id, type_id, H5S_ALL, H5S_ALL, context_->transfer_id_, converter.apply(value)));
                     else {
                         detail::space_type space_id(H5Dget_space(raii_id));
                         detail::check_error(H5Sselect_hyperslab(space_id, H5S_SELECT_SET, &offset_hid.front(), NULL, &chunk_hid.front(), NULL));
                         detail::space_type mem_id(detail::space_type(H5Screate_simple(static_cast<int>(chunk_hid.size()), &chunk_hid.front(), NULL)));
-                        detail::check_error(H5Dwrite(raii_id, type_id, mem_id, space_id, H5P_DEFAULT, converter.apply(value)));
+                        detail::check_error(H5Dwrite(raii_id, type_id, mem_id, space_id, context_->transfer_id_, converter.apply(value)));
                     }
                 }
             } else {
                 hid_t parent_id;
                 if (is_group(path.substr(0, path.find_last_of('@'))))
-                    parent_id = detail::check_error(H5Gopen2(context_->file_id_, path.substr(0, path.find_last_of('@')).c_str(), H5P_DEFAULT));
+                    parent_id = detail::check_error(context_->open_group(path.substr(0, path.find_last_of('@'))));
                 else if (is_data(path.substr(0, path.find_last_of('@'))))
-                    parent_id = detail::check_error(H5Dopen2(context_->file_id_, path.substr(0, path.find_last_of('@')).c_str(), H5P_DEFAULT));
+                    parent_id = detail::check_error(context_->open_data(path.substr(0, path.find_last_of('@'))));
                 else
                     throw path_not_found("unknown path: " + path.substr(0, path.find_last_of('@')) + ALPS_STACKTRACE);
                 hid_t data_id = H5Aopen(parent_id, path.substr(path.find_last_of('@') + 1).c_str(), H5P_DEFAULT);
@@ -296,5 +313,80 @@ namespace alps {
         #define ALPS_HDF5_WRITE_VECTOR(T) template void archive::write<T>(                                                \
             std::string, T const *, std::vector<std::size_t>, std::vector<std::size_t>, std::vector<std::size_t>) const;
         ALPS_FOREACH_NATIVE_HDF5_TYPE(ALPS_HDF5_WRITE_VECTOR)
+
+        template<typename T>
+        auto archive::append(std::string path, T const * value, std::vector<std::size_t> size) const -> ONLY_NATIVE(T, void) {
+            ALPS_HDF5_FAKE_THREADSAFETY
+            if (context_ == NULL)
+                throw archive_closed("the archive is closed" + ALPS_STACKTRACE);
+            if (!context_->write_)
+                throw archive_error("the archive is not writeable" + ALPS_STACKTRACE);
+            if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
+                throw invalid_path("attributes can not be appended: " + path + ALPS_STACKTRACE);
+            if (size.size() == 0 || std::accumulate(size.begin(), size.end(), std::size_t(1), std::multiplies<std::size_t>()) == 0)
+                throw archive_error("no data to append to path: " + path + ALPS_STACKTRACE);
+            if (is_group(path))
+                throw archive_error("a group can not be appended to: " + path + ALPS_STACKTRACE);
+            detail::type_type type_id(detail::get_native_type(T()));
+            std::vector<hsize_t> block_hid(size.begin(), size.end())
+                               , offset_hid(size.size(), 0);
+            hid_t data_id = context_->open_data(path);
+            bool exists = data_id >= 0;
+            if (!exists) {
+                if (path.find_last_of('/') < std::string::npos && path.find_last_of('/') > 0)
+                    create_group(path.substr(0, path.find_last_of('/')));
+                write_options const & options = get_write_options(path);
+                // the first dimension of the chunks is chosen for the expected length of the series, not for the first block
+                std::size_t chunk_bytes = std::min<std::size_t>(options.chunk_bytes, ALPS_HDF5_APPEND_CHUNK_SIZE);
+                std::size_t row_bytes = std::accumulate(size.begin() + 1, size.end(), std::size_t(sizeof( T )), std::multiplies<std::size_t>());
+                std::vector<std::size_t> shape(size);
+                shape[0] = std::max(size[0], options.chunk.empty() ? std::max<std::size_t>(1, chunk_bytes / row_bytes) : options.chunk[0]);
+                std::vector<hsize_t> chunk_shape(detail::get_chunk_shape(shape, options.chunk, sizeof( T ), chunk_bytes))
+                                   , max_hid(block_hid);
+                max_hid[0] = H5S_UNLIMITED;
+                detail::property_type prop_id(H5Pcreate(H5P_DATASET_CREATE));
+                detail::check_error(H5Pset_attr_creation_order(prop_id, (H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED)));
+                detail::check_error(H5Pset_chunk(prop_id, static_cast<int>(chunk_shape.size()), &chunk_shape.front()));
+                // filters can not be used with MPI-IO
+                if (!context_->mpio_ && options.shuffle)
+                    detail::check_error(H5Pset_shuffle(prop_id));
+                if (!context_->mpio_ && options.deflate > 0)
+                    detail::check_error(H5Pset_deflate(prop_id, options.deflate));
+                detail::check_error(data_id = H5Dcreate2(
+                      context_->file_id_
+                    , path.c_str()
+                    , type_id
+                    , detail::space_type(H5Screate_simple(static_cast<int>(block_hid.size()), &block_hid.front(), &max_hid.front()))
+                    , H5P_DEFAULT
+                    , prop_id
+                    , H5P_DEFAULT
+                ));
+            }
+            detail::data_type raii_id(data_id);
+            if (exists) {
+                std::vector<hsize_t> size_hid(size.size()), max_hid(size.size());
+                {
+                    detail::space_type space_id(H5Dget_space(raii_id));
+                    if (H5Sget_simple_extent_type(space_id) != H5S_SIMPLE || detail::check_error(H5Sget_simple_extent_ndims(space_id)) != static_cast<int>(size.size()))
+                        throw archive_error("the dimensions do not match on path: " + path + ALPS_STACKTRACE);
+                    detail::check_error(H5Sget_simple_extent_dims(space_id, &size_hid.front(), &max_hid.front()));
+                }
+                if (max_hid[0] != H5S_UNLIMITED)
+                    throw archive_error("the dataset was not created by append and can not be extended: " + path + ALPS_STACKTRACE);
+                if (!std::equal(size_hid.begin() + 1, size_hid.end(), block_hid.begin() + 1))
+                    throw archive_error("the extent of the rows does not match on path: " + path + ALPS_STACKTRACE);
+                offset_hid[0] = size_hid[0];
+                size_hid[0] += block_hid[0];
+                detail::check_error(H5Dset_extent(raii_id, &size_hid.front()));
+                context_->invalidate_space(path);
+            }
+            detail::space_type space_id(H5Dget_space(raii_id));
+            detail::check_error(H5Sselect_hyperslab(space_id, H5S_SELECT_SET, &offset_hid.front(), NULL, &block_hid.front(), NULL));
+            detail::space_type mem_id(H5Screate_simple(static_cast<int>(block_hid.size()), &block_hid.front(), NULL));
+            detail::native_ptr_converter<T> converter(std::accumulate(size.begin(), size.end(), std::size_t(1), std::multiplies<std::size_t>()));
+            detail::check_error(H5Dwrite(raii_id, type_id, mem_id, space_id, context_->transfer_id_, converter.apply(value)));
+        }
+        #define ALPS_HDF5_APPEND_VECTOR(T) template void archive::append<T>(std::string, T const *, std::vector<std::size_t>) const;
+        ALPS_FOREACH_NATIVE_HDF5_TYPE(ALPS_HDF5_APPEND_VECTOR)
     }
 }
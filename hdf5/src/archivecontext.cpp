@@ -15,23 +15,166 @@
 #include "common.hpp"
 #include "archivecontext.hpp"
 
+#ifdef ALPS_SINGLE_THREAD
+    #define ALPS_HDF5_LOCK_CACHE
+#else
+    #define ALPS_HDF5_LOCK_CACHE boost::lock_guard<boost::mutex> cache_guard(cache_mutex_);
+#endif
+
 namespace alps {
     namespace hdf5 {
         namespace detail {
 
-            archivecontext::archivecontext(std::string const & filename, bool write, bool replace, bool compress, bool memory)
+            archivecontext::archivecontext(std::string const & filename, bool write, bool replace, bool compress, bool memory, bool image)
                 : compress_(compress)
                 , write_(write || replace)
                 , replace_(!memory && replace)
                 , memory_(memory)
+                , image_(image)
                 , filename_(filename)
                 , filename_new_(filename)
+                , transfer_id_(H5P_DEFAULT)
+                , mpio_(false)
             {
                 construct();
             }
 
+            #ifdef ALPS_HAVE_MPI
+                // With parallel HDF5, the file is opened collectively through MPI-IO. Otherwise the processes
+                // take turns: each one waits for the previous rank to close the file before opening it.
+                archivecontext::archivecontext(std::string const & filename, bool write, alps::mpi::communicator const & comm)
+                    : compress_(false)
+                    , write_(write)
+                    , replace_(false)
+                    , memory_(false)
+                    , image_(false)
+                    , filename_(filename)
+                    , filename_new_(filename)
+                    , transfer_id_(H5P_DEFAULT)
+                    , mpio_(false)
+                    , comm_(new alps::mpi::communicator(comm, alps::mpi::comm_duplicate))
+                {
+                    #ifdef H5_HAVE_PARALLEL
+                        mpio_ = true;
+                    #else
+                        if (comm_->rank() > 0) {
+                            int token;
+                            MPI_Recv(&token, 1, MPI_INT, comm_->rank() - 1, 0, *comm_, MPI_STATUS_IGNORE);
+                        }
+                    #endif
+                    construct();
+                }
+            #endif
+
             archivecontext::~archivecontext() {
                 destruct(true);
+                #ifdef ALPS_HAVE_MPI
+                    if (comm_) {
+                        #ifndef H5_HAVE_PARALLEL
+                            if (comm_->rank() + 1 < comm_->size()) {
+                                int token = 0;
+                                MPI_Send(&token, 1, MPI_INT, comm_->rank() + 1, 0, *comm_);
+                            }
+                        #endif
+                        comm_->barrier();
+                    }
+                #endif
+            }
+
+            bool archivecontext::collective() const {
+                #ifdef ALPS_HAVE_MPI
+                    return comm_ != nullptr;
+                #else
+                    return false;
+                #endif
+            }
+
+            hid_t archivecontext::open_data(std::string const & path) {
+                ALPS_HDF5_LOCK_CACHE
+                cached_object * object = lookup(path, false);
+                if (object == NULL)
+                    return -1;
+                check_error(H5Iinc_ref(object->id));
+                return object->id;
+            }
+
+            hid_t archivecontext::open_group(std::string const & path) {
+                ALPS_HDF5_LOCK_CACHE
+                cached_object * object = lookup(path, true);
+                if (object == NULL)
+                    return -1;
+                check_error(H5Iinc_ref(object->id));
+                return object->id;
+            }
+
+            data_space archivecontext::get_space(std::string const & path) {
+                ALPS_HDF5_LOCK_CACHE
+                cached_object * object = lookup(path, false);
+                if (object == NULL)
+                    throw path_not_found("the data does not exist: " + path + ALPS_STACKTRACE);
+                if (!object->has_space) {
+                    space_type space_id(H5Dget_space(object->id));
+                    object->space.type = H5Sget_simple_extent_type(space_id);
+                    if (object->space.type == H5S_NO_CLASS)
+                        throw archive_error("error reading class " + path + ALPS_STACKTRACE);
+                    object->space.extent.resize(check_error(H5Sget_simple_extent_ndims(space_id)));
+                    if (object->space.extent.size())
+                        check_error(H5Sget_simple_extent_dims(space_id, &object->space.extent.front(), NULL));
+                    object->has_space = true;
+                }
+                return object->space;
+            }
+
+            void archivecontext::invalidate(std::string const & path) {
+                ALPS_HDF5_LOCK_CACHE
+                for (std::map<std::string, cached_object>::iterator it = cache_.lower_bound(path); it != cache_.end() && it->first.compare(0, path.size(), path) == 0; )
+                    if (it->first.size() == path.size() || it->first[path.size()] == '/' || path[path.size() - 1] == '/') {
+                        check_error(H5Oclose(it->second.id));
+                        recent_.erase(it->second.position);
+                        cache_.erase(it++);
+                    } else
+                        ++it;
+            }
+
+            void archivecontext::invalidate_space(std::string const & path) {
+                ALPS_HDF5_LOCK_CACHE
+                std::map<std::string, cached_object>::iterator it = cache_.find(path);
+                if (it != cache_.end())
+                    it->second.has_space = false;
+            }
+
+            archivecontext::cached_object * archivecontext::lookup(std::string const & path, bool group) {
+                std::map<std::string, cached_object>::iterator it = cache_.find(path);
+                if (it != cache_.end()) {
+                    if (it->second.group != group)
+                        return NULL;
+                    recent_.splice(recent_.begin(), recent_, it->second.position);
+                    return &it->second;
+                }
+                hid_t id = group ? H5Gopen2(file_id_, path.c_str(), H5P_DEFAULT) : H5Dopen2(file_id_, path.c_str(), H5P_DEFAULT);
+                if (id < 0)
+                    return NULL;
+                while (!recent_.empty() && recent_.size() >= ALPS_HDF5_HANDLE_CACHE_SIZE) {
+                    it = cache_.find(recent_.back());
+                    check_error(H5Oclose(it->second.id));
+                    cache_.erase(it);
+                    recent_.pop_back();
+                }
+                recent_.push_front(path);
+                cached_object & object = cache_[path];
+                object.id = id;
+                object.group = group;
+                object.has_space = false;
+                object.position = recent_.begin();
+                return &object;
+            }
+
+            void archivecontext::clear_cache() {
+                ALPS_HDF5_LOCK_CACHE
+                for (std::map<std::string, cached_object>::iterator it = cache_.begin(); it != cache_.end(); ++it)
+                    H5Oclose(it->second.id);
+                cache_.clear();
+                recent_.clear();
             }
 
             void archivecontext::grant(bool write, bool replace) {
@@ -45,14 +188,32 @@ namespace alps {
 
             void archivecontext::construct() {
                 alps::signal::listen();
+                #ifdef H5_HAVE_PARALLEL
+                    if (mpio_) {
+                        property_type prop_id(H5Pcreate(H5P_FILE_ACCESS));
+                        check_error(H5Pset_fapl_mpio(prop_id, *comm_, MPI_INFO_NULL));
+                        if (write_) {
+                            if ((file_id_ = H5Fopen(filename_new_.c_str(), H5F_ACC_RDWR, prop_id)) < 0) {
+                                property_type fcrt_id(H5Pcreate(H5P_FILE_CREATE));
+                                check_error(H5Pset_link_creation_order(fcrt_id, (H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED)));
+                                check_error(H5Pset_attr_creation_order(fcrt_id, (H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED)));
+                                check_error(file_id_ = H5Fcreate(filename_new_.c_str(), H5F_ACC_TRUNC, fcrt_id, prop_id));
+                            }
+                        } else if ((file_id_ = H5Fopen(filename_new_.c_str(), H5F_ACC_RDONLY, prop_id)) < 0)
+                            throw archive_not_found("file does not exists or is not a valid hdf5 archive: " + filename_new_ + ALPS_STACKTRACE);
+                        check_error(transfer_id_ = H5Pcreate(H5P_DATASET_XFER));
+                        check_error(H5Pset_dxpl_mpio(transfer_id_, H5FD_MPIO_COLLECTIVE));
+                        return;
+                    }
+                #endif
                 if (memory_) {
                     property_type prop_id(H5Pcreate(H5P_FILE_ACCESS));
-                    check_error(H5Pset_fapl_core(prop_id, 1 << 20, true));
+                    check_error(H5Pset_fapl_core(prop_id, 1 << 20, !image_));
                     #ifndef ALPS_HDF5_CLOSE_GREEDY
                         check_error(H5Pset_fclose_degree(prop_id, H5F_CLOSE_SEMI));
                     #endif
                     if (write_) {
-                        if ((file_id_ = H5Fopen(filename_new_.c_str(), H5F_ACC_RDWR, prop_id)) < 0) {
+                        if (image_ || (file_id_ = H5Fopen(filename_new_.c_str(), H5F_ACC_RDWR, prop_id)) < 0) {
                             property_type fcrt_id(H5Pcreate(H5P_FILE_CREATE));
                             check_error(H5Pset_link_creation_order(fcrt_id, (H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED)));
                             check_error(H5Pset_attr_creation_order(fcrt_id, (H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED)));
@@ -106,6 +267,11 @@ namespace alps {
 
             void archivecontext::destruct(bool abort) {
                 try {
+                    clear_cache();
+                    if (transfer_id_ != H5P_DEFAULT) {
+                        H5Pclose(transfer_id_);
+                        transfer_id_ = H5P_DEFAULT;
+                    }
                     H5Fflush(file_id_, H5F_SCOPE_GLOBAL);
                     #ifndef ALPS_HDF5_CLOSE_GREEDY
                         if (
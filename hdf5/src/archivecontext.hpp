@@ -6,33 +6,101 @@
 
 #pragma once
 
+#include <list>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
+#ifndef ALPS_SINGLE_THREAD
+    #include <boost/thread.hpp>
+#endif
 
 #include <hdf5.h>
 
+#include <alps/hdf5/config.hpp>
+#ifdef ALPS_HAVE_MPI
+    #include <alps/utilities/mpi.hpp>
+#endif
+
 namespace alps {
     namespace hdf5 {
         namespace detail {
 
+            /// class and extent of the dataspace of a dataset
+            struct data_space {
+                H5S_class_t type;
+                std::vector<hsize_t> extent;
+            };
+
             struct archivecontext : boost::noncopyable {
 
-                    archivecontext(std::string const & filename, bool write, bool replace, bool compress, bool memory);
+                    archivecontext(std::string const & filename, bool write, bool replace, bool compress, bool memory, bool image = false);
+                    #ifdef ALPS_HAVE_MPI
+                        /// context of a file opened collectively by all processes of `comm`
+                        archivecontext(std::string const & filename, bool write, alps::mpi::communicator const & comm);
+                    #endif
                     ~archivecontext();
 
                     void grant(bool write, bool replace);
 
+                    /// whether the file is opened collectively by several processes
+                    bool collective() const;
+
+                    /// handle of the dataset `path`, or a negative value if there is no such dataset
+                    /** The datasets and groups accessed last are kept open in a cache. The returned handle
+                        is a new reference to the cached one, which the caller has to close (e.g. with
+                        detail::data_type), so it stays valid if the cache evicts it. */
+                    hid_t open_data(std::string const & path);
+                    /// handle of the group `path`, or a negative value if there is no such group, see open_data()
+                    hid_t open_group(std::string const & path);
+                    /// dataspace of the dataset `path`, cached along with its handle
+                    data_space get_space(std::string const & path);
+
+                    /// close the cached handles of `path` and of all paths below it, which are going to be deleted
+                    void invalidate(std::string const & path);
+                    /// forget the cached dataspace of the dataset `path`, whose extent has changed
+                    void invalidate_space(std::string const & path);
+
                     bool compress_;
                     bool write_;
                     bool replace_;
                     bool memory_;
+                    /// whether the file is only held in memory, without reading or writing it on disk
+                    bool image_;
                     std::string filename_;
                     std::string filename_new_;
                     hid_t file_id_;
+                    /// data transfer properties: collective MPI-IO for the mpio driver, default otherwise
+                    hid_t transfer_id_;
+                    /// whether the file is accessed through the MPI-IO driver
+                    bool mpio_;
 
                 private:
 
+                    struct cached_object {
+                        hid_t id;
+                        bool group;
+                        bool has_space;
+                        data_space space;
+                        std::list<std::string>::iterator position;
+                    };
+
+                    cached_object * lookup(std::string const & path, bool group);
+                    void clear_cache();
+
+                    /// open objects by path, and their paths from the most to the least recently used
+                    std::map<std::string, cached_object> cache_;
+                    std::list<std::string> recent_;
+                    #ifndef ALPS_SINGLE_THREAD
+                        boost::mutex cache_mutex_;
+                    #endif
+
+                    #ifdef ALPS_HAVE_MPI
+                        std::unique_ptr<alps::mpi::communicator> comm_;
+                    #endif
+
                     void construct();
                     void destruct(bool abort);
             };
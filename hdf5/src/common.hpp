@@ -6,13 +6,19 @@
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <sstream>
 #include <vector>
 
 #include <hdf5.h>
 
+#include <alps/hdf5/errors.hpp>
+#include <alps/utilities/stacktrace.hpp>
+
 #ifdef ALPS_SINGLE_THREAD
     #define ALPS_HDF5_LOCK_MUTEX
 #else
@@ -159,6 +165,26 @@ namespace alps {
             inline hid_t check_property(hid_t id) { property_type unused(id); return unused; }
             inline hid_t check_error(hid_t id) { error_type unused(id); return unused; }
 
+            /// chunk shape of a dataset of the given size: the leading dimensions of `chunk`, or halved until the chunk has at most `max_bytes`
+            inline std::vector<hsize_t> get_chunk_shape(std::vector<std::size_t> const & size, std::vector<std::size_t> const & chunk, std::size_t element_size, std::size_t max_bytes) {
+                if (chunk.size() > size.size())
+                    throw archive_error("the chunk has more dimensions than the data" + ALPS_STACKTRACE);
+                std::vector<hsize_t> shape(size.begin(), size.end());
+                for (std::size_t i = 0; i < shape.size(); ++i)
+                    shape[i] = std::max<hsize_t>(1, i < chunk.size() ? std::min<hsize_t>(chunk[i], shape[i]) : shape[i]);
+                if (chunk.empty()) {
+                    for (std::size_t index = 0; index < shape.size() && std::accumulate(
+                        shape.begin(), shape.end(), std::size_t(element_size), std::multiplies<std::size_t>()
+                    ) > max_bytes; ) {
+                        if (shape[index] > 1)
+                            shape[index] = (shape[index] + 1) / 2;
+                        else
+                            ++index;
+                    }
+                }
+                return shape;
+            }
+
             inline hid_t get_native_type(char) { return H5Tcopy(H5T_NATIVE_CHAR); }
             inline hid_t get_native_type(signed char) { return H5Tcopy(H5T_NATIVE_SCHAR); }
             inline hid_t get_native_type(unsigned char) { return H5Tcopy(H5T_NATIVE_UCHAR); }
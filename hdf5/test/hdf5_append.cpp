@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/hdf5.hpp>
+#include <alps/hdf5/vector.hpp>
+#include <alps/hdf5/complex.hpp>
+
+#include <gtest/gtest.h>
+#include <alps/testing/unique_file.hpp>
+
+#include <complex>
+#include <vector>
+
+TEST(hdf5, AppendScalars) {
+    alps::testing::unique_file ufile("append.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    std::vector<double> expected;
+    for (int i = 0; i < 3; ++i) {
+        // reopen the archive for each checkpoint
+        alps::hdf5::archive ar(ufile.name(), "a");
+        for (int j = 0; j < 1000; ++j) {
+            expected.push_back(0.5 * (1000 * i + j));
+            ar.append("/timeseries/data", expected.back());
+        }
+    }
+
+    alps::hdf5::archive ar(ufile.name());
+    EXPECT_EQ(std::vector<std::size_t>(1, 3000), ar.extent("/timeseries/data"));
+    std::vector<double> read;
+    ar["/timeseries/data"] >> read;
+    EXPECT_EQ(expected, read);
+}
+
+TEST(hdf5, AppendRows) {
+    alps::testing::unique_file ufile("append_rows.h5.", alps::testing::unique_file::REMOVE_NOW);
+    alps::hdf5::archive ar(ufile.name(), "w");
+    std::vector<std::vector<double> > expected;
+    for (int i = 0; i < 10; ++i) {
+        expected.push_back(std::vector<double>(4, i));
+        ar.append("/bins", expected.back());
+    }
+    // a block of rows
+    std::vector<double> block(2 * 4, 10.);
+    std::vector<std::size_t> size(2);
+    size[0] = 2;
+    size[1] = 4;
+    ar.append("/bins", &block.front(), size);
+    expected.resize(12, std::vector<double>(4, 10.));
+
+    std::vector<std::vector<double> > read;
+    ar["/bins"] >> read;
+    EXPECT_EQ(expected, read);
+
+    // the rows must have the same extent
+    EXPECT_THROW(ar.append("/bins", std::vector<double>(3, 1.)), alps::hdf5::archive_error);
+    EXPECT_THROW(ar.append("/bins", std::vector<double>()), alps::hdf5::archive_error);
+    // datasets written as a whole can not be extended
+    ar["/fixed"] << std::vector<double>(4, 1.);
+    EXPECT_THROW(ar.append("/fixed", 1.), alps::hdf5::archive_error);
+    // overwriting an appended dataset replaces it
+    ar["/bins"] << std::vector<double>(5, 1.);
+    EXPECT_EQ(std::vector<std::size_t>(1, 5), ar.extent("/bins"));
+}
+
+TEST(hdf5, AppendComplex) {
+    alps::testing::unique_file ufile("append_complex.h5.", alps::testing::unique_file::REMOVE_NOW);
+    alps::hdf5::archive ar(ufile.name(), "w");
+    alps::hdf5::write_options options;
+    options.deflate = 4;
+    ar.set_write_options(options, "/compressed");
+    std::vector<std::complex<double> > expected;
+    for (int i = 0; i < 100; ++i) {
+        expected.push_back(std::complex<double>(i, -i));
+        ar.append("/compressed/values", expected.back());
+    }
+    EXPECT_TRUE(ar.is_complex("/compressed/values"));
+    std::vector<std::complex<double> > read;
+    ar["/compressed/values"] >> read;
+    EXPECT_EQ(expected, read);
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/hdf5.hpp>
+#include <alps/hdf5/vector.hpp>
+
+#include <gtest/gtest.h>
+#include <alps/testing/unique_file.hpp>
+
+#include <fstream>
+#include <vector>
+
+TEST(hdf5, FileImage) {
+    alps::testing::unique_file ufile("image.h5.", alps::testing::unique_file::REMOVE_NOW);
+    std::vector<double> values(1000, 1.5);
+    std::vector<char> image;
+    {
+        alps::hdf5::archive ar(ufile.name(), "i");
+        ar["/values"] << values;
+        image = ar.file_image();
+    }
+    // the archive is not written to the disk
+    EXPECT_FALSE(std::ifstream(ufile.name().c_str()).good());
+    EXPECT_LT(values.size() * sizeof(double), image.size());
+
+    {
+        std::ofstream file(ufile.name().c_str(), std::ios::binary);
+        file.write(&image.front(), image.size());
+    }
+    alps::hdf5::archive ar(ufile.name());
+    std::vector<double> read;
+    ar["/values"] >> read;
+    EXPECT_EQ(values, read);
+}
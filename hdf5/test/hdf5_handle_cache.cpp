@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/hdf5.hpp>
+#include <alps/hdf5/vector.hpp>
+#include <alps/utilities/cast.hpp>
+
+#include <gtest/gtest.h>
+#include <alps/testing/unique_file.hpp>
+
+#include <string>
+#include <vector>
+
+// the archive keeps the datasets and groups it accessed open: changes of the file must be seen anyway
+TEST(hdf5, HandleCacheOverwriteAndDelete) {
+    alps::testing::unique_file ufile("cache.h5.", alps::testing::unique_file::REMOVE_NOW);
+    alps::hdf5::archive ar(ufile.name(), "w");
+
+    ar["/data/x"] << std::vector<double>(10, 1.);
+    EXPECT_TRUE(ar.is_data("/data/x"));
+    EXPECT_EQ(std::vector<std::size_t>(1, 10), ar.extent("/data/x"));
+
+    // recreated with a different extent and type
+    ar["/data/x"] << std::vector<int>(20, 2);
+    EXPECT_EQ(std::vector<std::size_t>(1, 20), ar.extent("/data/x"));
+    EXPECT_TRUE(ar.is_datatype<int>("/data/x"));
+    ar["/data/x"] << 3.;
+    EXPECT_TRUE(ar.is_scalar("/data/x"));
+    EXPECT_EQ(0u, ar.dimensions("/data/x"));
+
+    // replaced by a group and back
+    ar["/data/x/y"] << 4;
+    EXPECT_TRUE(ar.is_group("/data/x"));
+    EXPECT_FALSE(ar.is_data("/data/x"));
+    ar["/data/x"] << std::vector<double>(5, 5.);
+    EXPECT_FALSE(ar.is_group("/data/x"));
+    std::vector<double> x;
+    ar["/data/x"] >> x;
+    EXPECT_EQ(std::vector<double>(5, 5.), x);
+
+    ar.delete_group("/data");
+    EXPECT_FALSE(ar.is_data("/data/x"));
+    EXPECT_FALSE(ar.is_group("/data"));
+
+    // appending changes the extent of an open dataset
+    ar.append("/series", 1.);
+    EXPECT_EQ(std::vector<std::size_t>(1, 1), ar.extent("/series"));
+    ar.append("/series", 2.);
+    EXPECT_EQ(std::vector<std::size_t>(1, 2), ar.extent("/series"));
+}
+
+TEST(hdf5, HandleCacheManyDatasets) {
+    alps::testing::unique_file ufile("cache_many.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    // more datasets than handles are cached
+    std::size_t const n = 2 * ALPS_HDF5_HANDLE_CACHE_SIZE + 1;
+    {
+        alps::hdf5::archive ar(ufile.name(), "w");
+        for (std::size_t i = 0; i < n; ++i) {
+            std::string path = "/observables/o" + alps::cast<std::string>(i);
+            ar[path + "/mean"] << double(i);
+            ar[path + "/bins"] << std::vector<double>(i + 1, double(i));
+        }
+        // a copy of the archive shares the cache
+        alps::hdf5::archive copy(ar);
+        copy.delete_data("/observables/o1/mean");
+        EXPECT_FALSE(ar.is_data("/observables/o1/mean"));
+    }
+    alps::hdf5::archive ar(ufile.name());
+    for (std::size_t i = 0; i < n; ++i) {
+        std::string path = "/observables/o" + alps::cast<std::string>(i);
+        EXPECT_EQ(i != 1, ar.is_data(path + "/mean"));
+        EXPECT_EQ(std::vector<std::size_t>(1, i + 1), ar.extent(path + "/bins"));
+    }
+}
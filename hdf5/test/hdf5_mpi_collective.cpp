@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file hdf5_mpi_collective.cpp
+    Test writing and reading slices of common datasets by all processes */
+
+#include <alps/hdf5/archive.hpp>
+#include <alps/hdf5/vector.hpp>
+#include <alps/utilities/gtest_par_xml_output.hpp>
+#include <alps/testing/unique_file.hpp>
+
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(hdf5_mpi_collective, write_and_read_slices) {
+    alps::mpi::communicator comm;
+    std::string filename;
+    if (comm.rank() == 0)
+        filename = alps::testing::temporary_filename("hdf5_mpi_collective.h5.");
+    alps::mpi::broadcast(comm, filename, 0);
+    const std::size_t n = 3, rank = comm.rank(), nproc = comm.size();
+    std::vector<double> state(n);
+    for (std::size_t i = 0; i < n; ++i)
+        state[i] = 10. * rank + i;
+
+    {
+        alps::hdf5::archive ar(filename, comm, "w");
+        EXPECT_THROW(alps::hdf5::archive(filename, comm, "w"), alps::hdf5::archive_opened);
+        ar.write("/clones/state", &state.front(), std::vector<std::size_t>(1, n * nproc),
+                 std::vector<std::size_t>(1, n), std::vector<std::size_t>(1, n * rank));
+        ar["/clones/count"] << int(nproc);
+    }
+
+    // the common dataset holds the slices of all processes
+    if (rank == 0) {
+        alps::hdf5::archive ar(filename);
+        std::vector<double> all;
+        ar["/clones/state"] >> all;
+        ASSERT_EQ(n * nproc, all.size());
+        for (std::size_t r = 0; r < nproc; ++r)
+            for (std::size_t i = 0; i < n; ++i)
+                EXPECT_EQ(10. * r + i, all[n * r + i]);
+    }
+    comm.barrier();
+
+    {
+        alps::hdf5::archive ar(filename, comm);
+        int count;
+        ar["/clones/count"] >> count;
+        EXPECT_EQ(int(nproc), count);
+        std::vector<double> slice(n);
+        ar.read("/clones/state", &slice.front(), std::vector<std::size_t>(1, n), std::vector<std::size_t>(1, n * rank));
+        EXPECT_EQ(state, slice);
+    }
+
+    if (rank == 0)
+        std::remove(filename.c_str());
+}
+
+int main(int argc, char** argv)
+{
+    alps::mpi::environment env(argc, argv); // initializes MPI environment
+    alps::gtest_par_xml_output tweak;
+    tweak(alps::mpi::communicator().rank(), argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
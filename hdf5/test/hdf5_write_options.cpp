@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/hdf5.hpp>
+#include <alps/hdf5/vector.hpp>
+
+#include <gtest/gtest.h>
+#include <alps/testing/unique_file.hpp>
+
+#include <hdf5.h>
+
+#include <fstream>
+#include <vector>
+
+static std::size_t file_size(std::string const & filename) {
+    std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+    return file.tellg();
+}
+
+TEST(hdf5, WriteOptionsCompression) {
+    alps::testing::unique_file plain_file("plain.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    alps::testing::unique_file deflate_file("deflate.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    std::vector<double> values(100000);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = 0.25 * i;
+
+    {
+        alps::hdf5::archive ar(plain_file.name(), "w");
+        ar["/values"] << values;
+    }
+    alps::hdf5::write_options options;
+    options.deflate = 6;
+    options.shuffle = true;
+    {
+        alps::hdf5::archive ar(deflate_file.name(), "w");
+        ar.set_write_options(options);
+        ar["/values"] << values;
+        // filtered datasets are chunked
+        EXPECT_THROW(ar.data_offset("/values"), alps::hdf5::archive_error);
+    }
+    EXPECT_LT(4 * file_size(deflate_file.name()), file_size(plain_file.name()));
+
+    alps::hdf5::archive ar(deflate_file.name());
+    std::vector<double> read;
+    ar["/values"] >> read;
+    EXPECT_EQ(values, read);
+}
+
+// number of filters of the dataset `path`
+static int count_filters(std::string const & filename, std::string const & path) {
+    hid_t file_id = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t data_id = H5Dopen2(file_id, path.c_str(), H5P_DEFAULT);
+    hid_t prop_id = H5Dget_create_plist(data_id);
+    int count = H5Pget_nfilters(prop_id);
+    H5Pclose(prop_id);
+    H5Dclose(data_id);
+    H5Fclose(file_id);
+    return count;
+}
+
+TEST(hdf5, WriteOptionsCompressMode) {
+    alps::testing::unique_file ufile("compress.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    unsigned int flag = 0;
+    bool const szip = H5Zfilter_avail(H5Z_FILTER_SZIP) > 0
+                   && H5Zget_filter_info(H5Z_FILTER_SZIP, &flag) >= 0
+                   && (flag & H5Z_FILTER_CONFIG_ENCODE_ENABLED);
+    std::vector<double> values(10000, 1.);
+    {
+        alps::hdf5::archive ar(ufile.name(), "wc");
+        alps::hdf5::write_options options;
+        options.deflate = 6;
+        ar.set_write_options(options, "/deflate");
+        ar["/deflate/values"] << values;
+        ar["/plain/values"] << values;
+    }
+    // the write options replace SZIP instead of compressing twice
+    EXPECT_EQ(1, count_filters(ufile.name(), "/deflate/values"));
+    EXPECT_EQ(szip ? 1 : 0, count_filters(ufile.name(), "/plain/values"));
+}
+
+TEST(hdf5, WriteOptionsPerPath) {
+    alps::testing::unique_file ufile("options.h5.", alps::testing::unique_file::REMOVE_NOW);
+    alps::hdf5::archive ar(ufile.name(), "w");
+    alps::hdf5::write_options options;
+    options.deflate = 1;
+    options.chunk = std::vector<std::size_t>(1, 16);
+    ar.set_write_options(options, "/compressed");
+
+    EXPECT_EQ(1u, ar.get_write_options("/compressed/a/b").deflate);
+    EXPECT_EQ(0u, ar.get_write_options("/compressedx").deflate);
+    EXPECT_EQ(0u, ar.get_write_options("/plain").deflate);
+    ar.set_context("/compressed");
+    EXPECT_EQ(1u, ar.get_write_options("a").deflate);
+    ar.set_context("/");
+
+    // a 2D dataset is chunked along the first dimension only
+    std::vector<std::size_t> size(2);
+    size[0] = 1000;
+    size[1] = 7;
+    std::vector<double> values(size[0] * size[1]);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = i % 13;
+    ar.write("/compressed/matrix", &values.front(), size);
+    ar.write("/plain/matrix", &values.front(), size);
+    EXPECT_THROW(ar.data_offset("/compressed/matrix"), alps::hdf5::archive_error);
+    EXPECT_NO_THROW(ar.data_offset("/plain/matrix"));
+
+    std::vector<double> slice(2 * size[1]), expected(values.begin() + 500 * size[1], values.begin() + 502 * size[1]);
+    std::vector<std::size_t> chunk(2), offset(2);
+    chunk[0] = 2;
+    chunk[1] = size[1];
+    offset[0] = 500;
+    ar.read("/compressed/matrix", &slice.front(), chunk, offset);
+    EXPECT_EQ(expected, slice);
+
+    // small datasets are not chunked
+    ar["/compressed/small"] << std::vector<double>(100, 1.);
+    EXPECT_NO_THROW(ar.data_offset("/compressed/small"));
+    ar["/compressed/small"] << std::vector<double>(1000, 1.);
+    EXPECT_THROW(ar.data_offset("/compressed/small"), alps::hdf5::archive_error);
+
+    options.chunk = std::vector<std::size_t>(3, 16);
+    ar.set_write_options(options, "/compressed");
+    EXPECT_THROW(ar["/compressed/vector"] << std::vector<double>(1000, 1.), alps::hdf5::archive_error);
+    options.deflate = 10;
+    EXPECT_THROW(ar.set_write_options(options), alps::hdf5::archive_error);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#pragma once
+
+#include <alps/hdf5/archive.hpp>
+
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace alps {
+
+    /// Writes checkpoints to disk in a background thread
+    /** The checkpoint is first serialized into an HDF5 archive held in memory, which is quick
+        compared to writing it to the disk, and then written by a background thread to a
+        temporary file next to the checkpoint. The temporary file finally replaces the
+        checkpoint, so the checkpoint is complete at any time, even if the program is
+        killed while writing. The background thread makes no HDF5 calls. */
+    class checkpoint_writer : boost::noncopyable {
+
+        public:
+
+            typedef boost::function<void (alps::hdf5::archive &)> save_function_type;
+
+            checkpoint_writer();
+            /// waits for the checkpoint being written; its errors are printed
+            ~checkpoint_writer();
+
+            /// serialize the checkpoint by `save` now, and write it to `filename` in the background
+            /** Waits for the previous checkpoint first, rethrowing its errors. */
+            void write(std::string const & filename, save_function_type const & save);
+
+            /// waits for the checkpoint being written and rethrows its errors
+            void wait();
+
+        private:
+
+            /// writes `image` to a temporary file and renames it to `filename`
+            void publish(std::string const & filename, std::vector<char> const & image);
+
+            std::thread thread_;
+            std::exception_ptr error_;
+    };
+}
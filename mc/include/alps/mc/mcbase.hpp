@@ -10,20 +10,27 @@
 
 #include <alps/accumulators.hpp>
 #include <alps/params.hpp>
+#include "checkpoint_writer.hpp"
 #include "random01.hpp"
 
+#include <memory>
 #include <vector>
 #include <string>
 
 // move to alps::mcbase root scope
 namespace alps {
 
+    template<typename Base> class mcthreadadapter;
+
     class mcbase {
 
         protected:
 
             typedef alps::accumulators::accumulator_set observable_collection_type;
 
+            // merges the measurements of its clones
+            template<typename Base> friend class mcthreadadapter;
+
         public:
 
             typedef alps::params parameters_type;
@@ -38,24 +45,71 @@ namespace alps {
             virtual void update() = 0;
             virtual void measure() = 0;
             virtual double fraction_completed() const = 0;
+
             bool run(boost::function<bool ()> const & stop_callback);
 
+            /// Completes the simulation once the observable `name` has reached the relative error `relative_error`
+            /** The relative error is the largest one over the components, see
+                `accumulator_wrapper::relative_error()`; the observable needs an accumulator with errors. */
+            void set_target_error(std::string const & name, double relative_error);
+
+            /// Fraction completed estimated from the current and the target errors of the observables
+            /** To complete the simulation by the target errors, return it from `fraction_completed()`.
+
+                For each observable with a target error, the fraction is `(target / current)^2`, i.e., the
+                fraction of the measurements needed to reach the target. Summed over independent clones, as
+                done by `mcmpiadapter`, this estimates the fraction of the merged measurements. The result
+                is the smallest fraction of all observables.
+
+                An observable whose binning analysis has not converged, see
+                `accumulator_wrapper::error_converged()`, underestimates its error and counts as fraction 0,
+                so that the fractions summed by `mcmpiadapter` do not complete the simulation early.
+
+                The errors are re-evaluated only after the number of measurements has grown by 1/64, and
+                are considered unreliable below 256 measurements, as needed by the binning analysis. */
+            double error_fraction_completed() const;
+
             result_names_type result_names() const;
             result_names_type unsaved_result_names() const;
             results_type collect_results() const;
             results_type collect_results(result_names_type const & names) const;
 
+            /// Saves a checkpoint to `filename`, after waiting for the one written by `save_async()`
             void save(std::string const & filename) const;
+            /// Loads a checkpoint from `filename`, after waiting for the one written by `save_async()`
             void load(std::string const & filename);
             virtual void save(alps::hdf5::archive & ar) const;
             virtual void load(alps::hdf5::archive & ar);
 
+            /// Saves a checkpoint as `save(filename)`, writing the file in the background
+            /** The state is serialized into memory before returning, so the simulation can continue
+                while the file is written; see `checkpoint_writer`. The previous checkpoint is waited
+                for first. The file is replaced only once it has been written completely. */
+            void save_async(std::string const & filename) const;
+            /// Waits for the checkpoint written by `save_async()`, rethrowing its errors
+            void wait_checkpoint() const;
+
         protected:
 
             parameters_type parameters;
             // parameters_type & params; // TODO: deprecated, remove!
             alps::random01 random;
             observable_collection_type measurements;
+
+            /// writer of the checkpoints saved by `save_async()`
+            checkpoint_writer & async_writer() const;
+
+        private:
+
+            struct target_error {
+                std::string name;
+                double relative_error;
+                // cache of the last evaluation
+                boost::uint64_t count;
+                double fraction;
+            };
+            mutable std::vector<target_error> target_errors;
+            mutable std::shared_ptr<checkpoint_writer> writer;
     };
 
     
@@ -8,6 +8,9 @@
 
 #include <boost/function.hpp>
 #include <boost/utility/enable_if.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
 
 #include <alps/config.hpp>
 
@@ -60,26 +63,94 @@ namespace alps {
                 return !stopped;
             }
 
+            /// Runs the simulation, checking the progress without waiting for the other processes
+            /** The stop flag and the fraction completed are summed over the processes by one
+                non-blocking `MPI_Iallreduce`. The simulation continues while the reduction is
+                in flight, and acts on its result as soon as it has arrived; the next reduction
+                is started at the next check of the schedule.
+
+                The simulation stops when any process asks to stop, so `stop_callback` need not
+                agree between the processes and should not communicate itself, e.g.
+                `alps::stop_callback(timelimit)` rather than `alps::stop_callback(comm, timelimit)`.
+                The processes may do a few more sweeps than with `run()`.
+
+                If the simulation throws on some processes, they complete the reduction in flight and
+                report their failure in the next one, after which all processes stop: the exception is
+                rethrown, and the other processes throw `std::runtime_error`. The communicator can then
+                be used again.
+
+                @returns `false` if stopped by the callback, as `run()`
+            */
+            bool run_nonblocking(boost::function<bool ()> const & stop_callback) {
+                // {number of processes asking to stop, fraction completed, number of failed processes}
+                double local[3] = {0., 0., 0.}, global[3] = {0., 0., 0.};
+                MPI_Request request = MPI_REQUEST_NULL;
+                bool done = false, stopped = false;
+                try {
+                    do {
+                        this->update();
+                        this->measure();
+                        if (request != MPI_REQUEST_NULL) {
+                            int arrived = 0;
+                            alps::mpi::checked(MPI_Test(&request, &arrived, MPI_STATUS_IGNORE));
+                            if (arrived) {
+                                // All processes see the same sums, so they stop after the same reduction
+                                if (global[2] > 0.)
+                                    throw std::runtime_error("The simulation failed on another MPI process");
+                                stopped = global[0] > 0.;
+                                schedule_checker.update(fraction = global[1]);
+                                done = stopped || fraction >= 1.;
+                            }
+                        } else if (schedule_checker.pending()) {
+                            local[0] = stop_callback() ? 1. : 0.;
+                            local[1] = Base::fraction_completed();
+                            alps::mpi::checked(MPI_Iallreduce(local, global, 3, MPI_DOUBLE, MPI_SUM, communicator, &request));
+                        }
+                    } while(!done);
+                } catch (...) {
+                    // The other processes keep reducing until they see a failure: complete the reduction in
+                    // flight, and unless all processes stop after it, report the failure in one more
+                    if (request != MPI_REQUEST_NULL)
+                        MPI_Wait(&request, MPI_STATUS_IGNORE);
+                    if (!(global[0] > 0. || global[1] >= 1. || global[2] > 0.)) {
+                        local[2] = 1.;
+                        MPI_Iallreduce(local, global, 3, MPI_DOUBLE, MPI_SUM, communicator, &request);
+                        MPI_Wait(&request, MPI_STATUS_IGNORE);
+                    }
+                    throw;
+                }
+                return !stopped;
+            }
+
             typename Base::results_type collect_results() const {
                 return collect_results(this->result_names());
             }
 
             typename Base::results_type collect_results(typename Base::result_names_type const & names) const {
                 typename Base::results_type partial_results;
-                for(typename Base::result_names_type::const_iterator it = names.begin(); it != names.end(); ++it) {
-                    size_t has_count=(this->measurements[*it].count() > 0);
-                    const size_t sum_counts =
-                            alps::mpi::all_reduce(communicator,
-                                                  has_count,
-                                                  std::plus<size_t>());
-                    if (static_cast<int>(sum_counts) == communicator.size()) {
-                        typename Base::observable_collection_type::value_type merged = this->measurements[*it];
-                        merged.collective_merge(communicator, 0);
-                        partial_results.insert(*it, merged.result());
-                    } else if (sum_counts > 0 && static_cast<int>(sum_counts) < communicator.size()) {
-                        throw std::runtime_error(*it + " was measured on only some of the MPI processes.");
+                if (names.empty())
+                    return partial_results;
+
+                std::vector<size_t> has_count(names.size()), sum_counts(names.size());
+                for (std::size_t i = 0; i < names.size(); ++i)
+                    has_count[i] = (this->measurements[names[i]].count() > 0);
+                alps::mpi::all_reduce(communicator, &has_count.front(), has_count.size(), &sum_counts.front(), std::plus<size_t>());
+
+                // The merged accumulators share their state with the measurements, as in accumulator_wrapper::collective_merge()
+                typename Base::observable_collection_type merged;
+                for (std::size_t i = 0; i < names.size(); ++i) {
+                    if (static_cast<int>(sum_counts[i]) == communicator.size()) {
+                        typedef typename Base::observable_collection_type::value_type accumulator_type;
+                        merged.insert(names[i], boost::shared_ptr<accumulator_type>(new accumulator_type(this->measurements[names[i]])));
+                    } else if (sum_counts[i] > 0 && static_cast<int>(sum_counts[i]) < communicator.size()) {
+                        throw std::runtime_error(names[i] + " was measured on only some of the MPI processes.");
                     }
                 }
+
+                // All accumulators are merged with a fixed number of collective operations
+                merged.collective_merge(communicator, 0);
+                for (typename Base::observable_collection_type::const_iterator it = merged.begin(); it != merged.end(); ++it)
+                    partial_results.insert(it->first, it->second->result());
                 return partial_results;
             }
 
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#pragma once
+
+#include <alps/mc/mcbase.hpp>
+#include <alps/hdf5/archive.hpp>
+#include <alps/utilities/stacktrace.hpp>
+
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace alps {
+
+    /// Runs several independent clones of an MC simulation class in threads of one process
+    /** The clones are constructed as `Base(parameters, seed_offset)` (the same way as by
+        `mcmpiadapter`), so each clone has its own random number stream. As with
+        `mcmpiadapter`, the work is shared between the clones: the fraction completed is the
+        sum of the fractions of the clones, and all clones run until it reaches 1.
+
+        The `stop_callback` and the fractions of the clones are checked periodically by the
+        calling thread only, so the callback need not be thread-safe. The results are
+        obtained by merging the accumulators of all clones.
+
+        Example:
+        @code
+            alps::mcthreadadapter<my_sim_type> sim(parameters, nthreads);
+            sim.run(alps::stop_callback(timelimit));
+            alps::results_type<my_sim_type>::type results = alps::collect_results(sim);
+        @endcode
+    */
+    template<typename Base> class mcthreadadapter {
+
+        public:
+            typedef typename Base::parameters_type parameters_type;
+            typedef typename Base::result_names_type result_names_type;
+            typedef typename Base::results_type results_type;
+
+            /// Constructs `nclones` clones; clone `k` gets the seed offset `seed_offset * nclones + k`
+            mcthreadadapter(parameters_type const & parameters, std::size_t nclones, std::size_t seed_offset = 0)
+                : fraction(0.)
+                , check_interval(std::chrono::milliseconds(10))
+            {
+                if (nclones == 0)
+                    throw std::invalid_argument("At least one clone is needed" + ALPS_STACKTRACE);
+                for (std::size_t k = 0; k < nclones; ++k)
+                    clones.push_back(boost::shared_ptr<Base>(new Base(parameters, seed_offset * nclones + k)));
+            }
+
+            static parameters_type & define_parameters(parameters_type & parameters) {
+                return Base::define_parameters(parameters);
+            }
+
+            /// Number of clones
+            std::size_t num_clones() const { return clones.size(); }
+
+            /// Returns the clone `k`
+            Base & clone(std::size_t k) { return *clones.at(k); }
+
+            /// Returns the clone `k`
+            Base const & clone(std::size_t k) const { return *clones.at(k); }
+
+            /// Sum of the fractions completed by the clones, as of the last check
+            double fraction_completed() const {
+                return fraction;
+            }
+
+            /// Runs all clones until the fraction completed reaches 1 or `stop_callback` returns `true`
+            /** @returns `false` if stopped by the callback, as `mcbase::run()` */
+            bool run(boost::function<bool ()> const & stop_callback) {
+                fraction = sum_fractions();
+                bool stopped = stop_callback();
+                if (stopped || fraction >= 1.)
+                    return !stopped;
+
+                std::atomic<bool> stop(false);
+                std::vector<std::atomic<double> > fractions(clones.size());
+                std::vector<std::exception_ptr> errors(clones.size());
+                for (std::size_t k = 0; k < clones.size(); ++k)
+                    fractions[k] = clones[k]->fraction_completed();
+
+                std::vector<std::thread> threads;
+                try {
+                    for (std::size_t k = 0; k < clones.size(); ++k)
+                        threads.push_back(std::thread([this, k, &stop, &fractions, &errors]() {
+                            try {
+                                while (!stop.load(std::memory_order_relaxed)) {
+                                    clones[k]->update();
+                                    clones[k]->measure();
+                                    fractions[k].store(clones[k]->fraction_completed(), std::memory_order_relaxed);
+                                }
+                            } catch (...) {
+                                errors[k] = std::current_exception();
+                                stop = true;
+                            }
+                        }));
+
+                    while (!stop) {
+                        std::this_thread::sleep_for(check_interval);
+                        fraction = 0.;
+                        for (std::size_t k = 0; k < clones.size(); ++k)
+                            fraction += fractions[k].load(std::memory_order_relaxed);
+                        if ((stopped = stop_callback()) || fraction >= 1.)
+                            stop = true;
+                    }
+                } catch (...) {
+                    // joinable threads must not be destroyed while unwinding
+                    stop = true;
+                    for (std::size_t k = 0; k < threads.size(); ++k)
+                        threads[k].join();
+                    throw;
+                }
+                for (std::size_t k = 0; k < threads.size(); ++k)
+                    threads[k].join();
+
+                fraction = sum_fractions();
+                for (std::size_t k = 0; k < errors.size(); ++k)
+                    if (errors[k])
+                        std::rethrow_exception(errors[k]);
+                return !stopped;
+            }
+
+            result_names_type result_names() const {
+                return clones.front()->result_names();
+            }
+
+            result_names_type unsaved_result_names() const {
+                return clones.front()->unsaved_result_names();
+            }
+
+            results_type collect_results() const {
+                return collect_results(result_names());
+            }
+
+            /// Merges the accumulators of all clones and returns their results
+            results_type collect_results(result_names_type const & names) const {
+                results_type partial_results;
+                for (typename result_names_type::const_iterator it = names.begin(); it != names.end(); ++it) {
+                    boost::shared_ptr<alps::accumulators::accumulator_wrapper> merged(measurements(0)[*it].new_clone());
+                    for (std::size_t k = 1; k < clones.size(); ++k)
+                        merged->merge(measurements(k)[*it]);
+                    partial_results.insert(*it, merged->result());
+                }
+                return partial_results;
+            }
+
+            /// Saves all clones under `/simulation/realizations/0/clones/<k>`
+            void save(std::string const & filename) const {
+                wait_checkpoint();
+                alps::hdf5::archive ar(filename, "w");
+                ar["/simulation/realizations/0"] << *this;
+            }
+
+            /// Loads all clones from `/simulation/realizations/0/clones/<k>`
+            void load(std::string const & filename) {
+                wait_checkpoint();
+                alps::hdf5::archive ar(filename);
+                ar["/simulation/realizations/0"] >> *this;
+            }
+
+            /// Saves all clones as `save(filename)`, writing the file in the background, see `mcbase::save_async()`
+            void save_async(std::string const & filename) const {
+                // the checkpoints are written by the writer of the first clone
+                static_cast<mcbase const &>(*clones.front()).async_writer().write(filename, [this](alps::hdf5::archive & ar) {
+                    ar["/simulation/realizations/0"] << *this;
+                });
+            }
+
+            /// Waits for the checkpoint written by `save_async()`, rethrowing its errors
+            void wait_checkpoint() const {
+                clones.front()->wait_checkpoint();
+            }
+
+            void save(alps::hdf5::archive & ar) const {
+                for (std::size_t k = 0; k < clones.size(); ++k)
+                    ar["clones/" + std::to_string(k)] << *clones[k];
+            }
+
+            void load(alps::hdf5::archive & ar) {
+                for (std::size_t k = 0; k < clones.size(); ++k) {
+                    std::string const path = "clones/" + std::to_string(k);
+                    if (!ar.is_group(path))
+                        throw std::runtime_error("The checkpoint has no clone " + std::to_string(k) + ALPS_STACKTRACE);
+                    ar[path] >> *clones[k];
+                }
+            }
+
+        private:
+            double sum_fractions() const {
+                double sum = 0.;
+                for (std::size_t k = 0; k < clones.size(); ++k)
+                    sum += clones[k]->fraction_completed();
+                return sum;
+            }
+
+            mcbase::observable_collection_type const & measurements(std::size_t k) const {
+                return static_cast<mcbase const &>(*clones[k]).measurements;
+            }
+
+            std::vector<boost::shared_ptr<Base> > clones;
+            double fraction;
+            std::chrono::milliseconds check_interval;
+    };
+
+}
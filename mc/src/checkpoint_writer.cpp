@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/mc/checkpoint_writer.hpp>
+
+#include <alps/utilities/stacktrace.hpp>
+#include <alps/utilities/temporary_filename.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace alps {
+
+    checkpoint_writer::checkpoint_writer() {}
+
+    checkpoint_writer::~checkpoint_writer() {
+        try {
+            wait();
+        } catch (std::exception & ex) {
+            std::cerr << "Error writing checkpoint: " << ex.what() << std::endl;
+        }
+    }
+
+    void checkpoint_writer::write(std::string const & filename, save_function_type const & save) {
+        wait();
+        std::vector<char> image;
+        {
+            // the archive only exists in memory
+            alps::hdf5::archive ar(filename, "i");
+            save(ar);
+            image = ar.file_image();
+        }
+        thread_ = std::thread(&checkpoint_writer::publish, this, filename, std::move(image));
+    }
+
+    void checkpoint_writer::wait() {
+        if (thread_.joinable())
+            thread_.join();
+        if (error_) {
+            std::exception_ptr error = error_;
+            error_ = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+    }
+
+    void checkpoint_writer::publish(std::string const & filename, std::vector<char> const & image) {
+        std::string tmpname;
+        try {
+            // the temporary file has to be on the same file system for the renaming to be atomic
+            tmpname = temporary_filename((filename.find('/') == std::string::npos ? "./" : "") + filename + ".");
+            int fd = ::open(tmpname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+            if (fd < 0)
+                throw std::runtime_error("Cannot create file '" + tmpname + "': " + std::strerror(errno) + ALPS_STACKTRACE);
+            for (std::size_t written = 0; written < image.size(); ) {
+                ssize_t n = ::write(fd, &image[written], image.size() - written);
+                if (n < 0 && errno != EINTR) {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot write file '" + tmpname + "': " + std::strerror(errno) + ALPS_STACKTRACE);
+                }
+                written += n < 0 ? 0 : n;
+            }
+            bool synced = ::fsync(fd) == 0;
+            if (::close(fd) != 0 || !synced)
+                throw std::runtime_error("Cannot write file '" + tmpname + "': " + std::strerror(errno) + ALPS_STACKTRACE);
+            if (std::rename(tmpname.c_str(), filename.c_str()) != 0)
+                throw std::runtime_error("Cannot rename '" + tmpname + "' to '" + filename + "': " + std::strerror(errno) + ALPS_STACKTRACE);
+        } catch (...) {
+            if (!tmpname.empty())
+                std::remove(tmpname.c_str());
+            error_ = std::current_exception();
+        }
+    }
+}
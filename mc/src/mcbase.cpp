@@ -5,8 +5,14 @@
  */
 
 #include <alps/utilities/signal.hpp>
+#include <alps/utilities/stacktrace.hpp>
 #include <alps/mc/mcbase.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
 namespace alps {
 
     mcbase::mcbase(parameters_type const & parms, std::size_t seed_offset)
@@ -20,16 +26,36 @@ namespace alps {
         return parameters.define<long>("SEED", 42, "PRNG seed");
     }
 
-  void mcbase::save(std::string const & filename) const {
+    void mcbase::save(std::string const & filename) const {
+        // a pending asynchronous checkpoint would replace the file afterwards
+        wait_checkpoint();
         alps::hdf5::archive ar(filename, "w");
         ar["/simulation/realizations/0/clones/0"] << *this;
     }
 
     void mcbase::load(std::string const & filename) {
+        wait_checkpoint();
         alps::hdf5::archive ar(filename);
         ar["/simulation/realizations/0/clones/0"] >> *this;
     }
 
+    void mcbase::save_async(std::string const & filename) const {
+        async_writer().write(filename, [this](alps::hdf5::archive & ar) {
+            ar["/simulation/realizations/0/clones/0"] << *this;
+        });
+    }
+
+    void mcbase::wait_checkpoint() const {
+        if (writer)
+            writer->wait();
+    }
+
+    checkpoint_writer & mcbase::async_writer() const {
+        if (!writer)
+            writer.reset(new checkpoint_writer());
+        return *writer;
+    }
+
     bool mcbase::run(boost::function<bool ()> const & stop_callback) {
         bool stopped = false;
         while(!(stopped = stop_callback()) && fraction_completed() < 1.) {
@@ -39,6 +65,51 @@ namespace alps {
         return !stopped;
     }
 
+    void mcbase::set_target_error(std::string const & name, double relative_error) {
+        if (!(relative_error > 0.))
+            throw std::invalid_argument("The target error of " + name + " must be positive" + ALPS_STACKTRACE);
+        if (!measurements.has(name))
+            throw std::invalid_argument("No observable " + name + " to set a target error for" + ALPS_STACKTRACE);
+        target_error target = { name, relative_error, 0, 0. };
+        for (std::vector<target_error>::iterator it = target_errors.begin(); it != target_errors.end(); ++it)
+            if (it->name == name) {
+                *it = target;
+                return;
+            }
+        target_errors.push_back(target);
+    }
+
+    double mcbase::error_fraction_completed() const {
+        // the binning analysis needs 2^8 bins for a reliable error
+        static const boost::uint64_t min_count = 256;
+
+        if (target_errors.empty())
+            throw std::logic_error("No target errors are set: call set_target_error() first" + ALPS_STACKTRACE);
+        double fraction = std::numeric_limits<double>::infinity();
+        for (std::vector<target_error>::iterator it = target_errors.begin(); it != target_errors.end(); ++it) {
+            boost::uint64_t count = measurements[it->name].count();
+            if (count >= min_count && count >= it->count + std::max<boost::uint64_t>(1, it->count / 64)) {
+                double current = measurements[it->name].relative_error();
+                it->count = count;
+                if (!measurements[it->name].error_converged())
+                    // the error is underestimated until the bins are longer than the autocorrelation time
+                    it->fraction = 0.;
+                else if (current == 0.)
+                    it->fraction = std::numeric_limits<double>::infinity();
+                else if (std::isfinite(current))
+                    it->fraction = (it->relative_error / current) * (it->relative_error / current);
+                else
+                    it->fraction = 0.;
+            } else if (count < it->count) {
+                // the measurements have been reset or reloaded
+                it->count = 0;
+                it->fraction = 0.;
+            }
+            fraction = std::min(fraction, it->fraction);
+        }
+        return fraction;
+    }
+
     // implement a nice keys(m) function
     mcbase::result_names_type mcbase::result_names() const {
         result_names_type names;
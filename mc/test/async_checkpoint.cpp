@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/mc/api.hpp>
+#include <alps/mc/mcbase.hpp>
+
+#include <alps/testing/unique_file.hpp>
+
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+// Simulation to measure x
+class my_sim_type : public alps::mcbase {
+
+    public:
+
+        my_sim_type(parameters_type const & params, std::size_t seed_offset = 42)
+            : alps::mcbase(params, seed_offset)
+        {
+            measurements << alps::accumulators::FullBinningAccumulator<double>("SValue");
+        }
+
+        void update() {
+            value = random();
+        }
+
+        void measure() {
+            measurements["SValue"] << value;
+        }
+
+        double fraction_completed() const {
+            return 0;
+        }
+
+        void sweep(int n) {
+            for (int i = 0; i < n; ++i) {
+                update();
+                measure();
+            }
+        }
+
+        boost::uint64_t count() const {
+            return measurements["SValue"].count();
+        }
+
+    private:
+        double value;
+};
+
+TEST(mc, async_checkpoint) {
+    alps::testing::unique_file ufile("async_checkpoint.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    alps::parameters_type<my_sim_type>::type params;
+    my_sim_type::define_parameters(params);
+    my_sim_type sim(params);
+
+    sim.sweep(1000);
+    sim.save(ufile.name());
+    sim.sweep(1000);
+    sim.save_async(ufile.name());
+    // the snapshot is taken when save_async() returns
+    sim.sweep(1000);
+    sim.wait_checkpoint();
+
+    my_sim_type loaded(params);
+    loaded.load(ufile.name());
+    EXPECT_EQ(2000u, loaded.count());
+
+    // a new checkpoint waits for the previous one
+    sim.save_async(ufile.name());
+    sim.sweep(1000);
+    sim.save_async(ufile.name());
+    sim.wait_checkpoint();
+    loaded.load(ufile.name());
+    EXPECT_EQ(4000u, loaded.count());
+    EXPECT_DOUBLE_EQ(sim.collect_results()["SValue"].mean<double>(), loaded.collect_results()["SValue"].mean<double>());
+}
+
+TEST(mc, async_then_sync_checkpoint) {
+    alps::testing::unique_file ufile("async_checkpoint.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    alps::parameters_type<my_sim_type>::type params;
+    my_sim_type::define_parameters(params);
+    my_sim_type sim(params);
+
+    // the older background checkpoint must not replace the newer one
+    sim.sweep(100000);
+    sim.save_async(ufile.name());
+    sim.sweep(1000);
+    sim.save(ufile.name());
+
+    my_sim_type loaded(params);
+    loaded.load(ufile.name());
+    EXPECT_EQ(101000u, loaded.count());
+
+    // loading waits for the checkpoint being written, rather than reading the previous one
+    sim.sweep(1000);
+    sim.save_async(ufile.name());
+    sim.sweep(1000);
+    sim.load(ufile.name());
+    EXPECT_EQ(102000u, sim.count());
+}
+
+TEST(mc, async_checkpoint_error) {
+    alps::parameters_type<my_sim_type>::type params;
+    my_sim_type::define_parameters(params);
+    my_sim_type sim(params);
+    sim.sweep(10);
+    sim.save_async("/nonexistent-directory/checkpoint.h5");
+    EXPECT_THROW(sim.wait_checkpoint(), std::runtime_error);
+    // the error is reported only once
+    EXPECT_NO_THROW(sim.wait_checkpoint());
+}
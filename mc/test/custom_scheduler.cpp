@@ -50,6 +50,73 @@ TEST(CustomScheduler,Run) {
     EXPECT_EQ(sim_type::MAXCOUNT+0, sim.count());
 }
 
+TEST(CustomScheduler,RunNonblocking) {
+    typedef alps::mcmpiadapter<my_sim_type,my_schecker_type> sim_type;
+    alps::mpi::communicator comm;
+    alps::params p;
+    sim_type::define_parameters(p);
+
+    sim_type sim(p, comm, my_schecker_type());
+    EXPECT_TRUE(sim.run_nonblocking(stop_callback));
+
+    // the processes do not sweep in lockstep, but at least one of them has completed
+    EXPECT_LE(1., sim.fraction_completed());
+    EXPECT_LE(sim_type::MAXCOUNT+0, alps::mpi::all_reduce(comm, sim.count(), alps::mpi::maximum<int>()));
+}
+
+TEST(CustomScheduler,StopNonblocking) {
+    typedef alps::mcmpiadapter<my_sim_type,my_schecker_type> sim_type;
+    alps::mpi::communicator comm;
+    alps::params p;
+    sim_type::define_parameters(p);
+
+    // only the last process asks to stop, but all of them stop
+    sim_type sim(p, comm, my_schecker_type());
+    const bool is_last=(comm.rank()==comm.size()-1);
+    EXPECT_FALSE(sim.run_nonblocking([is_last]() { return is_last; }));
+}
+
+// Simulation that throws in the update of the given sweep, and never completes
+class failing_sim_type : public my_sim_type {
+    int _throw_count;
+  public:
+    failing_sim_type(const parameters_type& p, std::size_t offset=0) : my_sim_type(p,offset), _throw_count(-1) {}
+
+    void throw_at(int count) { _throw_count=count; }
+
+    void update() {
+        my_sim_type::update();
+        if (count()==_throw_count)
+            throw std::logic_error("update failed");
+    }
+
+    double fraction_completed() const { return 0; }
+};
+
+TEST(CustomScheduler,ExceptionNonblocking) {
+    typedef alps::mcmpiadapter<failing_sim_type,my_schecker_type> sim_type;
+    alps::mpi::communicator comm;
+    alps::params p;
+    sim_type::define_parameters(p);
+
+    // the first process fails, the others would run forever
+    sim_type sim(p, comm, my_schecker_type());
+    if (comm.rank()==0) {
+        sim.throw_at(50);
+        EXPECT_THROW(sim.run_nonblocking(stop_callback), std::logic_error);
+    } else {
+        EXPECT_THROW(sim.run_nonblocking(stop_callback), std::runtime_error);
+    }
+    // no reduction is left in flight
+    EXPECT_EQ(comm.size(), alps::mpi::all_reduce(comm, 1, std::plus<int>()));
+
+    // all processes fail at the same sweep, unless they learn of the failure of another one first
+    sim_type all(p, comm, my_schecker_type());
+    all.throw_at(50);
+    EXPECT_ANY_THROW(all.run_nonblocking(stop_callback));
+    EXPECT_EQ(comm.size(), alps::mpi::all_reduce(comm, 1, std::plus<int>()));
+}
+
 TEST(CustomScheduler,Params) {
     typedef alps::mcmpiadapter<my_sim_type,my_schecker_type> sim_type;
     alps::mpi::communicator comm;
@@ -134,6 +134,47 @@ TEST(mc, sum_mpi){
             collect_results(my_sim);
 }
 
+// The same simulation, completed by the error of the merged results
+class error_sim_type : public my_sim_type {
+    public:
+        error_sim_type(parameters_type const & params, std::size_t seed_offset)
+            : my_sim_type(params, seed_offset)
+        {
+            set_target_error("SValue", 0.002);
+        }
+
+        double fraction_completed() const {
+            return error_fraction_completed();
+        }
+};
+
+// Checks after every sweep
+struct every_sweep_schedule {
+    bool pending() const { return true; }
+    void update(double /*fraction*/) {}
+};
+
+TEST(mc, target_error_mpi){
+        alps::mpi::communicator c;
+
+        alps::mcbase::parameters_type params;
+        params["COUNT"]=1;
+        error_sim_type::define_parameters(params);
+        params.broadcast(c, 0);
+
+        typedef alps::mcmpiadapter<error_sim_type, every_sweep_schedule> sim_type;
+        sim_type my_sim(params, c, every_sweep_schedule());
+        EXPECT_TRUE(my_sim.run(alps::stop_callback(c, 300)));
+
+        alps::results_type<sim_type>::type results = alps::collect_results(my_sim);
+        if (c.rank() == 0) {
+            // the fractions of the processes add up to the fraction of the merged results
+            const double rel_error=results["SValue"].error<double>()/results["SValue"].mean<double>();
+            EXPECT_LE(rel_error, 0.002*1.05);
+            EXPECT_GT(rel_error, 0.002*0.8);
+        }
+}
+
 int main(int argc, char** argv)
 {
    alps::mpi::environment env(argc, argv, false);
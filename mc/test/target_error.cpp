@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/mc/api.hpp>
+#include <alps/mc/mcbase.hpp>
+#include <alps/mc/stop_callback.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+// Simulation to measure 1+x, completed by the error of its observables
+class my_sim_type : public alps::mcbase {
+
+    public:
+
+        my_sim_type(parameters_type const & params, std::size_t seed_offset = 42)
+            : alps::mcbase(params, seed_offset)
+        {
+            measurements << alps::accumulators::FullBinningAccumulator<double>("SValue")
+                         << alps::accumulators::LogBinningAccumulator<std::vector<double> >("VValue")
+                         << alps::accumulators::MeanAccumulator<double>("Mean");
+        }
+
+        void update() {
+            value = 1 + random();
+        }
+
+        void measure() {
+            measurements["SValue"] << value;
+            std::vector<double> vvalue(2, value);
+            vvalue[1] = 2 * value - 1;
+            measurements["VValue"] << vvalue;
+            measurements["Mean"] << value;
+        }
+
+        double fraction_completed() const {
+            return error_fraction_completed();
+        }
+
+    private:
+        double value;
+};
+
+TEST(mc, target_error){
+    alps::parameters_type<my_sim_type>::type params;
+    my_sim_type::define_parameters(params);
+    my_sim_type sim(params);
+
+    // the relative error of 1+x after N measurements is about 0.19/sqrt(N)
+    const double target = 0.002;
+    sim.set_target_error("SValue", target);
+    EXPECT_EQ(0., sim.fraction_completed());
+    EXPECT_TRUE(sim.run(alps::stop_callback(60)));
+
+    alps::results_type<my_sim_type>::type results = alps::collect_results(sim);
+    const double rel_error = results["SValue"].error<double>() / results["SValue"].mean<double>();
+    EXPECT_LE(rel_error, target);
+    EXPECT_GT(rel_error, 0.9 * target);
+    EXPECT_NEAR(1.5, results["SValue"].mean<double>(), 10 * target);
+}
+
+TEST(mc, target_error_slowest){
+    alps::parameters_type<my_sim_type>::type params;
+    my_sim_type::define_parameters(params);
+    my_sim_type sim(params);
+
+    // the second component 2x has the larger relative error and determines the completion
+    sim.set_target_error("SValue", 0.01);
+    sim.set_target_error("VValue", 0.004);
+    EXPECT_TRUE(sim.run(alps::stop_callback(60)));
+
+    alps::results_type<my_sim_type>::type results = alps::collect_results(sim);
+    std::vector<double> mean = results["VValue"].mean<std::vector<double> >();
+    std::vector<double> error = results["VValue"].error<std::vector<double> >();
+    EXPECT_LE(error[1] / mean[1], 0.004);
+    EXPECT_GT(error[1] / mean[1], 0.9 * 0.004);
+    EXPECT_LT(error[0] / mean[0], 0.004);
+    EXPECT_LT(results["SValue"].error<double>() / results["SValue"].mean<double>(), 0.005);
+}
+
+// Simulation whose value changes only every 1024 sweeps
+class correlated_sim_type : public my_sim_type {
+
+    public:
+
+        correlated_sim_type(parameters_type const & params)
+            : my_sim_type(params)
+            , sweeps(0)
+        {}
+
+        void update() {
+            if (sweeps++ % 1024 == 0)
+                my_sim_type::update();
+        }
+
+    private:
+        unsigned long sweeps;
+};
+
+TEST(mc, target_error_not_converged){
+    alps::parameters_type<correlated_sim_type>::type params;
+    correlated_sim_type::define_parameters(params);
+    correlated_sim_type sim(params);
+
+    // 16 independent values have a relative error of about 0.05, but the
+    // binning analysis with bins of 128 measurements estimates about 0.017
+    sim.set_target_error("SValue", 0.03);
+    for (int i = 0; i < (1 << 14); ++i) {
+        sim.update();
+        sim.measure();
+    }
+    alps::results_type<correlated_sim_type>::type results = alps::collect_results(sim);
+    EXPECT_LT(results["SValue"].error<double>() / results["SValue"].mean<double>(), 0.03);
+    // the error is underestimated since the binning analysis has not converged
+    EXPECT_EQ(0., sim.fraction_completed());
+}
+
+TEST(mc, target_error_invalid){
+    alps::parameters_type<my_sim_type>::type params;
+    my_sim_type::define_parameters(params);
+    my_sim_type sim(params);
+
+    EXPECT_THROW(sim.fraction_completed(), std::logic_error);
+    EXPECT_THROW(sim.set_target_error("Unknown", 0.01), std::invalid_argument);
+    EXPECT_THROW(sim.set_target_error("SValue", 0.), std::invalid_argument);
+
+    sim.set_target_error("Mean", 0.01);
+    for (int i = 0; i < 1000; ++i) {
+        sim.update();
+        sim.measure();
+    }
+    // a mean accumulator has no error
+    EXPECT_ANY_THROW(sim.fraction_completed());
+}
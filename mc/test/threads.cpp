@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/mc/api.hpp>
+#include <alps/mc/mcbase.hpp>
+#include <alps/mc/threadadapter.hpp>
+#include <alps/mc/stop_callback.hpp>
+
+#include <alps/testing/unique_file.hpp>
+
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+// Simulation to measure e^(-x*x)
+class my_sim_type : public alps::mcbase {
+
+    public:
+
+        my_sim_type(parameters_type const & params, std::size_t seed_offset = 42)
+            : alps::mcbase(params, seed_offset)
+            , count(0)
+            , total_count(params["COUNT"])
+            , first_value(-1)
+            , do_throw(params["THROW"])
+        {
+            measurements << alps::accumulators::FullBinningAccumulator<double>("SValue")
+                         << alps::accumulators::FullBinningAccumulator<std::vector<double> >("VValue");
+        }
+
+        void update() {
+            double x = random();
+            value = exp(-x * x);
+            if (first_value < 0) first_value = value;
+            if (do_throw && count == 10)
+                throw std::runtime_error("update failed");
+        }
+
+        void measure() {
+            ++count;
+            measurements["SValue"] << value;
+            measurements["VValue"] << std::vector<double>(3, value);
+        }
+
+        double fraction_completed() const {
+            return count / double(total_count);
+        }
+
+        void save(alps::hdf5::archive & ar) const {
+            alps::mcbase::save(ar);
+            ar["checkpoint/count"] << count;
+        }
+
+        void load(alps::hdf5::archive & ar) {
+            alps::mcbase::load(ar);
+            ar["checkpoint/count"] >> count;
+        }
+
+        int get_count() const { return count; }
+        double get_first_value() const { return first_value; }
+
+    private:
+        int count;
+        int total_count;
+        double value;
+        double first_value;
+        bool do_throw;
+};
+
+typedef alps::mcthreadadapter<my_sim_type> sim_type;
+
+static alps::parameters_type<sim_type>::type make_params(int count, bool do_throw = false) {
+    alps::parameters_type<sim_type>::type params;
+    sim_type::define_parameters(params);
+    params.define<bool>("THROW", false, "Throw an exception in the update");
+    params["COUNT"] = count;
+    params["THROW"] = do_throw;
+    return params;
+}
+
+TEST(mc, threads_run){
+    alps::parameters_type<sim_type>::type params = make_params(4000);
+    sim_type sim(params, 4);
+    ASSERT_EQ(4u, sim.num_clones());
+    EXPECT_TRUE(sim.run(alps::simple_time_callback(60)));
+    EXPECT_GE(sim.fraction_completed(), 1.);
+
+    // each clone has its own random stream
+    for (std::size_t k = 1; k < sim.num_clones(); ++k)
+        EXPECT_NE(sim.clone(0).get_first_value(), sim.clone(k).get_first_value());
+
+    int total = 0;
+    for (std::size_t k = 0; k < sim.num_clones(); ++k)
+        total += sim.clone(k).get_count();
+    EXPECT_GE(total, 1000);
+
+    alps::results_type<sim_type>::type results = alps::collect_results(sim);
+    EXPECT_EQ(total, int(results["SValue"].count()));
+    EXPECT_EQ(total, int(results["VValue"].count()));
+    EXPECT_NEAR(0.7468, results["SValue"].mean<double>(), 10 * results["SValue"].error<double>() + 0.01);
+    EXPECT_GT(results["SValue"].error<double>(), 0.);
+}
+
+TEST(mc, threads_stopped){
+    alps::parameters_type<sim_type>::type params = make_params(1000000000);
+    sim_type sim(params, 2);
+    EXPECT_FALSE(sim.run(alps::simple_time_callback(1)));
+    EXPECT_LT(sim.fraction_completed(), 1.);
+}
+
+TEST(mc, threads_exception){
+    alps::parameters_type<sim_type>::type params = make_params(1000000000, true);
+    sim_type sim(params, 3);
+    EXPECT_THROW(sim.run(alps::simple_time_callback(60)), std::runtime_error);
+}
+
+TEST(mc, threads_callback_exception){
+    alps::parameters_type<sim_type>::type params = make_params(1000000000);
+    sim_type sim(params, 2);
+    // the first check runs before the threads start; count the calls to fail in the monitoring loop
+    int calls = 0;
+    boost::function<bool ()> callback = [&calls]() -> bool {
+        if (++calls > 1)
+            throw std::runtime_error("stop callback failed");
+        return false;
+    };
+    EXPECT_THROW(sim.run(callback), std::runtime_error);
+    EXPECT_EQ(2, calls);
+}
+
+TEST(mc, threads_checkpoint){
+    alps::testing::unique_file ufile("threads.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    alps::parameters_type<sim_type>::type params = make_params(400);
+
+    sim_type sim(params, 2);
+    sim.run(alps::simple_time_callback(60));
+    sim.save(ufile.name());
+    alps::results_type<sim_type>::type saved = alps::collect_results(sim);
+
+    sim_type restored(params, 2);
+    restored.load(ufile.name());
+    for (std::size_t k = 0; k < sim.num_clones(); ++k)
+        EXPECT_EQ(sim.clone(k).get_count(), restored.clone(k).get_count());
+    alps::results_type<sim_type>::type loaded = alps::collect_results(restored);
+    EXPECT_EQ(saved["SValue"].count(), loaded["SValue"].count());
+    EXPECT_NEAR(saved["SValue"].mean<double>(), loaded["SValue"].mean<double>(), 1e-12);
+
+    // a checkpoint with fewer clones cannot be loaded
+    sim_type bigger(params, 3);
+    EXPECT_THROW(bigger.load(ufile.name()), std::runtime_error);
+
+    // all clones are saved by the background writer as well
+    sim.save_async(ufile.name());
+    sim.wait_checkpoint();
+    sim_type async_restored(params, 2);
+    async_restored.load(ufile.name());
+    for (std::size_t k = 0; k < sim.num_clones(); ++k)
+        EXPECT_EQ(sim.clone(k).get_count(), async_restored.clone(k).get_count());
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file inplace_functions.hpp
+    In-place arithmetic kernels that do not create temporaries.
+
+    The generic versions fall back to the ordinary operators; the
+    std::vector versions work elementwise on the storage of the left-hand
+    side and do not allocate, provided the left-hand side already has the
+    right size.
+*/
+
+#ifndef ALPS_NUMERIC_INPLACE_FUNCTIONS_HEADER
+#define ALPS_NUMERIC_INPLACE_FUNCTIONS_HEADER
+
+#include <alps/utilities/stacktrace.hpp>
+
+#include <boost/throw_exception.hpp>
+
+#include <vector>
+#include <stdexcept>
+
+namespace alps {
+    namespace numeric {
+
+        namespace detail {
+            inline void check_same_size(std::size_t lsz, std::size_t rsz) {
+                if (lsz != rsz)
+                    boost::throw_exception(std::runtime_error("std::vectors have different sizes: left="
+                                                              + std::to_string(lsz) + " right=" + std::to_string(rsz)
+                                                              + "\n" + ALPS_STACKTRACE));
+            }
+        }
+
+        //------------------- set_zero -------------------
+        /// Sets `a` to zero
+        template<typename T>
+        inline void set_zero(T & a) {
+            a = T();
+        }
+
+        /// Sets all elements of `a` to zero, keeping its size (and storage)
+        template<typename T>
+        inline void set_zero(std::vector<T> & a) {
+            for (typename std::vector<T>::iterator it = a.begin(); it != a.end(); ++it)
+                set_zero(*it);
+        }
+
+        //------------------- add_square -------------------
+        /// Adds `x*x` to `a`
+        template<typename T, typename U>
+        inline void add_square(T & a, U const & x) {
+            a += x * x;
+        }
+
+        /// Adds the elementwise square of `x` to `a`; the sizes must match
+        template<typename T, typename U>
+        inline void add_square(std::vector<T> & a, std::vector<U> const & x) {
+            detail::check_same_size(a.size(), x.size());
+            for (std::size_t i = 0; i < a.size(); ++i)
+                add_square(a[i], x[i]);
+        }
+
+        //------------------- assign_divided -------------------
+        /// Assigns `x/d` to `a`
+        template<typename T, typename U, typename S>
+        inline void assign_divided(T & a, U const & x, S const & d) {
+            a = x / d;
+        }
+
+        /// Assigns `x/d` to `a` elementwise, resizing `a` to the size of `x`
+        template<typename T, typename U, typename S>
+        inline void assign_divided(std::vector<T> & a, std::vector<U> const & x, S const & d) {
+            a.resize(x.size());
+            for (std::size_t i = 0; i < a.size(); ++i)
+                assign_divided(a[i], x[i], d);
+        }
+
+        //------------------- assign_sum_divided -------------------
+        /// Assigns `(x+y)/d` to `a`
+        template<typename T, typename U, typename S>
+        inline void assign_sum_divided(T & a, U const & x, U const & y, S const & d) {
+            a = (x + y) / d;
+        }
+
+        /// Assigns `(x+y)/d` to `a` elementwise, resizing `a` to the size of `x`; `a` may alias `x` or `y`
+        template<typename T, typename U, typename S>
+        inline void assign_sum_divided(std::vector<T> & a, std::vector<U> const & x, std::vector<U> const & y, S const & d) {
+            detail::check_same_size(x.size(), y.size());
+            a.resize(x.size());
+            for (std::size_t i = 0; i < a.size(); ++i)
+                assign_sum_divided(a[i], x[i], y[i], d);
+        }
+
+    }
+}
+
+#endif
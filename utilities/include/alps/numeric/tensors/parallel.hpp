@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#ifndef ALPSCORE_GF_TENSOR_PARALLEL_H
+#define ALPSCORE_GF_TENSOR_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace alps {
+  namespace numerics {
+
+    /**
+     * @brief Execution policy of the element-wise operations and reductions of tensors.
+     *
+     * Tensors with at least threshold() elements are split into contiguous chunks, which are
+     * processed by up to num_threads() threads; smaller tensors are processed serially by the
+     * calling thread. The settings are global and may be changed at any time.
+     */
+    class tensor_parallel_policy {
+    public:
+      /// Maximal number of threads, by default the number of hardware threads
+      static unsigned num_threads() { return threads_().load(std::memory_order_relaxed); }
+      /// Set the maximal number of threads; 1 disables the parallel execution
+      static void set_num_threads(unsigned nthreads) { threads_().store(std::max(1u, nthreads), std::memory_order_relaxed); }
+
+      /// Minimal number of elements for the parallel execution
+      static size_t threshold() { return threshold_().load(std::memory_order_relaxed); }
+      /// Set the minimal number of elements for the parallel execution
+      static void set_threshold(size_t threshold) { threshold_().store(threshold, std::memory_order_relaxed); }
+
+    private:
+      static std::atomic<unsigned> &threads_() {
+        static std::atomic<unsigned> nthreads(std::max(1u, std::thread::hardware_concurrency()));
+        return nthreads;
+      }
+      static std::atomic<size_t> &threshold_() {
+        static std::atomic<size_t> threshold(size_t(1) << 20);
+        return threshold;
+      }
+    };
+
+    namespace detail {
+      /// Number of chunks of a tensor with n elements, according to tensor_parallel_policy
+      inline size_t parallel_chunk_count(size_t n) {
+        return n < tensor_parallel_policy::threshold() ? 1 : std::max<size_t>(1, std::min<size_t>(tensor_parallel_policy::num_threads(), n));
+      }
+
+      /**
+       * Calls f(k, begin, end) for the chunks k=0..nchunks-1 covering [0, n), each in its own thread.
+       * The first chunk is processed by the calling thread, as are the chunks for which no thread can be
+       * started. All threads are joined before the first exception thrown by f is rethrown.
+       */
+      template<typename F>
+      void for_each_chunk(size_t n, size_t nchunks, F f) {
+        std::vector<std::exception_ptr> errors(nchunks);
+        auto run = [&f, &errors](size_t k, size_t begin, size_t end) {
+          try {
+            f(k, begin, end);
+          } catch (...) {
+            errors[k] = std::current_exception();
+          }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(nchunks);
+        for (size_t k = 1; k < nchunks; ++k) {
+          try {
+            threads.push_back(std::thread(run, k, n * k / nchunks, n * (k + 1) / nchunks));
+          } catch (const std::system_error &) {
+            run(k, n * k / nchunks, n * (k + 1) / nchunks);
+          }
+        }
+        run(size_t(0), size_t(0), n / nchunks);
+        for (std::thread &thread : threads) {
+          thread.join();
+        }
+        for (const std::exception_ptr &error : errors) {
+          if (error) {
+            std::rethrow_exception(error);
+          }
+        }
+      }
+
+      /// Calls f(begin, end) for contiguous chunks covering [0, n), in parallel according to tensor_parallel_policy
+      template<typename F>
+      void parallel_chunks(size_t n, F f) {
+        for_each_chunk(n, parallel_chunk_count(n), [&f](size_t, size_t begin, size_t end) { f(begin, end); });
+      }
+
+      /**
+       * Calls f(begin, end) for contiguous chunks covering [0, n), where processing all of [0, n) costs about as
+       * much as `work` tensor elements: the range is split as a tensor of `work` elements, into at most n chunks.
+       */
+      template<typename F>
+      void parallel_chunks(size_t n, size_t work, F f) {
+        for_each_chunk(n, std::min(parallel_chunk_count(work), std::max<size_t>(n, 1)),
+                       [&f](size_t, size_t begin, size_t end) { f(begin, end); });
+      }
+
+      /**
+       * Reduces [0, n) in parallel chunks: each chunk computes part(begin, end), and the parts are combined by
+       * combine(a, b), starting from init.
+       */
+      template<typename R, typename Part, typename Combine>
+      R parallel_reduce(size_t n, R init, Part part, Combine combine) {
+        std::vector<R> parts(parallel_chunk_count(n), init);
+        for_each_chunk(n, parts.size(), [&parts, &part](size_t k, size_t begin, size_t end) { parts[k] = part(begin, end); });
+        R result = init;
+        for (const R &p : parts) {
+          result = combine(result, p);
+        }
+        return result;
+      }
+    }
+  }
+}
+
+#endif //ALPSCORE_GF_TENSOR_PARALLEL_H
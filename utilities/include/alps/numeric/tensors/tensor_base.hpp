@@ -8,7 +8,9 @@
 #define ALPSCORE_GF_TENSOR_H
 
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <iostream>
 #include <numeric>
 #include <type_traits>
@@ -20,6 +22,7 @@
 #include <alps/type_traits/index_sequence.hpp>
 #include <alps/type_traits/are_all_integrals.hpp>
 #include <alps/numeric/tensors/data_view.hpp>
+#include <alps/numeric/tensors/parallel.hpp>
 
 
 namespace alps {
@@ -62,6 +65,53 @@ namespace alps {
       template<typename X, int Rows = Eigen::Dynamic, int Cols = Eigen::Dynamic>
       using ConstMatrixMap =  Eigen::Map <const Eigen::Matrix < X, Rows, Cols, Eigen::RowMajor > >;
 
+      /**
+       * In-place inverse of the n x n row-major matrix at `data`. Matrices up to 4 x 4 use
+       * fixed-size Eigen types with closed-form inverses.
+       */
+      template<typename T>
+      void invert_matrix(T *data, size_t n) {
+        switch (n) {
+          case 1: { MatrixMap < T, 1, 1 > M(data); M = M.inverse().eval(); break; }
+          case 2: { MatrixMap < T, 2, 2 > M(data); M = M.inverse().eval(); break; }
+          case 3: { MatrixMap < T, 3, 3 > M(data); M = M.inverse().eval(); break; }
+          case 4: { MatrixMap < T, 4, 4 > M(data); M = M.inverse().eval(); break; }
+          default: { MatrixMap < T > M(data, n, n); M = M.partialPivLu().inverse(); }
+        }
+      }
+
+      /**
+       * Product c=a*b of the n x m row-major matrix `a` and the m x p row-major matrix `b`.
+       * Square matrices up to 4 x 4 use fixed-size Eigen types.
+       */
+      template<typename T>
+      void multiply_matrices(const T *a, const T *b, T *c, size_t n, size_t m, size_t p) {
+        if (n == m && m == p) {
+          switch (n) {
+            case 1: { c[0] = a[0] * b[0]; return; }
+            case 2: { MatrixMap < T, 2, 2 >(c).noalias() = ConstMatrixMap < T, 2, 2 >(a) * ConstMatrixMap < T, 2, 2 >(b); return; }
+            case 3: { MatrixMap < T, 3, 3 >(c).noalias() = ConstMatrixMap < T, 3, 3 >(a) * ConstMatrixMap < T, 3, 3 >(b); return; }
+            case 4: { MatrixMap < T, 4, 4 >(c).noalias() = ConstMatrixMap < T, 4, 4 >(a) * ConstMatrixMap < T, 4, 4 >(b); return; }
+            default: break;
+          }
+        }
+        MatrixMap < T >(c, n, p).noalias() = ConstMatrixMap < T >(a, n, m) * ConstMatrixMap < T >(b, m, p);
+      }
+
+      /**
+       * Calls f(k) for the batch indices k=0..nbatch-1 of a tensor with `size` elements, in parallel
+       * chunks according to tensor_parallel_policy.
+       */
+      template<typename F>
+      void parallel_batches(size_t nbatch, size_t size, F f) {
+        const size_t nchunks = std::max<size_t>(1, std::min(parallel_chunk_count(size), nbatch));
+        for_each_chunk(nbatch, nchunks, [&f](size_t, size_t begin, size_t end) {
+          for (size_t k = begin; k < end; ++k) {
+            f(k);
+          }
+        });
+      }
+
       /**
        * @brief Tensor class for raw data storage and performing the basic arithmetic operations
        *
@@ -260,8 +310,12 @@ namespace alps {
         template<typename S>
         typename std::enable_if < !std::is_same < S, tensorType >::value, tType & >::type operator*=(S scalar) {
           static_assert(std::is_convertible<S, T>::value, "Can't perform inplace multiplication: S can be casted into T");
-          Eigen::Map < Eigen::Matrix < T, 1, Eigen::Dynamic > > M(&storage_.data(0), storage_.size());
-          M *= T(scalar);
+          T *data = &storage_.data(0);
+          const T factor(scalar);
+          parallel_chunks(storage_.size(), [data, factor](size_t begin, size_t end) {
+            MatrixMap < T, 1, Eigen::Dynamic > M(data + begin, end - begin);
+            M *= factor;
+          });
           return *this;
         };
 
@@ -270,9 +324,16 @@ namespace alps {
          */
         template<typename S>
         typename std::enable_if < std::is_same < S, tensorType >::value, tensorType & >::type operator*=(const S& rhs) {
-          Eigen::Map < Eigen::Array < T, 1, Eigen::Dynamic > > M1(&storage_.data(0), storage_.size());
-          Eigen::Map < const Eigen::Array < T, 1, Eigen::Dynamic > > M2(&rhs.storage().data(0), rhs.storage().size());
-          M1*=M2;
+          if (shape_ != rhs.shape()) {
+            throw std::invalid_argument("Can not do multiplication. Dimensions missmatches.");
+          }
+          T *data1 = &storage_.data(0);
+          const T *data2 = &rhs.storage().data(0);
+          parallel_chunks(storage_.size(), [data1, data2](size_t begin, size_t end) {
+            Eigen::Map < Eigen::Array < T, 1, Eigen::Dynamic > > M1(data1 + begin, end - begin);
+            Eigen::Map < const Eigen::Array < T, 1, Eigen::Dynamic > > M2(data2 + begin, end - begin);
+            M1*=M2;
+          });
           return *this;
         };
 
@@ -292,17 +353,43 @@ namespace alps {
         template<typename S>
         typename std::enable_if < !std::is_same < S, tensorType >::value, tType & >::type operator/=(S scalar) {
           static_assert(std::is_convertible<S, T>::value, "Can not perform inplace division: S can be casted into T");
-          Eigen::Map < Eigen::Matrix < T, 1, Eigen::Dynamic > > M(&storage_.data(0), storage_.size());
-          M *= T(1.0)/T(scalar);
-          return *this;
+          return (*this *= T(1.0)/T(scalar));
         };
 
         /**
          * Set data to 0
          */
         void set_zero() {
-          Eigen::Map < Eigen::Matrix < T, 1, Eigen::Dynamic > > M(&storage_.data(0), storage_.size());
-          M.setZero();
+          T *data = &storage_.data(0);
+          parallel_chunks(storage_.size(), [data](size_t begin, size_t end) {
+            MatrixMap < T, 1, Eigen::Dynamic > M(data + begin, end - begin);
+            M.setZero();
+          });
+        }
+
+        /**
+         * @return largest absolute value of the elements
+         */
+        double max_abs() const {
+          const T *data = &storage_.data(0);
+          return parallel_reduce(storage_.size(), 0.0, [data](size_t begin, size_t end) {
+            double r = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+              r = std::max(r, double(std::abs(data[i])));
+            }
+            return r;
+          }, [](double a, double b) { return std::max(a, b); });
+        }
+
+        /**
+         * @return Frobenius norm, the square root of the sum of the squared absolute values of the elements
+         */
+        double frobenius_norm() const {
+          const T *data = &storage_.data(0);
+          return std::sqrt(parallel_reduce(storage_.size(), 0.0, [data](size_t begin, size_t end) {
+            ConstMatrixMap < T, 1, Eigen::Dynamic > M(data + begin, end - begin);
+            return double(M.squaredNorm());
+          }, [](double a, double b) { return a + b; }));
         }
 
         /**
@@ -362,9 +449,16 @@ namespace alps {
         typename std::enable_if <
           std::is_same < S, T >::value || std::is_same < T, std::complex < double>>::value
           || std::is_same < T, std::complex < float>>::value, tType & >::type operator+=(const tensor_base < S, Dim, Ct > &y) {
-          MatrixMap < T, 1, Eigen::Dynamic > M1(&storage_.data(0), storage_.size());
-          ConstMatrixMap < S, 1, Eigen::Dynamic > M2(&y.storage().data(0), y.storage().size());
-          M1.noalias() += M2;
+          if (shape_ != y.shape()) {
+            throw std::invalid_argument("Can not do addition. Dimensions missmatches.");
+          }
+          T *data1 = &storage_.data(0);
+          const S *data2 = &y.storage().data(0);
+          parallel_chunks(storage_.size(), [data1, data2](size_t begin, size_t end) {
+            MatrixMap < T, 1, Eigen::Dynamic > M1(data1 + begin, end - begin);
+            ConstMatrixMap < S, 1, Eigen::Dynamic > M2(data2 + begin, end - begin);
+            M1.noalias() += M2;
+          });
           return (*this);
         };
 
@@ -374,9 +468,16 @@ namespace alps {
         template<typename S>
         typename std::enable_if < std::is_same < S, tensorType >::value ||
             std::is_same < S, tensorViewType >::value, tType & >::type operator-=(const S &y) {
-          MatrixMap < T, 1, Eigen::Dynamic > M1(&storage_.data(0), storage_.size());
-          ConstMatrixMap < T, 1, Eigen::Dynamic> M2(&y.storage().data(0), y.storage().size());
-          M1.noalias() -= M2;
+          if (shape_ != y.shape()) {
+            throw std::invalid_argument("Can not do subtraction. Dimensions missmatches.");
+          }
+          T *data1 = &storage_.data(0);
+          const T *data2 = &y.storage().data(0);
+          parallel_chunks(storage_.size(), [data1, data2](size_t begin, size_t end) {
+            MatrixMap < T, 1, Eigen::Dynamic > M1(data1 + begin, end - begin);
+            ConstMatrixMap < T, 1, Eigen::Dynamic> M2(data2 + begin, end - begin);
+            M1.noalias() -= M2;
+          });
           return (*this);
         };
 
@@ -396,6 +497,52 @@ namespace alps {
           return x;
         };
 
+        /**
+         * Batched matrix product. The last two dimensions of both tensors are matrices, and the leading
+         * dimensions, which must be the same, index a batch of independent products. The batch is
+         * processed in parallel chunks according to tensor_parallel_policy.
+         *
+         * @param y - tensor of the right-hand side matrices
+         * @return tensor of the products
+         */
+        template<typename Ct>
+        tensorType batched_dot(const tensor_base < T, Dim, Ct > &y) const {
+          static_assert(Dim >= 2, "Can not do batched multiplication for tensors of less than 2 dimensions.");
+          if (!std::equal(shape_.begin(), shape_.end() - 2, y.shape().begin()) || shape_[Dim - 1] != y.shape()[Dim - 2]) {
+            throw std::invalid_argument("Can not do batched multiplication. Dimensions missmatches.");
+          }
+          std::array < size_t, Dim > shape(shape_);
+          shape[Dim - 1] = y.shape()[Dim - 1];
+          tensorType x(shape);
+          const size_t n = shape_[Dim - 2], m = shape_[Dim - 1], p = shape[Dim - 1];
+          const T *a = data(), *b = y.data();
+          T *c = x.data();
+          parallel_batches(size() / std::max<size_t>(1, n * m), size(), [=](size_t k) {
+            multiply_matrices(a + k * n * m, b + k * m * p, c + k * n * p, n, m, p);
+          });
+          return x;
+        }
+
+        /**
+         * Batched inverse of the square matrices of the last two dimensions, indexed by the leading dimensions.
+         * The batch is processed in parallel chunks according to tensor_parallel_policy.
+         *
+         * @return tensor of the inverse matrices
+         */
+        tensorType batched_inverse() const {
+          static_assert(Dim >= 2, "Can not do batched inversion for tensors of less than 2 dimensions.");
+          if (shape_[Dim - 2] != shape_[Dim - 1]) {
+            throw std::invalid_argument("Can not do inversion of the non-square matrix.");
+          }
+          tensorType x(*this);
+          const size_t n = shape_[Dim - 1];
+          T *c = x.data();
+          parallel_batches(size() / std::max<size_t>(1, n * n), size(), [=](size_t k) {
+            invert_matrix(c + k * n * n, n);
+          });
+          return x;
+        }
+
         /**
          * @return Eigen matrix representation for 2D Tensor
          */
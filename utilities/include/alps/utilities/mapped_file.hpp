@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#ifndef ALPS_UTILITIES_MAPPED_FILE_HPP
+#define ALPS_UTILITIES_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace alps {
+    /// Memory mapping of a region of a file
+    /**
+       The pages of the region are read from the file on first access, so only
+       the parts that are actually used occupy memory.
+
+       The mapping is private: the mapped data may be modified, but the changes
+       are never written back to the file. The file should not be modified while
+       it is mapped.
+    */
+    class mapped_file {
+      public:
+        /// Map `length` bytes of the file, starting at byte `offset`
+        mapped_file(const std::string& filename, std::size_t offset, std::size_t length);
+
+        /// Map the whole file
+        explicit mapped_file(const std::string& filename);
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        mapped_file(mapped_file&& rhs) noexcept;
+        mapped_file& operator=(mapped_file&& rhs) noexcept;
+
+        ~mapped_file();
+
+        /// Start of the mapped region; null for an empty region
+        void* data() const { return data_; }
+
+        /// Size of the mapped region in bytes
+        std::size_t size() const { return size_; }
+
+        /// Name of the mapped file
+        const std::string& filename() const { return filename_; }
+
+      private:
+        void unmap();
+
+        std::string filename_;
+        void* base_;
+        std::size_t base_size_;
+        void* data_;
+        std::size_t size_;
+    };
+}
+#endif /* ALPS_UTILITIES_MAPPED_FILE_HPP */
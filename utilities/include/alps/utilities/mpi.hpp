@@ -89,6 +89,16 @@ namespace alps {
         } // detail::
 
 
+        /// Exception thrown when a raw MPI call does not return `MPI_SUCCESS`
+        struct failed_operation : std::exception { };
+
+        /// Throws `failed_operation` if the return code of a raw MPI call signals an error
+        inline void checked(int retcode)
+        {
+            if (retcode != MPI_SUCCESS)
+                throw failed_operation();
+        }
+
         /// Possible ways to make a C++ object from MPI communicator
         enum comm_create_kind {
             comm_attach, ///< do not destroy when going out of scope
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/utilities/mapped_file.hpp>
+#include <alps/utilities/stacktrace.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace alps {
+    namespace {
+        /// Open file descriptor, closed on destruction
+        struct file_descriptor {
+            explicit file_descriptor(const std::string& filename) : fd(::open(filename.c_str(), O_RDONLY)) {
+                if (fd<0)
+                    throw std::runtime_error("Cannot open file '" + filename + "': " + std::strerror(errno) + ALPS_STACKTRACE);
+            }
+            ~file_descriptor() { ::close(fd); }
+            int fd;
+        };
+
+        std::size_t file_size(const std::string& filename) {
+            struct stat st;
+            if (::stat(filename.c_str(), &st)!=0)
+                throw std::runtime_error("Cannot stat file '" + filename + "': " + std::strerror(errno) + ALPS_STACKTRACE);
+            return st.st_size;
+        }
+    }
+
+    mapped_file::mapped_file(const std::string& filename, std::size_t offset, std::size_t length)
+        : filename_(filename), base_(nullptr), base_size_(0), data_(nullptr), size_(length)
+    {
+        file_descriptor file(filename);
+        if (offset+length > file_size(filename))
+            throw std::runtime_error("The region to map exceeds the size of the file '" + filename + "'" + ALPS_STACKTRACE);
+        if (length==0) return;
+
+        // the offset of a mapping must be a multiple of the page size
+        const std::size_t page=::sysconf(_SC_PAGESIZE);
+        const std::size_t shift=offset % page;
+        base_size_=length+shift;
+        base_=::mmap(nullptr, base_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, file.fd, offset-shift);
+        if (base_==MAP_FAILED) {
+            base_=nullptr;
+            throw std::runtime_error("Cannot map file '" + filename + "': " + std::strerror(errno) + ALPS_STACKTRACE);
+        }
+        data_=static_cast<char*>(base_)+shift;
+    }
+
+    mapped_file::mapped_file(const std::string& filename)
+        : mapped_file(filename, 0, file_size(filename))
+    {}
+
+    mapped_file::mapped_file(mapped_file&& rhs) noexcept
+        : filename_(std::move(rhs.filename_)), base_(rhs.base_), base_size_(rhs.base_size_), data_(rhs.data_), size_(rhs.size_)
+    {
+        rhs.base_=rhs.data_=nullptr;
+        rhs.base_size_=rhs.size_=0;
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& rhs) noexcept {
+        if (this!=&rhs) {
+            unmap();
+            filename_=std::move(rhs.filename_);
+            base_=rhs.base_;
+            base_size_=rhs.base_size_;
+            data_=rhs.data_;
+            size_=rhs.size_;
+            rhs.base_=rhs.data_=nullptr;
+            rhs.base_size_=rhs.size_=0;
+        }
+        return *this;
+    }
+
+    mapped_file::~mapped_file() {
+        unmap();
+    }
+
+    void mapped_file::unmap() {
+        if (base_) ::munmap(base_, base_size_);
+        base_=data_=nullptr;
+        base_size_=size_=0;
+    }
+}
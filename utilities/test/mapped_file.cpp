@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/utilities/mapped_file.hpp>
+#include <alps/testing/unique_file.hpp>
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(mapped_file, main)
+{
+    alps::testing::unique_file ufile("alps_mapped_file_test.", alps::testing::unique_file::REMOVE_AFTER);
+    std::vector<double> values(10000);
+    for (std::size_t i=0; i<values.size(); ++i) values[i]=0.5*i;
+    {
+        std::ofstream out(ufile.name().c_str(), std::ios::binary);
+        out.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(double));
+    }
+
+    alps::mapped_file whole(ufile.name());
+    ASSERT_EQ(values.size()*sizeof(double), whole.size());
+    const double* data=static_cast<const double*>(whole.data());
+    for (std::size_t i=0; i<values.size(); ++i) ASSERT_EQ(values[i], data[i]);
+
+    // an offset which is not page-aligned
+    const std::size_t first=777, count=3000;
+    alps::mapped_file region(ufile.name(), first*sizeof(double), count*sizeof(double));
+    double* rdata=static_cast<double*>(region.data());
+    for (std::size_t i=0; i<count; ++i) ASSERT_EQ(values[first+i], rdata[i]);
+
+    // changes are private to the mapping
+    rdata[0]=-1.0;
+    alps::mapped_file moved(std::move(region));
+    EXPECT_EQ(nullptr, region.data());
+    EXPECT_EQ(-1.0, static_cast<double*>(moved.data())[0]);
+    EXPECT_EQ(values[first], data[first]);
+
+    EXPECT_EQ(nullptr, alps::mapped_file(ufile.name(), 8, 0).data());
+    EXPECT_THROW(alps::mapped_file(ufile.name(), 8, values.size()*sizeof(double)), std::runtime_error);
+    EXPECT_THROW(alps::mapped_file(ufile.name()+".missing"), std::runtime_error);
+}
@@ -5,7 +5,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <complex>
+#include <stdexcept>
 
 #include "alps/numeric/tensors/tensor_base.hpp"
 
@@ -477,3 +479,150 @@ TEST(TensorTest, Reshape) {
   X.reshape(10,10,10);
   ASSERT_TRUE(X.shape()[0] == 10 && X.shape()[1] == 10 && X.shape()[2] == 10);
 }
+
+TEST(TensorTest, ParallelArithmetics) {
+  const size_t threshold = tensor_parallel_policy::threshold();
+  const unsigned nthreads = tensor_parallel_policy::num_threads();
+  size_t N = 37, M = 11;
+  tensor<std::complex<double>, 2> X({{N, M}});
+  tensor<std::complex<double>, 2> Z({{N, M}});
+  tensor<double, 2> R({{N, M}});
+  for(size_t i = 0; i< N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      X(i, j) = std::complex<double>(std::sin(i + 3.0*j), std::cos(2.0*i - j));
+      Z(i, j) = std::complex<double>(1.0/(1.0 + i*j), -0.5*j);
+      R(i, j) = i - 2.0*j;
+    }
+  }
+
+  // the same operations, serially and in chunks of a few elements
+  tensor<std::complex<double>, 2> serial(X), parallel(X);
+  tensor_parallel_policy::set_num_threads(1);
+  serial += Z; serial *= 2.5; serial -= Z; serial /= std::complex<double>(0.0, 3.0); serial += R; serial *= Z;
+  double serial_max = serial.max_abs(), serial_norm = serial.frobenius_norm();
+
+  tensor_parallel_policy::set_threshold(16);
+  tensor_parallel_policy::set_num_threads(5);
+  parallel += Z; parallel *= 2.5; parallel -= Z; parallel /= std::complex<double>(0.0, 3.0); parallel += R; parallel *= Z;
+  for(size_t i = 0; i< N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      ASSERT_EQ(serial(i, j), parallel(i, j));
+    }
+  }
+  ASSERT_DOUBLE_EQ(serial_max, parallel.max_abs());
+  ASSERT_NEAR(serial_norm, parallel.frobenius_norm(), 1e-12*serial_norm);
+
+  double max_abs = 0.0, norm2 = 0.0;
+  for(size_t i = 0; i< N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      max_abs = std::max(max_abs, std::abs(parallel(i, j)));
+      norm2 += std::norm(parallel(i, j));
+    }
+  }
+  ASSERT_DOUBLE_EQ(max_abs, parallel.max_abs());
+  ASSERT_NEAR(std::sqrt(norm2), parallel.frobenius_norm(), 1e-12*std::sqrt(norm2));
+  ASSERT_DOUBLE_EQ(std::max(N - 1.0, 2.0*(M - 1)), R.max_abs());
+
+  parallel.set_zero();
+  ASSERT_EQ(0.0, parallel.max_abs());
+
+  // the shapes of the operands must match
+  tensor<std::complex<double>, 2> Y({{M, N}}), W({{N, M + 1}});
+  tensor<double, 2> V({{N, 1}});
+  ASSERT_THROW(parallel += Y, std::invalid_argument);
+  ASSERT_THROW(parallel -= Y, std::invalid_argument);
+  ASSERT_THROW(parallel *= Y, std::invalid_argument);
+  ASSERT_THROW(parallel += W, std::invalid_argument);
+  ASSERT_THROW(parallel += V, std::invalid_argument);
+
+  tensor_parallel_policy::set_threshold(threshold);
+  tensor_parallel_policy::set_num_threads(nthreads);
+}
+
+TEST(TensorTest, ParallelChunksException) {
+  const unsigned nthreads = tensor_parallel_policy::num_threads();
+  tensor_parallel_policy::set_num_threads(4);
+  std::vector<int> done(100, 0);
+  // the exception of a worker thread is rethrown after all chunks are done
+  ASSERT_THROW(alps::numerics::detail::parallel_chunks(done.size(), size_t(-1), [&done](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      done[i] = 1;
+    }
+    if (end == done.size()) {
+      throw std::runtime_error("last chunk");
+    }
+  }), std::runtime_error);
+  ASSERT_EQ(done.size(), size_t(std::count(done.begin(), done.end(), 1)));
+  tensor_parallel_policy::set_num_threads(nthreads);
+}
+
+TEST(TensorTest, BatchedMatrixOperations) {
+  const size_t threshold = tensor_parallel_policy::threshold();
+  const unsigned nthreads = tensor_parallel_policy::num_threads();
+  tensor_parallel_policy::set_threshold(16);
+  tensor_parallel_policy::set_num_threads(3);
+  typedef std::complex<double> dcomplex;
+  size_t B1 = 5, B2 = 4;
+  // fixed-size and dynamic matrices
+  for(size_t n : {1, 2, 3, 4, 6}) {
+    size_t m = n + 1;
+    tensor<dcomplex, 4> X({{B1, B2, n, n}});
+    tensor<dcomplex, 4> Y({{B1, B2, n, m}});
+    for(size_t b1 = 0; b1 < B1; ++b1) {
+      for(size_t b2 = 0; b2 < B2; ++b2) {
+        for(size_t i = 0; i < n; ++i) {
+          for (size_t j = 0; j < m; ++j) {
+            if(j < n) {
+              X(b1, b2, i, j) = dcomplex(std::sin(b1 + 2.0*i - j), std::cos(b2 + i*j)) + (i == j ? 4.0 : 0.0);
+            }
+            Y(b1, b2, i, j) = dcomplex(b1 - 0.5*j, b2 + 0.25*i);
+          }
+        }
+      }
+    }
+    tensor<dcomplex, 4> Xinv = X.batched_inverse();
+    tensor<dcomplex, 4> XY = X.batched_dot(Y);
+    ASSERT_EQ(m, XY.shape()[3]);
+    for(size_t b1 = 0; b1 < B1; ++b1) {
+      for(size_t b2 = 0; b2 < B2; ++b2) {
+        Eigen::MatrixXcd Mx(n, n), My(n, m);
+        for(size_t i = 0; i < n; ++i) {
+          for (size_t j = 0; j < m; ++j) {
+            if(j < n) {
+              Mx(i, j) = X(b1, b2, i, j);
+            }
+            My(i, j) = Y(b1, b2, i, j);
+          }
+        }
+        Eigen::MatrixXcd Minv = Mx.inverse(), Mxy = Mx*My;
+        for(size_t i = 0; i < n; ++i) {
+          for (size_t j = 0; j < m; ++j) {
+            if(j < n) {
+              ASSERT_NEAR(0.0, std::abs(Minv(i, j) - Xinv(b1, b2, i, j)), 1e-12);
+            }
+            ASSERT_NEAR(0.0, std::abs(Mxy(i, j) - XY(b1, b2, i, j)), 1e-12);
+          }
+        }
+      }
+    }
+    ASSERT_ANY_THROW(Y.batched_inverse());
+    ASSERT_ANY_THROW(Y.batched_dot(Y));
+  }
+  // a single matrix is the same as inverse() and dot()
+  tensor<double, 2> Z({{3, 3}});
+  for(size_t i = 0; i < 3; ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      Z(i, j) = 1.0/(1.0 + i + j) + (i == j ? 1.0 : 0.0);
+    }
+  }
+  tensor<double, 2> Zinv = Z.inverse(), Zbinv = Z.batched_inverse();
+  tensor<double, 2> ZZ = Z.dot(Zinv), ZZb = Z.batched_dot(Zbinv);
+  for(size_t i = 0; i < 3; ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      ASSERT_NEAR(Zinv(i, j), Zbinv(i, j), 1e-12);
+      ASSERT_NEAR(ZZ(i, j), ZZb(i, j), 1e-12);
+    }
+  }
+  tensor_parallel_policy::set_threshold(threshold);
+  tensor_parallel_policy::set_num_threads(nthreads);
+}